@@ -17,6 +17,24 @@
 
 #include "gh3x2x_drv.h"
 
+/// frames of one function in channel-major arrays, element of channel n, frame i is at [n * usFrameStride + i]
+typedef struct
+{
+    GU32 unFunctionID;          /**< GH3X2X_FUNCTION_XXX, one function */
+    GU16 usSampleRate;          /**< sample rate of function */
+    GU8  uchChnlNum;            /**< channel num of function */
+    GU8  uchGsensorAxisNum;     /**< 3: acc  6: acc and gyro */
+    GU8  *pchChnlMap;           /**< channel map of function, uchChnlNum entries */
+    GU16 usFrameNum;            /**< frame num in batch */
+    GU16 usFrameStride;         /**< entries of every row */
+    GU32 *punRawdata;           /**< uchChnlNum rows */
+    GU32 *punAgcInfo;           /**< uchChnlNum rows */
+    GS16 *psGsensorData;        /**< uchGsensorAxisNum rows */
+    GU32 *punFlag;              /**< GH3X2X_FRAME_FLAG_NUM rows */
+    GU32 *punFrameCnt;          /**< one row, frame cnt of drv lib */
+    GS64 *pllTimeStampUs;       /**< one row, frame time in us with __GH3X2X_HW_TIMESTAMP_EN__, else NULL */
+} STGh3x2xFrameBatch;
+
 
 /**
  * @fn     int Gh3x2xDemoInit(void)
@@ -267,6 +285,63 @@ void Gh3x2xDemoFunctionChannelEnSet(GU32 unFunctionID,  GU32 unChnlEn);
  */
 void Gh3x2xInterruptModeSwitch(GU8 uchIntModeType);
 GU8 Gh3x2xGetInterruptMode(void);
+
+/**
+ * @fn     void Gh3x2xDemoFifoWatermarkOverride(GU16 usWatermark)
+ *
+ * @brief  set fifo watermark that overrides reg config array
+ *
+ * @attention   take effect from next reg config load(init, cfg switch, chip reset recovery)
+ *
+ * @param[in]   usWatermark     fifo watermark in words, 0: use watermark of reg config array
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoFifoWatermarkOverride(GU16 usWatermark);
+
+/**
+ * @fn     void Gh3x2xDemoFifoWmConnIntervalSet(GU16 usConnIntervalMs)
+ *
+ * @brief  set ble connection interval of adaptive fifo watermark
+ *
+ * @attention   take effect after next fifo read, only with __GH3X2X_FIFO_WM_ADAPTIVE_EN__
+ *
+ * @param[in]   usConnIntervalMs    connection interval in ms, 0: not connected
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoFifoWmConnIntervalSet(GU16 usConnIntervalMs);
+
+/**
+ * @fn     void Gh3x2xDemoFifoWmRawStreamSet(GU8 uchRawStream)
+ *
+ * @brief  set whether raw data is streamed out or only algorithm results are consumed
+ *
+ * @attention   take effect after next fifo read, only with __GH3X2X_FIFO_WM_ADAPTIVE_EN__
+ *
+ * @param[in]   uchRawStream    1: raw data is streamed  0: only algorithm results
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoFifoWmRawStreamSet(GU8 uchRawStream);
+
+/**
+ * @fn     GS64 Gh3x2xDemoFrameTimeStampGet(GU32 unFunctionID)
+ *
+ * @brief  get timestamp of last decoded frame of function
+ *
+ * @attention   only with __GH3X2X_HW_TIMESTAMP_EN__. Valid in frame hooks of the same thread; with gsensor
+ *              timestamp sync, io data hook may be called after newer frames are decoded
+ *
+ * @param[in]   unFunctionID    GH3X2X_FUNCTION_XXX, one function
+ * @param[out]  None
+ *
+ * @return  frame time in us, time base of hal_gh3x2x_timestamp_now_us, 0: function is not sampling
+ */
+GS64 Gh3x2xDemoFrameTimeStampGet(GU32 unFunctionID);
 void Gh3x2xSerialSendTimerHandle(void);
 
 #if (__GH3X2X_CASCADE_EN__)
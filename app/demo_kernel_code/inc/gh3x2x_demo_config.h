@@ -25,9 +25,16 @@
 #endif
 #define __GS_SENSITIVITY_CONFIG__           (GSENSOR_SENSITIVITY_512_COUNTS_PER_G)  /**< gsensor sensitivity config */
 #define __GS_GYRO_ENABLE__                  (0)        /*Gyro enable*/
+#define __GS_AXIS_REMAP_EN__                (0)         /**< 1: gsensor axes are remapped by __GS_AXIS_REMAP_X/Y/Z__ when ingested   0: no remap */
+#if __GS_AXIS_REMAP_EN__
+#define __GS_AXIS_REMAP_X__                 (GH3X2X_GS_AXIS_X)                          /**< source of x axis, GH3X2X_GS_AXIS_X/Y/Z, or with GH3X2X_GS_AXIS_NEG to negate */
+#define __GS_AXIS_REMAP_Y__                 (GH3X2X_GS_AXIS_Y)                          /**< source of y axis */
+#define __GS_AXIS_REMAP_Z__                 (GH3X2X_GS_AXIS_Z)                          /**< source of z axis */
+#endif
 #define __GS_NONSYNC_READ_EN__              (0)
-#if __GS_NONSYNC_READ_EN__
 #define __GS_SAMPLE_RATE_HZ__               (25)        /*gsenor sample rate(Hz)*/
+#define __GS_ZEPHYR_SENSOR_EN__             (0)         /**< 1: gsensor data is cached from zephyr sensor api accelerometer of devicetree alias gh3x2x-accel, per-sample fetch, at max frame rate of opened functions(__GS_SAMPLE_RATE_HZ__ with non-sync read)   0: GOODIX_PLANFROM_INT_GS_XXX entities */
+#if __GS_NONSYNC_READ_EN__
 #define __GS_READ_POINT_NUM__               (6)         /* host read gsensor sample num in one time */
 #define __GS_READ_POINT_NUM_JITTER__        (3)         /* host read gsensor sample num jitter */
 #endif
@@ -37,6 +44,10 @@
 
 #define __SUPPORT_HARD_RESET_CONFIG__       (1)         /**< support hard reset config */
 #define __INTERRUPT_PROCESS_MODE__          (__NORMAL_INT_PROCESS_MODE__)  /**< 2:polling+int 1:use polling 0:use interrupt */
+#define __GH3X2X_POLLING_PERIOD_MS__        (40)        /**< (unit : ms) target polling period, rounded to whole frames of slowest opened function(polling/mix mode) */
+#define __GH3X2X_POLLING_MIX_CHECK_MS__     (1000)      /**< (unit : ms) int rate check period of mix mode while int pin is used */
+#define __GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__ (0)   /**< 1: chip reset recovery runs as delayed work steps in int work queue, other threads keep running(int mode only)   0: recovery blocks int process */
+#define __GH3X2X_SOFT_EVENT_DISPATCH_EN__   (0)         /**< 1: soft events left after int process are handled once each by their own handler in dispatch work of int work queue, irq status is not read again(int mode only)   0: int process repeats until no soft event */
 #define __PLATFORM_WITHOUT_OS__             (0)         /**< 1:not use os  0:use os */
 #define __PASS_THROUGH_MODE__               (0)
 #define __GH3X2X_MP_MODE__                  (0)         /**< 1:enable mp mode  0:unable mp mode */
@@ -44,6 +55,7 @@
 #if (__GH3X2X_CASCADE_EN__ && __GH3X2X_INTERFACE_I2C__)
 #define __GH3X2X_I2C_DEVICE_SLAVER_ID__     (GH3X2X_I2C_ID_SEL_1H0L)
 #endif
+#define __GH3X2X_CASCADE_CONCURRENT_READ_EN__   (0)     /** 1: slaver chip is on its own i2c bus(devicetree node gh3x2x_slaver), fifo count and fifo data of both chips are read at the same time   0: both chips on one bus **/
 #define __GH3X2X_ECG_RTYPE_5M__             (0)
 #define __RESET_AGCINFO_BEFORE_SAMPLE__     (0)
 #define __CURRENT_ECODE_CALIBRATE__         (0)
@@ -130,6 +142,17 @@
 #define   EXAMPLE_LOG_MAX_LEN                           (128)
 #define __SUPPORT_ENGINEERING_MODE__                    (1)         /**< enginerring mode*/
 #define __GH3X2X_MEM_POOL_CHECK_EN__                    (0)         /** 1: drv lib checks algo mem pool befor every time of algo calculating   0: do not check  **/
+#define __GH3X2X_SPI_BENCHMARK_EN__                     (0)         /** 1: build Gh3x2xSpiFifoReadBenchmark for fifo read throughput and stack check, run by shell cmd gh3x2x_bench spi(hardware cs spi only)   0: not build **/
+#define __GH3X2X_FIFO_DECODE_BENCHMARK_EN__             (0)         /** 1: build Gh3x2xFifoDecodeBenchmark for fifo word decode cycles/word and kernel vs c reference check, run by shell cmd gh3x2x_bench decode   0: not build **/
+#define __GH3X2X_GS_INGEST_BENCHMARK_EN__               (0)         /** 1: build Gh3x2xGsensorIngestBenchmark for gsensor ingest cycles of 300 point block and kernel vs c reference check, run by shell cmd gh3x2x_bench ingest   0: not build **/
+#define __GH3X2X_MOVE_DETECT_BENCHMARK_EN__             (0)         /** 1: build Gh3x2xGsMoveDetectBenchmark for soft adt move detect cycles of 25/50/100Hz blocks and kernel vs c reference check, run by shell cmd gh3x2x_bench move   0: not build **/
+#define __GH3X2X_REG_SHADOW_EN__                        (1)         /** 1: spi hal keeps write-through shadow of config regs and serves reg read from ram(hardware cs spi only, not for cascade)   0: disable **/
+#define __GH3X2X_REG_BURST_WRITE_EN__                   (1)         /** 1: reg writes of contiguous addr are sent as one burst write when loading reg config(hardware cs spi only, not for cascade)   0: disable **/
+#define __GH3X2X_INT_FIFO_PREFETCH_EN__                 (0)         /** 1: fifo is read by prefetch thread right after int edge, int process gets it from ram(hardware cs spi, int mode only)   0: fifo is read in int process **/
+#define __GH3X2X_INT_LATENCY_MEASURE_EN__               (0)         /** 1: int edge is captured by GPIOTE->PPI->TIMER1, log int edge to fifo data latency and jitter(keeps HFCLK on)   0: disable **/
+#define __GH3X2X_HW_TIMESTAMP_EN__                      (0)         /** 1: every fifo block is anchored to int edge captured by GPIOTE->PPI->TIMER1(read time in polling), frames of every function get us timestamp interpolated from it(keeps HFCLK on)   0: timestamps are 0 **/
+#define __GH3X2X_BUS_STAT_EN__                          (0)         /** 1: hal records bus transfer count, bytes and time per reg addr range and int process phase, dumped at sampling stop or by shell cmd gh3x2x_bus   0: disable **/
+#define __GH3X2X_STAGE_PROF_EN__                        (0)         /** 1: cpu cycles of every int process stage are profiled(min/avg/max and log2 histogram), dumped at sampling stop or by shell cmd gh3x2x_prof   0: disable, profiling points compile to nothing **/
 
 /* operate config */
 #define __SUPPORT_FUNCTION_SAMPLE_RATE_MODIFY__         (0)         /** 0: only use default sample rate in array cfg  1: modifying function sample rate is supported via API: Gh3x2xDemoFunctionSampleRateSet */
@@ -144,6 +167,20 @@
 /* gh3x2x data buffer size config,this is related to gh3x2x fifo water mark config */
 #define __GH3X2X_RAWDATA_BUFFER_SIZE__                  (200 * 4)     /**< rawdata buffer size in byte */
 #define __GH3X2X_RAWDATA_SLAVE_BUFFER_SIZE__            (200 * 4)     /**< rawdata buffer size in byte for slave chip*/
+#define __GH3X2X_RAWDATA_BUFFER_NUM__                   (2)           /**< num of rawdata buffer in ring(>= 1), fifo prefetch reads next block into idle buffer while current block is processed and needs no buffer of its own, int pipeline queues blocks in it, 1 without both */
+#define __GH3X2X_INT_PIPELINE_EN__                      (0)           /**< 1: int process only acquires fifo blocks into free buffer of rawdata ring and queues them, processing thread runs gsensor fetch and algorithm per block under drv lib lock, ring keeps (__GH3X2X_RAWDATA_BUFFER_NUM__ - 1) blocks   0: algorithm runs in int process */
+#define __GH3X2X_FIFO_DEMUX_EN__                        (0)           /**< 1: fifo words are routed to opened functions by slot/adc tag in one pass, drv lib parses only words of its function   0: drv lib parses whole fifo block once per function */
+#define __GH3X2X_FIFO_DEMUX_BUFFER_SIZE__               (__GH3X2X_RAWDATA_BUFFER_SIZE__ * 2)    /**< demux buffer size in byte, a word of n functions is stored n times, bigger block is parsed whole */
+#define __GH3X2X_ROUTE_TABLE_EN__                       (0)           /**< 1: fifo demux routing is taken from tables generated from reg config arrays at build time(tools/gh3x2x_route_table_gen.py, cmake runs it only when this and __GH3X2X_FIFO_DEMUX_EN__ are 1 here), config switch swaps table pointer   0: routing is built from channel map of drv lib */
+#define __GH3X2X_FRAME_BATCH_EN__                       (0)           /**< 1: frames are collected per function in channel-major arrays and delivered only by gh3x2x_frame_batch_hook_func, at least once per fifo block, instead of per frame stream callback(algorithm still runs per frame)   0: per frame stream callback */
+#define __GH3X2X_FRAME_BATCH_MAX_NUM__                  (32)          /**< max frames of one batch, a full batch is delivered at once */
+#define __GH3X2X_FIFO_DECODE_EN__                       (0)           /**< 1: every fifo block of rawdata hook is decoded by Gh3x2xFifoDecode and delivered as slot/adc/flag/adc code arrays by gh3x2x_fifo_decode_hook_func, decode cycles/word of these blocks are logged at sampling stop   0: rawdata hook gets fifo bytes only */
+
+/* fifo watermark config */
+#define __GH3X2X_FIFO_WM_ADAPTIVE_EN__                  (0)           /**< 1: fifo watermark is computed at runtime from latency budget of opened functions, ble connection interval and raw data streaming   0: use watermark of reg config array */
+#define __GH3X2X_FIFO_WM_ECG_LIVE_LATENCY_MS__          (40)          /**< (unit : ms) max fifo latency when ecg raw data is streamed live */
+#define __GH3X2X_FIFO_WM_RAW_LATENCY_MS__               (200)         /**< (unit : ms) max fifo latency when raw data is streamed and ble connection interval is unknown */
+#define __GH3X2X_FIFO_WM_RESULT_LATENCY_MS__            (1000)        /**< (unit : ms) max fifo latency when only algorithm results are consumed */
 
 /* gsensor data buffer size config,every g sensor data has 6 bytes(x,y,z) */
 #define __GSENSOR_DATA_BUFFER_SIZE__                    (300)       /**< max num of gsensor data */
@@ -243,6 +280,85 @@
 #if(__GH3X2X_INTERFACE__ != __GH3X2X_INTERFACE_I2C__)
 #define __GH3X2X_I2C_DEVICE_ID__            (GH3X2X_I2C_ID_SEL_1L0L)
 #endif
+#if (__GH3X2X_INTERFACE__ != __GH3X2X_INTERFACE_SPI__) || (__GH3X2X_SPI_TYPE__ != __GH3X2X_SPI_TYPE_HARDWARE_CS__) || (__GH3X2X_CASCADE_EN__)
+#undef __GH3X2X_REG_SHADOW_EN__
+#define __GH3X2X_REG_SHADOW_EN__            (0)
+#undef __GH3X2X_REG_BURST_WRITE_EN__
+#define __GH3X2X_REG_BURST_WRITE_EN__       (0)
+#endif
+
+#if (__GH3X2X_INTERFACE__ != __GH3X2X_INTERFACE_SPI__) || (__GH3X2X_SPI_TYPE__ != __GH3X2X_SPI_TYPE_HARDWARE_CS__)
+#undef __GH3X2X_SPI_BENCHMARK_EN__
+#define __GH3X2X_SPI_BENCHMARK_EN__         (0)
+#endif
+
+#if (__GH3X2X_INTERFACE__ != __GH3X2X_INTERFACE_SPI__) || (__GH3X2X_SPI_TYPE__ != __GH3X2X_SPI_TYPE_HARDWARE_CS__) || (__GH3X2X_CASCADE_EN__) || \
+    (__INTERRUPT_PROCESS_MODE__ != __NORMAL_INT_PROCESS_MODE__)
+#undef __GH3X2X_INT_FIFO_PREFETCH_EN__
+#define __GH3X2X_INT_FIFO_PREFETCH_EN__     (0)
+#endif
+
+#if !(__GH3X2X_INT_FIFO_PREFETCH_EN__) && !(__GH3X2X_INT_PIPELINE_EN__)
+#undef __GH3X2X_RAWDATA_BUFFER_NUM__
+#define __GH3X2X_RAWDATA_BUFFER_NUM__       (1)
+#endif
+
+#if (__GH3X2X_INTERFACE__ != __GH3X2X_INTERFACE_I2C__) || !(__GH3X2X_CASCADE_EN__)
+#undef __GH3X2X_CASCADE_CONCURRENT_READ_EN__
+#define __GH3X2X_CASCADE_CONCURRENT_READ_EN__   (0)
+#endif
+
+#if (__GH3X2X_RAWDATA_BUFFER_NUM__ < 2)
+#undef __GH3X2X_INT_PIPELINE_EN__
+#define __GH3X2X_INT_PIPELINE_EN__          (0)
+#endif
+
+#if (__GH3X2X_CASCADE_EN__)
+#undef __GH3X2X_FIFO_DEMUX_EN__
+#define __GH3X2X_FIFO_DEMUX_EN__            (0)
+#endif
+
+#if !(__GH3X2X_FIFO_DEMUX_EN__)
+#undef __GH3X2X_ROUTE_TABLE_EN__
+#define __GH3X2X_ROUTE_TABLE_EN__           (0)
+#endif
+
+#if (__INTERRUPT_PROCESS_MODE__ == __POLLING_INT_PROCESS_MODE__)
+#undef __GH3X2X_INT_LATENCY_MEASURE_EN__
+#define __GH3X2X_INT_LATENCY_MEASURE_EN__   (0)
+#undef __GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__
+#define __GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__ (0)
+#undef __GH3X2X_SOFT_EVENT_DISPATCH_EN__
+#define __GH3X2X_SOFT_EVENT_DISPATCH_EN__   (0)
+#endif
+
+/* int edge capture to TIMER1 is shared by latency measure and hw timestamp, no int edge in polling mode */
+#if (__GH3X2X_INT_LATENCY_MEASURE_EN__) || ((__GH3X2X_HW_TIMESTAMP_EN__) && (__INTERRUPT_PROCESS_MODE__ != __POLLING_INT_PROCESS_MODE__))
+#define __GH3X2X_INT_EDGE_CAPTURE_EN__      (1)
+#else
+#define __GH3X2X_INT_EDGE_CAPTURE_EN__      (0)
+#endif
+
+/* benchmarks share harness and shell cmd gh3x2x_bench of gh3x2x_demo_benchmark.c */
+#if (__GH3X2X_SPI_BENCHMARK_EN__) || (__GH3X2X_FIFO_DECODE_BENCHMARK_EN__) || (__GH3X2X_GS_INGEST_BENCHMARK_EN__) \
+    || ((__GH3X2X_MOVE_DETECT_BENCHMARK_EN__) && (__SUPPORT_HARD_ADT_CONFIG__))
+#define __GH3X2X_BENCHMARK_EN__             (1)
+#else
+#define __GH3X2X_BENCHMARK_EN__             (0)
+#endif
+
+/* rawdata hook is only called with hook func support */
+#if (0 == __SUPPORT_HOOK_FUNC_CONFIG__)
+#undef __GH3X2X_FIFO_DECODE_EN__
+#define __GH3X2X_FIFO_DECODE_EN__           (0)
+#endif
+
+/* cpu cycle counter is shared by bus statistics, stage profiler, fifo decode and benchmarks */
+#if (__GH3X2X_BUS_STAT_EN__) || (__GH3X2X_STAGE_PROF_EN__) || (__GH3X2X_FIFO_DECODE_EN__) || (__GH3X2X_BENCHMARK_EN__)
+#define __GH3X2X_CYCLE_CNT_EN__             (1)
+#else
+#define __GH3X2X_CYCLE_CNT_EN__             (0)
+#endif
 
 #ifdef GH3X2X_MAIN_FUNC_CHNL_NUM
 #undef GH3X2X_MAIN_FUNC_CHNL_NUM
@@ -298,6 +414,19 @@
 #endif
 
 
+#if !(__GS_AXIS_REMAP_EN__)
+#define __GS_AXIS_REMAP_X__     (GH3X2X_GS_AXIS_X)
+#define __GS_AXIS_REMAP_Y__     (GH3X2X_GS_AXIS_Y)
+#define __GS_AXIS_REMAP_Z__     (GH3X2X_GS_AXIS_Z)
+#endif
+
+/* 1: hal_gsensor_drv_get_fifo_data copies by Gh3x2xGsensorIngest, data is normalized   0: normalized after copy */
+#if (__GS_ZEPHYR_SENSOR_EN__)
+#define __GS_INGEST_BY_HAL__    (1)
+#else
+#define __GS_INGEST_BY_HAL__    (0)
+#endif
+
 #define __GS_EXTRA_BUF_LEN__    (0)
 #if __GS_NONSYNC_READ_EN__
 #undef __GS_EXTRA_BUF_LEN__
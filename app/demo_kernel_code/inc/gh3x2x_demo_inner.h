@@ -12,6 +12,7 @@
 #ifndef _GH3X2X_DEMO_INNER_H_
 #define _GH3X2X_DEMO_INNER_H_
 #include "gh3x2x_demo_config.h"
+#include "gh3x2x_demo.h"
 
 
 #ifdef GOODIX_DEMO_PLANFORM
@@ -95,6 +96,13 @@ typedef struct
 #endif
 }STGsensorRawdata;
 
+/* gsensor axis of __GS_AXIS_REMAP_X/Y/Z__ */
+#define GH3X2X_GS_AXIS_X                    (0x00)
+#define GH3X2X_GS_AXIS_Y                    (0x01)
+#define GH3X2X_GS_AXIS_Z                    (0x02)
+#define GH3X2X_GS_AXIS_MASK                 (0x03)
+#define GH3X2X_GS_AXIS_NEG                  (0x04)      /**< or with axis: negated axis */
+
 #if __GH3X2X_MEM_POOL_CHECK_EN__
 extern GU8  g_uchGh3x2xMemPollHaveGetCheckSum;
 #endif
@@ -268,6 +276,174 @@ extern void hal_gh3x2x_reset_pin_ctrl(GU8 pin_level);
  */
 extern void hal_gh3x2x_int_init(void);
 
+#if (__POLLING_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+/**
+ * @fn     void hal_gh3x2x_polling_timer_start(GU32 unPeriodUs)
+ * 
+ * @brief  (re)start polling timer, polling work calls Gh3x2xDemoPollingProcess at every expiry
+ *
+ * @attention   timer is one-shot with absolute expiry, restarted by polling work, so it needs no periodic tick
+ *
+ * @param[in]   unPeriodUs      delay of first expiry in us
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void hal_gh3x2x_polling_timer_start(GU32 unPeriodUs);
+
+/**
+ * @fn     void hal_gh3x2x_polling_timer_stop(void)
+ * 
+ * @brief  stop polling timer
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void hal_gh3x2x_polling_timer_stop(void);
+
+/**
+ * @fn     GU32 Gh3x2xDemoPollingProcess(GU32 unElapsedUs)
+ * 
+ * @brief  process of polling timer expiry: polling pass of int process, or int rate check in mix mode
+ *
+ * @attention   only called by polling work
+ *
+ * @param[in]   unElapsedUs     time since last call
+ * @param[out]  None
+ *
+ * @return  delay in us to next call, 0: stop polling
+ */
+extern GU32 Gh3x2xDemoPollingProcess(GU32 unElapsedUs);
+#endif
+
+#if (__GH3X2X_INT_PIPELINE_EN__)
+/**
+ * @fn     void hal_gh3x2x_pipeline_notify(void)
+ * 
+ * @brief  wake processing thread, it calls Gh3x2xDemoPipelineProcess
+ *
+ * @attention   called by int process after a fifo block is queued
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void hal_gh3x2x_pipeline_notify(void);
+#endif
+
+/**
+ * @fn     void hal_gh3x2x_drv_lock(void)
+ * 
+ * @brief  lock drv lib and demo state, recursive
+ *
+ * @attention   int work queue and app threads(protocol, sensor api) both call drv lib, every demo entry of
+ *              sampling control and int process takes it
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void hal_gh3x2x_drv_lock(void);
+
+/**
+ * @fn     void hal_gh3x2x_drv_unlock(void)
+ * 
+ * @brief  unlock drv lib and demo state
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void hal_gh3x2x_drv_unlock(void);
+
+#define GH3X2X_DRV_LOCK()                   hal_gh3x2x_drv_lock()
+#define GH3X2X_DRV_UNLOCK()                 hal_gh3x2x_drv_unlock()
+
+#if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+/**
+ * @fn     void hal_gh3x2x_chip_reset_recovery_start(void)
+ * 
+ * @brief  submit chip reset recovery work, it calls Gh3x2xDemoChipResetRecoveryStep until recovery is done
+ *
+ * @attention   work runs in int work queue, so it never runs at the same time as int process
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void hal_gh3x2x_chip_reset_recovery_start(void);
+#endif
+
+#if (__GH3X2X_SOFT_EVENT_DISPATCH_EN__)
+/**
+ * @fn     void hal_gh3x2x_soft_event_post(void)
+ * 
+ * @brief  submit soft event dispatch work, posts before it runs are handled by one dispatch
+ *
+ * @attention   work runs in int work queue, so soft events are never taken in caller thread
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void hal_gh3x2x_soft_event_post(void);
+#endif
+
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+/**
+ * @fn     GS64 hal_gh3x2x_timestamp_now_us(void)
+ * 
+ * @brief  get time base of gh3x2x timestamps
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  system uptime in us
+ */
+extern GS64 hal_gh3x2x_timestamp_now_us(void);
+
+/**
+ * @fn     GU8 hal_gh3x2x_timestamp_int_edge_get(GS64 *pllEdgeUs)
+ * 
+ * @brief  get time of last int edge captured by hardware, isr does nothing for it
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  pllEdgeUs       int edge time in time base of hal_gh3x2x_timestamp_now_us
+ *
+ * @return  1: new edge since last call  0: no new edge or no edge capture(polling mode)
+ */
+extern GU8 hal_gh3x2x_timestamp_int_edge_get(GS64 *pllEdgeUs);
+
+/**
+ * @fn     void Gh3x2xDemoFrameTimeStampNext(const STGh3x2xFrameInfo * const pstFrameInfo)
+ * 
+ * @brief  give timestamp to one decoded frame, read back by Gh3x2xDemoFrameTimeStampGet
+ *
+ * @attention   called once for every frame by frame data hook
+ *
+ * @param[in]   pstFrameInfo    decoded frame
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xDemoFrameTimeStampNext(const STGh3x2xFrameInfo * const pstFrameInfo);
+#endif
+
 /**
  * @fn     void hal_gsensor_start_cache_data(void)
  * 
@@ -295,6 +471,23 @@ extern void hal_gsensor_start_cache_data(void);
  * @return  None
  */
 extern void hal_gsensor_stop_cache_data(void);
+
+#if (__GS_ZEPHYR_SENSOR_EN__)
+/**
+ * @fn     void hal_gsensor_rate_update(GU16 usRateHz)
+ * 
+ * @brief  set sample rate of gsensor, applied at once when it is sampling
+ *
+ * @attention   This function will be called before start and after opened functions change.
+ *
+ * @param[in]   usRateHz        sample rate(Hz)
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void hal_gsensor_rate_update(GU16 usRateHz);
+#endif
+
 extern void hal_cap_start_cache_data(void);
 extern void hal_cap_stop_cache_data(void);
 extern void hal_temp_start_cache_data(void);
@@ -446,54 +639,799 @@ extern void Gh3x2x_WearEventCascadeEcgHandle(GU16 usGotEvent);
  */
 void Gh3x2x_UserHandleCurrentInfo(void);
 
+#if (__GH3X2X_INT_PIPELINE_EN__)
+/// statistics of int process -> processing thread fifo block ring
+typedef struct
+{
+    GU32 unPushCnt;         /**< blocks queued by int process */
+    GU32 unPopCnt;          /**< blocks processed by processing thread */
+    GU32 unOverrunCnt;      /**< blocks dropped because ring is full */
+    GU32 unStaleCnt;        /**< blocks dropped because sampling stopped after they were queued */
+    GU16 usDepth;           /**< blocks in ring now */
+    GU16 usMaxDepth;        /**< max blocks in ring */
+} STGh3x2xPipelineStat;
+
 /**
- * @fn     void Gh3x2xDemoAlgorithmCalculate(GU8* puchReadFifoBuffer, STGsensorRawdata *pstGsAxisValueArr, 
- *                                              GU16 usGsDataNum, EMGsensorSensitivity emGsSensitivity)
+ * @fn     void Gh3x2xDemoPipelineProcess(void)
+ * 
+ * @brief  process all fifo blocks queued by int process: gsensor/cap/temp fetch and algorithm
  *
- * @brief  Algorithm calculate.This function will be called in Gh3x2xDemoInterruptProcess()
+ * @attention   only called by processing thread, it is the single consumer of ring
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xDemoPipelineProcess(void);
+
+/**
+ * @fn     void Gh3x2xDemoPipelineGetStat(STGh3x2xPipelineStat *pstStat)
+ * 
+ * @brief  get statistics of fifo block ring
  *
  * @attention   None
  *
- * @param[in]   puchReadFifoBuffer      point to gh3x2x fifo data buffer
- * @param[in]   pstGsAxisValueArr       point to gsensor data buffer
- * @param[in]   usGsDataNum             gsensor data cnt
- * @param[in]   emGsSensitivity         sensitivity of gsensor
+ * @param[in]   None
+ * @param[out]  pstStat     pointer to statistics
+ *
+ * @return  None
+ */
+extern void Gh3x2xDemoPipelineGetStat(STGh3x2xPipelineStat *pstStat);
+#endif
+
+#if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+/**
+ * @fn     GS32 Gh3x2xDemoChipResetRecoveryStep(void)
+ * 
+ * @brief  run one step of chip reset recovery: reset, reg config reload(with retry), restore sampling
+ *
+ * @attention   only called by chip reset recovery work
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  delay in ms before next step, < 0: recovery is done
+ */
+extern GS32 Gh3x2xDemoChipResetRecoveryStep(void);
+#endif
+
+#if (__GH3X2X_SOFT_EVENT_DISPATCH_EN__)
+/**
+ * @fn     void Gh3x2xDemoSoftEventDispatch(void)
+ * 
+ * @brief  dispatch soft events of drv lib, each event bit is cleared and handled once by its own handler
+ *
+ * @attention   only called by soft event dispatch work with drv lib lock held, irq status is not read
+ *
+ * @param[in]   None
  * @param[out]  None
  *
  * @return  None
  */
+extern void Gh3x2xDemoSoftEventDispatch(void);
+#endif
 
-void Gh3x2xDemoFunctionProcess(GU8* puchReadFifoBuffer, GU16 usFifoBuffLen,STGsensorRawdata *pstGsAxisValueArr, GU16 usGsDataNum,
-                                   STCapRawdata* pstCapValueArr,GU16 usCapDataNum,STTempRawdata* pstTempValueArr,GU16 usTempDataNum);
+#if (__GH3X2X_RAWDATA_BUFFER_NUM__ > 1)
+/**
+ * @fn     GU8 *Gh3x2xDemoGetIdleRawdataBuffer(void)
+ * 
+ * @brief  get ring buffer that next fifo read goes into
+ *
+ * @attention   size is __GH3X2X_RAWDATA_BUFFER_SIZE__, no drv lib lock needed
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  pointer to idle buffer, NULL if buffer is not allocated yet
+ */
+extern GU8 *Gh3x2xDemoGetIdleRawdataBuffer(void);
+#endif
+
+#if (__GH3X2X_REG_SHADOW_EN__)
+/// statistics of reg shadow
+typedef struct
+{
+    GU32 unHitCnt;          /**< reg read served by shadow */
+    GU32 unMissCnt;         /**< cacheable reg read that goes to chip */
+    GU32 unBypassCnt;       /**< volatile reg read */
+    GU32 unInvalidateCnt;   /**< times of shadow invalidated */
+} STGh3x2xRegShadowStat;
 
 /**
- * @fn     void Gh3x2xDemoSamplingControl(EMUprotocolParseCmdType emSwitch)
+ * @fn     void Gh3x2xRegShadowInvalidate(void)
+ * 
+ * @brief  drop all shadow value, next read of every reg goes to chip
  *
- * @brief  Start/stop sampling of gh3x2x and sensor
+ * @attention   call it when chip regs are reset
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xRegShadowInvalidate(void);
+
+/**
+ * @fn     void Gh3x2xRegShadowGetStat(STGh3x2xRegShadowStat *pstStat)
+ * 
+ * @brief  get statistics of reg shadow
  *
  * @attention   None
  *
- * @param[in]   unFuncMode      function that will be started or stopped
- * @param[in]   emSwitch        stop/start sampling
+ * @param[in]   None
+ * @param[out]  pstStat     pointer to statistics
+ *
+ * @return  None
+ */
+extern void Gh3x2xRegShadowGetStat(STGh3x2xRegShadowStat *pstStat);
+
+/**
+ * @fn     void Gh3x2xRegShadowStatLog(const GCHAR *pchTag, const STGh3x2xRegShadowStat *pstStartStat)
+ * 
+ * @brief  log statistics of reg shadow since pstStartStat
+ *
+ * @attention   None
+ *
+ * @param[in]   pchTag          log tag
+ * @param[in]   pstStartStat    statistics got before operation
  * @param[out]  None
  *
  * @return  None
  */
-extern void Gh3x2xDemoSamplingControl(GU32 unFuncMode, EMUprotocolParseCmdType emSwitch);
+extern void Gh3x2xRegShadowStatLog(const GCHAR *pchTag, const STGh3x2xRegShadowStat *pstStartStat);
+#endif
 
-/// dump mode
-extern GU16 g_usDumpMode;
-extern GU8 g_uchGh3x2xRegCfgArrIndex;
-extern GU16 g_usCurrentConfigListFifoWmBak;
-extern void GH3X2X_LedAgcProcessExDump(GU8* puchReadFifoBuffer);
-extern void GH3X2X_ReadElectrodeWearDumpData(void);
-extern void GH3X2X_RecordDumpData(void);
-extern void gh3x2x_init_hook_func(void);
-extern void gh3x2x_sampling_start_hook_func(void);
-extern void gh3x2x_sampling_stop_hook_func(void);
-extern void gh3x2x_get_rawdata_hook_func(GU8 *read_buffer_ptr, GU16 length);
-extern void gh3x2x_algorithm_get_io_data_hook_func(const STGh3x2xFrameInfo * const pstFrameInfo);
-extern void gh3x2x_frame_data_hook_func(const STGh3x2xFrameInfo * const pstFrameInfo);
+#if (__GH3X2X_REG_BURST_WRITE_EN__)
+/**
+ * @fn     void Gh3x2xRegBurstWriteStart(void)
+ * 
+ * @brief  start coalescing contiguous reg writes into burst writes
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xRegBurstWriteStart(void);
+
+/**
+ * @fn     void Gh3x2xRegBurstWriteStop(const GCHAR *pchTag)
+ * 
+ * @brief  send held regs, stop coalescing and log reg num, frame num and time used
+ *
+ * @attention   None
+ *
+ * @param[in]   pchTag      log tag
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xRegBurstWriteStop(const GCHAR *pchTag);
+#endif
+
+#if (__GH3X2X_SPI_BENCHMARK_EN__)
+/**
+ * @fn     void Gh3x2xSpiFifoReadBenchmark(void)
+ * 
+ * @brief  benchmark of F1 fifo read, log cycles/byte and stack high-water
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xSpiFifoReadBenchmark(void);
+#endif
+
+#if (__GH3X2X_BENCHMARK_EN__)
+/**
+ * @fn     GU32 Gh3x2xBenchmarkRun(const GCHAR *pchName, void (*pCaseFunc)(void *pvArg), void *pvArg,
+ *                                 GU16 usLoopNum, GU32 unUnitNum, const GCHAR *pchUnit)
+ * 
+ * @brief  run one benchmark case usLoopNum times, log cycles per loop and per unit and stack high-water
+ *
+ * @attention   None
+ *
+ * @param[in]   pchName         case name
+ * @param[in]   pCaseFunc       case function, called usLoopNum times
+ * @param[in]   pvArg           arg of case function
+ * @param[in]   usLoopNum       run times
+ * @param[in]   unUnitNum       units(word, point, byte...) handled in one run
+ * @param[in]   pchUnit         unit name
+ * @param[out]  None
+ *
+ * @return  cycles per loop
+ */
+extern GU32 Gh3x2xBenchmarkRun(const GCHAR *pchName, void (*pCaseFunc)(void *pvArg), void *pvArg,
+                               GU16 usLoopNum, GU32 unUnitNum, const GCHAR *pchUnit);
+
+/**
+ * @fn     void Gh3x2xBenchmarkFill(void *pvData, GU32 unByteNum)
+ * 
+ * @brief  fill benchmark input with xorshift32 sequence, same data every call
+ *
+ * @attention   None
+ *
+ * @param[in]   unByteNum       byte num
+ * @param[out]  pvData          data to fill
+ *
+ * @return  None
+ */
+extern void Gh3x2xBenchmarkFill(void *pvData, GU32 unByteNum);
+
+/**
+ * @fn     GU8 Gh3x2xBenchmarkCheck(const GCHAR *pchName, const void *pvRef, const void *pvKernel, GU32 unByteNum)
+ * 
+ * @brief  log whether kernel output is bit-for-bit same as c reference
+ *
+ * @attention   None
+ *
+ * @param[in]   pchName         benchmark name
+ * @param[in]   pvRef           output of c reference
+ * @param[in]   pvKernel        output of kernel
+ * @param[in]   unByteNum       byte num of output
+ * @param[out]  None
+ *
+ * @return  1: match  0: not match
+ */
+extern GU8 Gh3x2xBenchmarkCheck(const GCHAR *pchName, const void *pvRef, const void *pvKernel, GU32 unByteNum);
+#endif
+
+#if (__GH3X2X_BUS_STAT_EN__)
+/// caller phase of bus transfer
+typedef enum
+{
+    GH3X2X_BUS_PHASE_OTHER = 0,     /**< out of int process: sampling control, protocol and etc. */
+    GH3X2X_BUS_PHASE_IRQ_STATUS,    /**< irq status read and clear */
+    GH3X2X_BUS_PHASE_WEAR,          /**< wear/adt event process */
+    GH3X2X_BUS_PHASE_FIFO_CNT,      /**< fifo count read */
+    GH3X2X_BUS_PHASE_FIFO_READ,     /**< fifo data read */
+    GH3X2X_BUS_PHASE_PROCESS,       /**< ecg calibration, dump, event report and etc. */
+    GH3X2X_BUS_PHASE_AGC,           /**< soft agc */
+    GH3X2X_BUS_PHASE_CHIP_RESET,    /**< chip reset recovery */
+    GH3X2X_BUS_PHASE_LOW_POWER,     /**< enter low power cmd */
+    GH3X2X_BUS_PHASE_CFG_LOAD,      /**< reg config array load */
+    GH3X2X_BUS_PHASE_PREFETCH,      /**< fifo prefetch thread */
+    GH3X2X_BUS_PHASE_NUM,
+} EMGh3x2xBusPhase;
+
+#define GH3X2X_BUS_STAT_PHASE(emPhase)      Gh3x2xBusStatPhaseSet(emPhase)
+
+/**
+ * @fn     EMGh3x2xBusPhase Gh3x2xBusStatPhaseSet(EMGh3x2xBusPhase emPhase)
+ * 
+ * @brief  set phase that following bus transfers are counted to
+ *
+ * @attention   None
+ *
+ * @param[in]   emPhase     new phase
+ * @param[out]  None
+ *
+ * @return  phase before
+ */
+extern EMGh3x2xBusPhase Gh3x2xBusStatPhaseSet(EMGh3x2xBusPhase emPhase);
+
+/**
+ * @fn     EMGh3x2xBusPhase Gh3x2xBusStatPhaseGet(void)
+ * 
+ * @brief  get phase that bus transfers are counted to
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  current phase
+ */
+extern EMGh3x2xBusPhase Gh3x2xBusStatPhaseGet(void);
+
+/**
+ * @fn     void Gh3x2xBusStatRecord(EMGh3x2xBusPhase emPhase, GU16 usRegAddr, GU8 uchIsCmd, GU16 usByteNum, GU32 unCycle)
+ * 
+ * @brief  count one bus transfer, called by hal
+ *
+ * @attention   None
+ *
+ * @param[in]   emPhase     phase of transfer
+ * @param[in]   usRegAddr   reg addr of transfer, or cmd if uchIsCmd
+ * @param[in]   uchIsCmd    1: transfer is cmd without reg addr
+ * @param[in]   usByteNum   bytes on bus
+ * @param[in]   unCycle     cpu cycles from start to end of transfer
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xBusStatRecord(EMGh3x2xBusPhase emPhase, GU16 usRegAddr, GU8 uchIsCmd, GU16 usByteNum, GU32 unCycle);
+
+/**
+ * @fn     void Gh3x2xBusStatDump(void)
+ * 
+ * @brief  log bus statistics per phase, per reg addr range and hottest regs
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xBusStatDump(void);
+
+/**
+ * @fn     void Gh3x2xBusStatReset(void)
+ * 
+ * @brief  clear bus statistics
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xBusStatReset(void);
+
+#else
+#define GH3X2X_BUS_STAT_PHASE(emPhase)
+#endif
+
+#if (__GH3X2X_CYCLE_CNT_EN__)
+/**
+ * @fn     GU32 Gh3x2xCycleCntGet(void)
+ * 
+ * @brief  get cpu cycle counter(DWT CYCCNT)
+ *
+ * @attention   Gh3x2xCycleCntInit must be called before
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  cpu cycle counter
+ */
+extern GU32 Gh3x2xCycleCntGet(void);
+
+/**
+ * @fn     void Gh3x2xCycleCntInit(void)
+ * 
+ * @brief  enable cpu cycle counter(DWT CYCCNT)
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xCycleCntInit(void);
+
+/**
+ * @fn     GU32 Gh3x2xCycleToUs(GU32 unCycle)
+ * 
+ * @brief  convert cpu cycles to us
+ *
+ * @attention   None
+ *
+ * @param[in]   unCycle     cpu cycles
+ * @param[out]  None
+ *
+ * @return  us
+ */
+extern GU32 Gh3x2xCycleToUs(GU32 unCycle);
+#endif
+
+#if (__GH3X2X_STAGE_PROF_EN__)
+/// profiled stage of int process
+typedef enum
+{
+    GH3X2X_STAGE_INT_PASS = 0,      /**< one pass of int process, stages below are inside it */
+    GH3X2X_STAGE_IRQ_READ,          /**< irq status read */
+    GH3X2X_STAGE_FIFO_READ,         /**< fifo count and fifo data read */
+    GH3X2X_STAGE_ECG_CALI,          /**< ecg gain calibration */
+    GH3X2X_STAGE_LEAD,              /**< soft lead and ecg rs handle */
+    GH3X2X_STAGE_AGC,               /**< soft agc */
+    GH3X2X_STAGE_PROTOCOL,          /**< dump record, fifo package and event report */
+    GH3X2X_STAGE_LOW_POWER,         /**< enter low power */
+    GH3X2X_STAGE_GSENSOR,           /**< gsensor/cap/temp fetch of fifo block */
+    GH3X2X_STAGE_FUNC_PROCESS,      /**< function process and algorithm of fifo block */
+    GH3X2X_STAGE_NUM,
+} EMGh3x2xStage;
+
+/// stages of fifo block process, it runs in processing thread with int pipeline
+#define GH3X2X_STAGE_BLOCK_MASK             ((1 << GH3X2X_STAGE_GSENSOR) | (1 << GH3X2X_STAGE_FUNC_PROCESS))
+/// stages of int process pass
+#define GH3X2X_STAGE_INT_MASK               (((1 << GH3X2X_STAGE_NUM) - 1) & ~GH3X2X_STAGE_BLOCK_MASK)
+
+#define GH3X2X_STAGE_PROF_START(emStage)    Gh3x2xStageProfStart(emStage)
+#define GH3X2X_STAGE_PROF_END(emStage)      Gh3x2xStageProfEnd(emStage)
+#define GH3X2X_STAGE_PROF_DONE(unMask)      Gh3x2xStageProfDone(unMask)
+
+/**
+ * @fn     void Gh3x2xStageProfStart(EMGh3x2xStage emStage)
+ * 
+ * @brief  mark start of stage
+ *
+ * @attention   a start without end is dropped at next start
+ *
+ * @param[in]   emStage     stage
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xStageProfStart(EMGh3x2xStage emStage);
+
+/**
+ * @fn     void Gh3x2xStageProfEnd(EMGh3x2xStage emStage)
+ * 
+ * @brief  mark end of stage, cycles from start are added to the pass
+ *
+ * @attention   stage may run several times in one pass, it is counted once per pass
+ *
+ * @param[in]   emStage     stage
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xStageProfEnd(EMGh3x2xStage emStage);
+
+/**
+ * @fn     void Gh3x2xStageProfDone(GU32 unStageMask)
+ * 
+ * @brief  pass is done, add cycles of stages run in it to statistics
+ *
+ * @attention   every stage is owned by the thread calling this with its mask
+ *
+ * @param[in]   unStageMask     GH3X2X_STAGE_INT_MASK or GH3X2X_STAGE_BLOCK_MASK
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xStageProfDone(GU32 unStageMask);
+
+/**
+ * @fn     void Gh3x2xStageProfDump(void)
+ * 
+ * @brief  log min/avg/max and log2 histogram of every stage
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xStageProfDump(void);
+
+/**
+ * @fn     void Gh3x2xStageProfReset(void)
+ * 
+ * @brief  clear stage statistics
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xStageProfReset(void);
+#else
+#define GH3X2X_STAGE_PROF_START(emStage)
+#define GH3X2X_STAGE_PROF_END(emStage)
+#define GH3X2X_STAGE_PROF_DONE(unMask)
+#endif
+
+#if (__GH3X2X_ROUTE_TABLE_EN__)
+/// channel routing of one reg config array, generated from gh3x2x_demo_reg_array.c at build time
+typedef struct
+{
+    GU32 unTagRoute[32];                            /**< functions subscribing to every fifo word tag */
+    GU8 uchChnlNum[GH3X2X_FUNC_OFFSET_MAX];         /**< channel num of every function */
+} STGh3x2xRouteTable;
+
+/**
+ * @fn     void Gh3x2xDemoRouteTableInvalidate(void)
+ * 
+ * @brief  drop routing table, config is changed by other than reg config array
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xDemoRouteTableInvalidate(void);
+#endif
+
+#if (__GH3X2X_FRAME_BATCH_EN__)
+/**
+ * @fn     void Gh3x2xDemoFrameBatchPush(const STGh3x2xFrameInfo * const pstFrameInfo)
+ * 
+ * @brief  add one frame to batch of gh3x2x_frame_batch_hook_func
+ *
+ * @attention   batch is delivered first if frame is of another function, and after it if batch is full
+ *
+ * @param[in]   pstFrameInfo    decoded frame
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xDemoFrameBatchPush(const STGh3x2xFrameInfo * const pstFrameInfo);
+
+/**
+ * @fn     void Gh3x2xDemoFrameBatchFlush(void)
+ * 
+ * @brief  deliver collected frames by gh3x2x_frame_batch_hook_func
+ *
+ * @attention   called at fifo block done, no frame is kept across blocks
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xDemoFrameBatchFlush(void);
+#endif
+
+/// fifo words decoded as structure of arrays
+typedef struct
+{
+    GU32 *punAdcCode;       /**< bit23~0: adc code */
+    GU8 *puchSlot;          /**< bit31~29: slot num */
+    GU8 *puchAdc;           /**< bit28~27: adc num */
+    GU8 *puchFlag;          /**< bit26~25, bit1: led adj is agc of ppg or fast recover of ecg  bit0: led adj is up */
+} STGh3x2xFifoDecodeSoa;
+
+/**
+ * @fn     void Gh3x2xFifoDecode(const GU8 *puchFifo, GU16 usWordNum, const STGh3x2xFifoDecodeSoa *pstOut)
+ * 
+ * @brief  decode big endian fifo words to structure of arrays, REV and PKHBT/UXTB16 kernel on cortex-m4
+ *
+ * @attention   puchFifo needs no alignment, output is bit-for-bit same as Gh3x2xFifoDecodeRef
+ *
+ * @param[in]   puchFifo        fifo data
+ * @param[in]   usWordNum       fifo word num
+ * @param[out]  pstOut          decoded arrays, usWordNum entries each
+ *
+ * @return  None
+ */
+extern void Gh3x2xFifoDecode(const GU8 *puchFifo, GU16 usWordNum, const STGh3x2xFifoDecodeSoa *pstOut);
+
+/**
+ * @fn     void Gh3x2xFifoDecodeRef(const GU8 *puchFifo, GU16 usWordNum, const STGh3x2xFifoDecodeSoa *pstOut)
+ * 
+ * @brief  decode big endian fifo words to structure of arrays, portable c reference
+ *
+ * @attention   None
+ *
+ * @param[in]   puchFifo        fifo data
+ * @param[in]   usWordNum       fifo word num
+ * @param[out]  pstOut          decoded arrays, usWordNum entries each
+ *
+ * @return  None
+ */
+extern void Gh3x2xFifoDecodeRef(const GU8 *puchFifo, GU16 usWordNum, const STGh3x2xFifoDecodeSoa *pstOut);
+
+#if (__GH3X2X_FIFO_DECODE_EN__)
+/**
+ * @fn     void Gh3x2xFifoDecodeBlock(const GU8 *puchFifo, GU16 usLength)
+ * 
+ * @brief  decode fifo block of rawdata hook and deliver it by gh3x2x_fifo_decode_hook_func
+ *
+ * @attention   decode cycles are added to statistics logged by Gh3x2xFifoDecodeStatLog
+ *
+ * @param[in]   puchFifo        fifo data
+ * @param[in]   usLength        fifo data length in byte
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xFifoDecodeBlock(const GU8 *puchFifo, GU16 usLength);
+
+/**
+ * @fn     void Gh3x2xFifoDecodeStatLog(void)
+ * 
+ * @brief  log decode cycles/word of fifo blocks since last log, and clear statistics
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xFifoDecodeStatLog(void);
+#endif
+
+#if (__GH3X2X_FIFO_DECODE_BENCHMARK_EN__)
+/**
+ * @fn     void Gh3x2xFifoDecodeBenchmark(void)
+ * 
+ * @brief  benchmark of fifo word decode, log cycles/word of kernel and c reference and check they match
+ *
+ * @attention   run by shell cmd gh3x2x_bench decode
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xFifoDecodeBenchmark(void);
+#endif
+
+/**
+ * @fn     void Gh3x2xGsensorIngest(STGsensorRawdata *pstDst, const STGsensorRawdata *pstSrc, GU16 usPointNum)
+ * 
+ * @brief  copy gsensor points with sensitivity shift and axis remap in one pass, SHADD16/PKHBT kernel on cortex-m4
+ *
+ * @attention   pstDst may be pstSrc, output is bit-for-bit same as Gh3x2xGsensorIngestRef
+ *
+ * @param[in]   pstSrc          gsensor points of driver
+ * @param[in]   usPointNum      point num
+ * @param[out]  pstDst          normalized points
+ *
+ * @return  None
+ */
+extern void Gh3x2xGsensorIngest(STGsensorRawdata *pstDst, const STGsensorRawdata *pstSrc, GU16 usPointNum);
+
+/**
+ * @fn     void Gh3x2xGsensorIngestRef(STGsensorRawdata *pstDst, const STGsensorRawdata *pstSrc, GU16 usPointNum)
+ * 
+ * @brief  copy gsensor points with sensitivity shift and axis remap, portable c reference
+ *
+ * @attention   pstDst may be pstSrc
+ *
+ * @param[in]   pstSrc          gsensor points of driver
+ * @param[in]   usPointNum      point num
+ * @param[out]  pstDst          normalized points
+ *
+ * @return  None
+ */
+extern void Gh3x2xGsensorIngestRef(STGsensorRawdata *pstDst, const STGsensorRawdata *pstSrc, GU16 usPointNum);
+
+#if (__GH3X2X_GS_INGEST_BENCHMARK_EN__)
+/**
+ * @fn     void Gh3x2xGsensorIngestBenchmark(void)
+ * 
+ * @brief  benchmark of gsensor ingest of 300 point block, log cycles of two pass, kernel and c reference and check they match
+ *
+ * @attention   run by shell cmd gh3x2x_bench ingest
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xGsensorIngestBenchmark(void);
+#endif
+
+#if (__GH3X2X_MOVE_DETECT_BENCHMARK_EN__) && (__SUPPORT_HARD_ADT_CONFIG__)
+/**
+ * @fn     void Gh3x2xGsMoveDetectBenchmark(void)
+ * 
+ * @brief  benchmark of soft adt move detect, log cycles of 25/50/100Hz blocks and check kernel matches c reference
+ *
+ * @attention   run by shell cmd gh3x2x_bench move
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xGsMoveDetectBenchmark(void);
+#endif
+
+#if (__GH3X2X_CASCADE_CONCURRENT_READ_EN__)
+/**
+ * @fn     GU8 Gh3x2xCascadeFifoByteNumRead(GU16 *pusMasterByteNum, GU16 *pusSlaverByteNum)
+ * 
+ * @brief  read fifo count of master and slaver chip at the same time
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  pusMasterByteNum    fifo byte num of master
+ * @param[out]  pusSlaverByteNum    fifo byte num of slaver
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error, byte num is 0
+ */
+extern GU8 Gh3x2xCascadeFifoByteNumRead(GU16 *pusMasterByteNum, GU16 *pusSlaverByteNum);
+
+/**
+ * @fn     GU8 Gh3x2xCascadeFifoPrefetch(GU16 usByteNum)
+ * 
+ * @brief  drain usByteNum of both chip fifos at the same time, GH3X2X_CascadeReadFifodata gets them from ram
+ *
+ * @attention   usByteNum must not be more than fifo byte num of both chips
+ *
+ * @param[in]   usByteNum   fifo byte num to read from each chip
+ * @param[out]  None
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error, drv lib will read fifo from chip
+ */
+extern GU8 Gh3x2xCascadeFifoPrefetch(GU16 usByteNum);
+#endif
+
+#if (__GH3X2X_INT_LATENCY_MEASURE_EN__)
+/**
+ * @fn     void Gh3x2xIntLatencyFifoDataReady(void)
+ * 
+ * @brief  mark that fifo data of last int edge is in ram, latency from int edge is counted once per int
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xIntLatencyFifoDataReady(void);
+#endif
+
+/**
+ * @fn     void Gh3x2xDemoAlgorithmCalculate(GU8* puchReadFifoBuffer, STGsensorRawdata *pstGsAxisValueArr, 
+ *                                              GU16 usGsDataNum, EMGsensorSensitivity emGsSensitivity)
+ *
+ * @brief  Algorithm calculate.This function will be called in Gh3x2xDemoInterruptProcess()
+ *
+ * @attention   None
+ *
+ * @param[in]   puchReadFifoBuffer      point to gh3x2x fifo data buffer
+ * @param[in]   pstGsAxisValueArr       point to gsensor data buffer
+ * @param[in]   usGsDataNum             gsensor data cnt
+ * @param[in]   emGsSensitivity         sensitivity of gsensor
+ * @param[out]  None
+ *
+ * @return  None
+ */
+
+void Gh3x2xDemoFunctionProcess(GU8* puchReadFifoBuffer, GU16 usFifoBuffLen,STGsensorRawdata *pstGsAxisValueArr, GU16 usGsDataNum,
+                                   STCapRawdata* pstCapValueArr,GU16 usCapDataNum,STTempRawdata* pstTempValueArr,GU16 usTempDataNum);
+
+/**
+ * @fn     void Gh3x2xDemoSamplingControl(EMUprotocolParseCmdType emSwitch)
+ *
+ * @brief  Start/stop sampling of gh3x2x and sensor
+ *
+ * @attention   None
+ *
+ * @param[in]   unFuncMode      function that will be started or stopped
+ * @param[in]   emSwitch        stop/start sampling
+ * @param[out]  None
+ *
+ * @return  None
+ */
+extern void Gh3x2xDemoSamplingControl(GU32 unFuncMode, EMUprotocolParseCmdType emSwitch);
+
+/// dump mode
+extern GU16 g_usDumpMode;
+extern GU8 g_uchGh3x2xRegCfgArrIndex;
+extern GU16 g_usCurrentConfigListFifoWmBak;
+extern void GH3X2X_LedAgcProcessExDump(GU8* puchReadFifoBuffer);
+extern void GH3X2X_ReadElectrodeWearDumpData(void);
+extern void GH3X2X_RecordDumpData(void);
+extern void gh3x2x_init_hook_func(void);
+extern void gh3x2x_sampling_start_hook_func(void);
+extern void gh3x2x_sampling_stop_hook_func(void);
+extern void gh3x2x_get_rawdata_hook_func(GU8 *read_buffer_ptr, GU16 length);
+extern void gh3x2x_algorithm_get_io_data_hook_func(const STGh3x2xFrameInfo * const pstFrameInfo);
+extern void gh3x2x_frame_data_hook_func(const STGh3x2xFrameInfo * const pstFrameInfo);
+extern void gh3x2x_fifo_block_done_hook_func(void);
+#if (__GH3X2X_FRAME_BATCH_EN__)
+extern void gh3x2x_frame_batch_hook_func(const STGh3x2xFrameBatch * const pstFrameBatch);
+#endif
+#if (__GH3X2X_FIFO_DECODE_EN__)
+extern void gh3x2x_fifo_decode_hook_func(const STGh3x2xFifoDecodeSoa * const pstFifoDecode, GU16 usWordNum);
+#endif
 extern void gh3x2x_reset_by_protocol_hook(void);
 extern void gh3x2x_config_set_start_hook(void);
 extern void gh3x2x_config_set_stop_hook(void);
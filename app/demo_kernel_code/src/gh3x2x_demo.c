@@ -36,6 +36,8 @@
 
 #if (__ADT_ONLY_PARTICULAR_WM_CONFIG__)
 GU16 g_usCurrentConfigListFifoWmBak = 0;
+#endif
+#if (__ADT_ONLY_PARTICULAR_WM_CONFIG__) || (__GH3X2X_FIFO_WM_ADAPTIVE_EN__)
 extern GU16 g_usCurrentFiFoWaterLine;
 #endif
 
@@ -903,20 +905,55 @@ const STGh3x2xFrameInfo * const  g_pstGh3x2xFrameInfo[GH3X2X_FUNC_OFFSET_MAX] =
 
 /// read data buffer
 
+#if __GH3X2X_CASCADE_EN__
+#define GH3X2X_READ_RAWDATA_BUFFER_SIZE     (2 * __GH3X2X_RAWDATA_BUFFER_SIZE__)
+#else
+#define GH3X2X_READ_RAWDATA_BUFFER_SIZE     (__GH3X2X_RAWDATA_BUFFER_SIZE__)
+#endif
+
 #if __USER_DYNAMIC_DRV_BUF_EN__
+static GU8 *g_puchGh3x2xReadRawdataBufferRing[__GH3X2X_RAWDATA_BUFFER_NUM__] = {0};
 static GU8 *g_puchGh3x2xReadRawdataBuffer = 0;
 #if __GH3X2X_CASCADE_EN__
 static GU8 *g_puchGh3x2xReadRawdataBufferSlaveChip = 0;
 #endif
 #else
+static GU8 g_puchGh3x2xReadRawdataBufferRing[__GH3X2X_RAWDATA_BUFFER_NUM__][GH3X2X_READ_RAWDATA_BUFFER_SIZE];
+static GU8 *g_puchGh3x2xReadRawdataBuffer = g_puchGh3x2xReadRawdataBufferRing[0];
 #if __GH3X2X_CASCADE_EN__
-static GU8 g_puchGh3x2xReadRawdataBuffer[2 * __GH3X2X_RAWDATA_BUFFER_SIZE__];
 static GU8 g_puchGh3x2xReadRawdataBufferSlaveChip[__GH3X2X_RAWDATA_SLAVE_BUFFER_SIZE__];
-#else
-static GU8 g_puchGh3x2xReadRawdataBuffer[__GH3X2X_RAWDATA_BUFFER_SIZE__];
 #endif
 #endif
 
+/// index of current read buffer in ring
+static GU8 g_uchGh3x2xReadRawdataBufferIndex = 0;
+
+#if (__GH3X2X_INT_PIPELINE_EN__)
+/// fifo block queued by int process for processing thread
+typedef struct
+{
+    GU8 *puchRawdata;
+    GU16 usRawdataLen;
+    GU32 unGeneration;      /**< generation of sampling the block belongs to */
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+    GS64 llTimeStampUs;     /**< time of newest fifo word of the block */
+#endif
+} STGh3x2xPipelineBlock;
+
+/// spsc ring, slot n is rawdata buffer n of ring; head is written by int process only, tail by processing thread only
+static STGh3x2xPipelineBlock g_stGh3x2xPipelineBlock[__GH3X2X_RAWDATA_BUFFER_NUM__];
+static GU32 g_unGh3x2xPipelineHead = 0;
+static GU32 g_unGh3x2xPipelineTail = 0;
+
+/// moves at every sampling stop, blocks of older generation are dropped by processing thread
+static GU32 g_unGh3x2xPipelineGeneration = 0;
+
+/// fifo data is read into buffer of head slot since last push
+static GU8 g_uchGh3x2xPipelineBlockRead = 0;
+
+static STGh3x2xPipelineStat g_stGh3x2xPipelineStat = {0};
+#endif
+
 /// read data buffer len
 GU16 g_usGh3x2xReadRawdataLen = 0;
 
@@ -928,6 +965,289 @@ extern void Gh3x2xDemoStartSamplingInner(GU32 unFuncMode, GU8 uchSwitchEnable);
 /// driver lib demo init flag
 static GU8 g_uchGh3x2xInitFlag = 0;
 
+/// fifo watermark override of reg config array, 0: not override
+static GU16 g_usGh3x2xFifoWatermarkOverride = 0;
+
+/**
+ * @fn     void Gh3x2xDemoFifoWatermarkOverride(GU16 usWatermark)
+ *
+ * @brief  set fifo watermark that overrides reg config array
+ *
+ * @attention   take effect from next reg config load(init, cfg switch, chip reset recovery)
+ *
+ * @param[in]   usWatermark     fifo watermark in words, 0: use watermark of reg config array
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoFifoWatermarkOverride(GU16 usWatermark)
+{
+    g_usGh3x2xFifoWatermarkOverride = usWatermark;
+}
+
+#if (__GH3X2X_FIFO_WM_ADAPTIVE_EN__)
+/// ble connection interval in ms, 0: not connected
+static GU16 g_usGh3x2xFifoWmConnIntervalMs = 0;
+
+/// 1: raw data is streamed out  0: only algorithm results are consumed
+static GU8 g_uchGh3x2xFifoWmRawStream = __SUPPORT_PROTOCOL_ANALYZE__;
+
+/// 1: inputs changed, watermark is recomputed after next fifo read
+static volatile GU8 g_uchGh3x2xFifoWmAdaptiveDirty = 0;
+
+/**
+ * @fn     void Gh3x2xDemoFifoWmConnIntervalSet(GU16 usConnIntervalMs)
+ *
+ * @brief  set ble connection interval of adaptive fifo watermark
+ *
+ * @attention   take effect after next fifo read
+ *
+ * @param[in]   usConnIntervalMs    connection interval in ms, 0: not connected
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoFifoWmConnIntervalSet(GU16 usConnIntervalMs)
+{
+    g_usGh3x2xFifoWmConnIntervalMs = usConnIntervalMs;
+    g_uchGh3x2xFifoWmAdaptiveDirty = 1;
+}
+
+/**
+ * @fn     void Gh3x2xDemoFifoWmRawStreamSet(GU8 uchRawStream)
+ *
+ * @brief  set whether raw data is streamed out or only algorithm results are consumed
+ *
+ * @attention   take effect after next fifo read
+ *
+ * @param[in]   uchRawStream    1: raw data is streamed  0: only algorithm results
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoFifoWmRawStreamSet(GU8 uchRawStream)
+{
+    g_uchGh3x2xFifoWmRawStream = uchRawStream;
+    g_uchGh3x2xFifoWmAdaptiveDirty = 1;
+}
+
+/**
+ * @fn     static GU16 Gh3x2xDemoFifoWmAdaptiveCalc(GU32 unFuncMode)
+ *
+ * @brief  calc fifo watermark that is filled within latency budget of opened functions
+ *
+ * @attention   watermark = words/s of fastest opened function(sample rate * channel num) * budget, clamped to
+ *              [3, __GH3X2X_RAWDATA_BUFFER_SIZE__ / 4]. Fifo fills at least at that rate, so watermark int comes
+ *              within the budget; more opened functions only make it come earlier
+ *
+ * @param[in]   unFuncMode      opened functions
+ * @param[out]  None
+ *
+ * @return  fifo watermark in words
+ */
+static GU16 Gh3x2xDemoFifoWmAdaptiveCalc(GU32 unFuncMode)
+{
+    GU32 unWordRate = 0;
+    GU32 unBudgetMs;
+    GU32 unWatermark;
+
+    for (GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
+    {
+        if (g_pstGh3x2xFrameInfo[uchFunCnt] && (unFuncMode & (((GU32)1) << uchFunCnt)))
+        {
+            GU32 unFuncWordRate = (GU32)g_pstGh3x2xFrameInfo[uchFunCnt]->pstFunctionInfo->usSampleRate
+                                  * g_pstGh3x2xFrameInfo[uchFunCnt]->pstFunctionInfo->uchChnlNum;
+            if (unWordRate < unFuncWordRate)
+            {
+                unWordRate = unFuncWordRate;
+            }
+        }
+    }
+
+    if (g_uchGh3x2xFifoWmRawStream)
+    {
+        //no use to read faster than ble sends
+        unBudgetMs = (g_usGh3x2xFifoWmConnIntervalMs) ? g_usGh3x2xFifoWmConnIntervalMs : __GH3X2X_FIFO_WM_RAW_LATENCY_MS__;
+    #if (__FUNC_TYPE_ECG_ENABLE__)
+        if ((unFuncMode & GH3X2X_FUNCTION_ECG) && (unBudgetMs > __GH3X2X_FIFO_WM_ECG_LIVE_LATENCY_MS__))
+        {
+            unBudgetMs = __GH3X2X_FIFO_WM_ECG_LIVE_LATENCY_MS__;
+        }
+    #endif
+    }
+    else
+    {
+        unBudgetMs = __GH3X2X_FIFO_WM_RESULT_LATENCY_MS__;
+    }
+
+    unWatermark = unWordRate * unBudgetMs / 1000;
+    if (unWatermark > (__GH3X2X_RAWDATA_BUFFER_SIZE__ / 4))
+    {
+        unWatermark = (__GH3X2X_RAWDATA_BUFFER_SIZE__ / 4);
+    }
+    if (unWatermark < 3)
+    {
+        unWatermark = 3;
+    }
+    return (GU16)unWatermark;
+}
+
+/**
+ * @fn     static void Gh3x2xDemoFifoWmAdaptiveApply(void)
+ *
+ * @brief  write adaptive fifo watermark of opened functions
+ *
+ * @attention   call when fifo is (nearly) empty, chip generates no watermark int if fifo use count is
+ *              already over new watermark. Gh3x2xDemoFifoWatermarkOverride and __ADT_ONLY_PARTICULAR_WM_CONFIG__
+ *              take precedence
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoFifoWmAdaptiveApply(void)
+{
+    GU16 usWatermark;
+
+    g_uchGh3x2xFifoWmAdaptiveDirty = 0;
+    if (g_usGh3x2xFifoWatermarkOverride || (GH3X2X_NO_FUNCTION == g_unDemoFuncMode))
+    {
+        return;
+    }
+#if (__ADT_ONLY_PARTICULAR_WM_CONFIG__)
+    if (GH3X2X_FUNCTION_ADT == g_unDemoFuncMode)
+    {
+        return;
+    }
+#endif
+    usWatermark = Gh3x2xDemoFifoWmAdaptiveCalc(g_unDemoFuncMode);
+    if (usWatermark != g_usCurrentFiFoWaterLine)
+    {
+        GH3X2X_FifoWatermarkThrConfig(usWatermark);
+        g_usCurrentFiFoWaterLine = usWatermark;
+        EXAMPLE_LOG("adaptive fifo watermark = %d, func = 0x%X, conn interval = %d, raw stream = %d\r\n",
+                    (int)usWatermark, (int)g_unDemoFuncMode, (int)g_usGh3x2xFifoWmConnIntervalMs, (int)g_uchGh3x2xFifoWmRawStream);
+    }
+}
+#endif
+
+#if (__GH3X2X_ROUTE_TABLE_EN__)
+#include "gh3x2x_demo_route_table.h"
+
+/// routing table of loaded reg config array, 0: config is not a shipped array or table does not match drv lib
+static const STGh3x2xRouteTable *g_pstGh3x2xRouteTable = 0;
+
+/**
+ * @fn     static void Gh3x2xDemoRouteTableSelect(const STGh3x2xInitConfig *pstGh3x2xInitConfigParam)
+ *
+ * @brief  select generated routing table of loaded reg config array
+ *
+ * @attention   called after drv lib decoded config, only channel num of every function is checked against drv lib,
+ *              table is not used if a function has more channels than its frame takes
+ *
+ * @param[in]   pstGh3x2xInitConfigParam    loaded reg config array
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoRouteTableSelect(const STGh3x2xInitConfig *pstGh3x2xInitConfigParam)
+{
+    GU32 unCfgIndex = (GU32)(pstGh3x2xInitConfigParam - g_stGh3x2xCfgListArr);
+    const STGh3x2xRouteTable *pstRouteTable;
+
+    g_pstGh3x2xRouteTable = 0;
+    if ((pstGh3x2xInitConfigParam < g_stGh3x2xCfgListArr) || (unCfgIndex >= GH3X2X_ROUTE_TABLE_NUM)
+        || (unCfgIndex >= __GH3X2X_CFG_LIST_MAX_NUM__))
+    {
+        return;
+    }
+    pstRouteTable = &g_stGh3x2xRouteTable[unCfgIndex];
+    for (GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
+    {
+        const STGh3x2xFrameInfo *pstFrameInfo = g_pstGh3x2xFrameInfo[uchFunCnt];
+        GU8 uchChnlNum;
+
+        if (0 == pstFrameInfo)
+        {
+            continue;
+        }
+        uchChnlNum = pstFrameInfo->pstFunctionInfo->uchChnlNum;
+        if ((uchChnlNum != pstRouteTable->uchChnlNum[uchFunCnt]) || (uchChnlNum > pstFrameInfo->uchFuntionChnlLimit))
+        {
+            EXAMPLE_LOG("[RouteTable]cfg%d func%d chnl num %d != %d, routing is built at runtime\r\n", (int)unCfgIndex,
+                        (int)uchFunCnt, (int)uchChnlNum, (int)pstRouteTable->uchChnlNum[uchFunCnt]);
+            return;
+        }
+    }
+    g_pstGh3x2xRouteTable = pstRouteTable;
+}
+
+/**
+ * @fn     void Gh3x2xDemoRouteTableInvalidate(void)
+ *
+ * @brief  drop routing table, config is changed by other than reg config array
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoRouteTableInvalidate(void)
+{
+    g_pstGh3x2xRouteTable = 0;
+}
+#endif
+
+/**
+ * @fn     static GS8 Gh3x2xDemoLoadRegCfg(const STGh3x2xInitConfig *pstGh3x2xInitConfigParam, const GCHAR *pchTag)
+ *
+ * @brief  init gh3x2x with reg config array, contiguous reg writes are sent as burst writes
+ *         fifo watermark of Gh3x2xDemoFifoWatermarkOverride is applied after reg config
+ *
+ * @attention   None
+ *
+ * @param[in]   pstGh3x2xInitConfigParam    reg config array
+ * @param[in]   pchTag                      log tag
+ * @param[out]  None
+ *
+ * @return  return of GH3X2X_Init
+ */
+static GS8 Gh3x2xDemoLoadRegCfg(const STGh3x2xInitConfig *pstGh3x2xInitConfigParam, const GCHAR *pchTag)
+{
+    GS8 chRet;
+#if (__GH3X2X_BUS_STAT_EN__)
+    EMGh3x2xBusPhase emBusPhaseBak = Gh3x2xBusStatPhaseSet(GH3X2X_BUS_PHASE_CFG_LOAD);
+#endif
+
+#if (__GH3X2X_REG_BURST_WRITE_EN__)
+    Gh3x2xRegBurstWriteStart();
+#endif
+    chRet = GH3X2X_Init(pstGh3x2xInitConfigParam);
+    if ((GH3X2X_RET_OK == chRet) && g_usGh3x2xFifoWatermarkOverride)
+    {
+        GH3X2X_FifoWatermarkThrConfig(g_usGh3x2xFifoWatermarkOverride);
+    }
+#if (__GH3X2X_ROUTE_TABLE_EN__)
+    if (GH3X2X_RET_OK == chRet)
+    {
+        Gh3x2xDemoRouteTableSelect(pstGh3x2xInitConfigParam);
+    }
+#endif
+#if (__GH3X2X_FIFO_WM_ADAPTIVE_EN__)
+    g_uchGh3x2xFifoWmAdaptiveDirty = 1;     //reg config restored its own watermark
+#endif
+#if (__GH3X2X_REG_BURST_WRITE_EN__)
+    Gh3x2xRegBurstWriteStop(pchTag);
+#endif
+#if (__GH3X2X_BUS_STAT_EN__)
+    Gh3x2xBusStatPhaseSet(emBusPhaseBak);
+#endif
+    return chRet;
+}
+
 
 static GU8 g_uchGh3x2xInterruptProNotFinishFlag = 0;
 
@@ -1039,14 +1359,27 @@ void Gh3x2xGetConfigVersion(const STGh3x2xInitConfig *pstGh3x2xInitConfigParam)
 
 #if __GS_NONSYNC_READ_EN__
 GU8 g_uchGh3x2xGsenosrExtralBufLen = __GS_EXTRA_BUF_LEN__;
+/// gsensor points kept in extra buf for next block, negative: points of next block already covered by held point
 GS16 g_sGh3x2xGsenorCurrentRemainPointNum;
 GU16 g_usGsenorRefFunction = 0;
-float g_fGh3x2xNonSyncGsensorStep;
+/// gsensor points per ref function frame = g_usGh3x2xNonSyncGsensorStepNum / g_usGh3x2xNonSyncGsensorStepDen, reduced
+GU16 g_usGh3x2xNonSyncGsensorStepNum;
+GU16 g_usGh3x2xNonSyncGsensorStepDen = 1;
+/// phase of next output point between extra buf head point and the one after it, in 1/g_usGh3x2xNonSyncGsensorStepDen
+GU16 g_usGh3x2xNonSyncGsensorPhase;
+/// gsensor points at ref function frame rate, passed to function process
+static STGsensorRawdata g_stGh3x2xNonSyncGsensorOut[__GSENSOR_DATA_BUFFER_SIZE__];
+static STGsensorRawdata g_stGh3x2xNonSyncGsensorHold;
+/// 1: output starts again one point behind next input point, at init and after resync
+static GU8 g_uchGh3x2xNonSyncGsensorRestart;
 
 
 void Gh3x2xNonSyncGsensorInit(void)
 {
     g_sGh3x2xGsenorCurrentRemainPointNum = 0;
+    g_usGh3x2xNonSyncGsensorPhase = 0;
+    memset(&g_stGh3x2xNonSyncGsensorHold, 0, sizeof(g_stGh3x2xNonSyncGsensorHold));
+    g_uchGh3x2xNonSyncGsensorRestart = 1;
     EXAMPLE_LOG("[Non-Sync Gsensor]non-sync gsensor init.\r\n");
 }
 
@@ -1054,6 +1387,8 @@ GU16 Gh3x2xGetCurrentRefFunction(void)
 {
     GU16 usSampleRateMax = 0;
     GU16 usRefFucntion = 0;
+    GU16 usGcdA = __GS_SAMPLE_RATE_HZ__;
+    GU16 usGcdB;
     //find max sample rate function in opened function
     for(GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
     {
@@ -1071,29 +1406,55 @@ GU16 Gh3x2xGetCurrentRefFunction(void)
     }
     
     EXAMPLE_LOG("[Non-Sync Gsensor]usRefFucntion = 0x%X.\r\n",usRefFucntion);
-    //calculate step
+    //calculate step, gsensor rate / ref function rate as reduced fraction
     if(usSampleRateMax)
     {
-        g_fGh3x2xNonSyncGsensorStep = __GS_SAMPLE_RATE_HZ__ / usSampleRateMax;
+        usGcdB = usSampleRateMax;
+        while (usGcdB)
+        {
+            GU16 usTemp = usGcdA % usGcdB;
+            usGcdA = usGcdB;
+            usGcdB = usTemp;
+        }
+        if ((g_usGh3x2xNonSyncGsensorStepNum != __GS_SAMPLE_RATE_HZ__ / usGcdA)
+            || (g_usGh3x2xNonSyncGsensorStepDen != usSampleRateMax / usGcdA))
+        {
+            g_usGh3x2xNonSyncGsensorStepNum = __GS_SAMPLE_RATE_HZ__ / usGcdA;
+            g_usGh3x2xNonSyncGsensorStepDen = usSampleRateMax / usGcdA;
+            g_usGh3x2xNonSyncGsensorPhase = 0;
+        }
     }
     else
     {
-        g_fGh3x2xNonSyncGsensorStep = 0;
+        g_usGh3x2xNonSyncGsensorStepNum = 0;
+        g_usGh3x2xNonSyncGsensorStepDen = 1;
+        g_usGh3x2xNonSyncGsensorPhase = 0;
         EXAMPLE_LOG("[Non-Sync Gsensor]Error !!! usSampleRateMax = 0.\r\n");
     }
-    EXAMPLE_LOG("[Non-Sync Gsensor]g_fGh3x2xNonSyncGsensorStep = %.3f.\r\n",g_fGh3x2xNonSyncGsensorStep);
+    EXAMPLE_LOG("[Non-Sync Gsensor]gsensor step = %d/%d.\r\n",g_usGh3x2xNonSyncGsensorStepNum,g_usGh3x2xNonSyncGsensorStepDen);
     
     EXAMPLE_LOG("[Non-Sync Gsensor]usRefFucntion = 0x%d,usSampleRateMax = %d.\r\n",usRefFucntion,usSampleRateMax);
     return usRefFucntion;
 }
 
+/**
+ * @fn     GU16 Gh3x2xGetGsensorNeedPointNum(GU16 usCurrentGsenosrPoint, GU8* puchReadFifoBuffer, GU16 usFifoBuffLen)
+ * 
+ * @brief  get gsensor point num of this fifo data, one point per ref function frame
+ *
+ * @attention   None
+ *
+ * @param[in]   usCurrentGsenosrPoint   gsensor point num read in this block
+ * @param[in]   puchReadFifoBuffer      fifo data
+ * @param[in]   usFifoBuffLen           fifo data len
+ * @param[out]  None
+ *
+ * @return  gsensor point num
+ */
 GU16 Gh3x2xGetGsensorNeedPointNum(GU16 usCurrentGsenosrPoint,GU8* puchReadFifoBuffer, GU16 usFifoBuffLen)
 {
     GU8 uchFunctionOfst = 0xFF;
     GU16 usFrameNum = 0;
-    GU16 usTempGsensorPointNum = 0;
-    GU16 usTempGsensorPointNumFloat = 0;
-    static GU16 usTempGsensorPointNumFractPart = 0;
 
     for(GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
     {
@@ -1113,93 +1474,176 @@ GU16 Gh3x2xGetGsensorNeedPointNum(GU16 usCurrentGsenosrPoint,GU8* puchReadFifoBu
     {
         usFrameNum = GH3x2xGetFrameNum(puchReadFifoBuffer,usFifoBuffLen,g_pstGh3x2xFrameInfo[uchFunctionOfst]);
     }
-    
-    
-
-    usTempGsensorPointNumFloat = (float)usFrameNum * g_fGh3x2xNonSyncGsensorStep;
-    usTempGsensorPointNum = (GU16)(usTempGsensorPointNumFloat + usTempGsensorPointNumFractPart);
-    usTempGsensorPointNumFractPart = usTempGsensorPointNumFloat - (GU16)usTempGsensorPointNumFloat;
-
-    if(usTempGsensorPointNum > (__GS_EXTRA_BUF_LEN__ + usCurrentGsenosrPoint))
+    if(usFrameNum > __GSENSOR_DATA_BUFFER_SIZE__)
     {
-        usTempGsensorPointNum = __GS_EXTRA_BUF_LEN__ + usCurrentGsenosrPoint;
+        EXAMPLE_LOG("[Non-Sync Gsensor]ref frame num %d is over gsensor buffer.\r\n",usFrameNum);
+        usFrameNum = __GSENSOR_DATA_BUFFER_SIZE__;
     }
 
-    
-    EXAMPLE_LOG("[Non-Sync Gsensor]GsensorNeedPointNum = %d.\r\n",usTempGsensorPointNum);
+    EXAMPLE_LOG("[Non-Sync Gsensor]GsensorNeedPointNum = %d.\r\n",usFrameNum);
+
+    return usFrameNum;
+}
 
-    return usTempGsensorPointNum;
+/**
+ * @fn     static GS16 Gh3x2xNonSyncGsensorLerp(GS16 sVal0, GS16 sVal1, GU16 usPhase, GU16 usDen)
+ * 
+ * @brief  linear interpolation of one axis
+ *
+ * @attention   None
+ *
+ * @param[in]   sVal0       value at phase 0
+ * @param[in]   sVal1       value at phase usDen
+ * @param[in]   usPhase     phase, < usDen
+ * @param[in]   usDen       phase num between two gsensor points
+ * @param[out]  None
+ *
+ * @return  interpolated value
+ */
+static GS16 Gh3x2xNonSyncGsensorLerp(GS16 sVal0, GS16 sVal1, GU16 usPhase, GU16 usDen)
+{
+    return (GS16)(sVal0 + (((GS32)sVal1 - sVal0) * usPhase) / usDen);
 }
 
-GS16 Gh3x2xGetGsensorHeadPos(GU16 usCurrentGsenosrPoint,GU16 usNeedPoinNum)
+/**
+ * @fn     static const STGsensorRawdata* Gh3x2xNonSyncGsensorPointGet(const STGsensorRawdata *pstSrc, GU16 usSrcNum, GS32 nPos)
+ * 
+ * @brief  get gsensor point of resample input
+ *
+ * @attention   points before input are the held point, points after input are the newest point
+ *
+ * @param[in]   pstSrc      input points
+ * @param[in]   usSrcNum    input point num
+ * @param[in]   nPos        point index
+ * @param[out]  None
+ *
+ * @return  point
+ */
+static const STGsensorRawdata* Gh3x2xNonSyncGsensorPointGet(const STGsensorRawdata *pstSrc, GU16 usSrcNum, GS32 nPos)
 {
-    GS16 sPos1;
-    GS16 sPos2;
-    EXAMPLE_LOG("[Non-Sync Gsensor]usCurrentGsenosrPoint = %d.\r\n",usCurrentGsenosrPoint);
-    sPos1 = (GS16)usCurrentGsenosrPoint - (GS16)usNeedPoinNum;
-    sPos2= (GS16)0 - g_sGh3x2xGsenorCurrentRemainPointNum;
+    if ((nPos < 0) || (0 == usSrcNum))
+    {
+        return &g_stGh3x2xNonSyncGsensorHold;
+    }
+    if (nPos >= usSrcNum)
+    {
+        return &pstSrc[usSrcNum - 1];
+    }
+    return &pstSrc[nPos];
+}
 
-    if(sPos1 < sPos2)
+/**
+ * @fn     STGsensorRawdata* Gh3x2xNonSyncGsensorResample(GU16 usCurrentGsenosrPoint, GU16 usNeedPoinNum)
+ * 
+ * @brief  resample gsensor points to ref function frame rate by rational step
+ *
+ * @attention   Points kept in extra buf and phase carry over to next block, so output has no drift against
+ *              frames. Phase step is g_usGh3x2xNonSyncGsensorStepNum in 1/g_usGh3x2xNonSyncGsensorStepDen,
+ *              every output point is interpolated between its two neighbour points by integer math. Output
+ *              trails input by one point, so the point after the last output point(look-ahead) has arrived
+ *              and is kept in extra buf with the ones after it. When points are later than that the newest
+ *              one is held, and the points are skipped on arrival; when points are over extra buf the oldest
+ *              ones are given up.
+ *
+ * @param[in]   usCurrentGsenosrPoint   gsensor point num read in this block, after extra buf
+ * @param[in]   usNeedPoinNum           output point num
+ * @param[out]  None
+ *
+ * @return  output points
+ */
+STGsensorRawdata* Gh3x2xNonSyncGsensorResample(GU16 usCurrentGsenosrPoint, GU16 usNeedPoinNum)
+{
+    const GU16 usStepInt = g_usGh3x2xNonSyncGsensorStepNum / g_usGh3x2xNonSyncGsensorStepDen;
+    const GU16 usStepFrac = g_usGh3x2xNonSyncGsensorStepNum % g_usGh3x2xNonSyncGsensorStepDen;
+    const GU16 usDen = g_usGh3x2xNonSyncGsensorStepDen;
+    STGsensorRawdata *pstSrc = gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__;
+    GU16 usSrcNum = usCurrentGsenosrPoint;
+    GU16 usPhase = g_usGh3x2xNonSyncGsensorPhase;
+    GS32 nSrcPos = 0;
+    GS32 nRemainNum;
+
+    if (g_sGh3x2xGsenorCurrentRemainPointNum >= 0)
     {
-        GS16 sOldestPosi;
-        GU8  uchExistOldData = 1;
-        GS16 sDesPosi = sPos1;
-        if(g_sGh3x2xGsenorCurrentRemainPointNum) //exist remain data
-        {
-            sOldestPosi = (GS16)0 - (GS16)g_sGh3x2xGsenorCurrentRemainPointNum;    
-        }
-        else if(usCurrentGsenosrPoint)   //use new gsensor data
-        {
-            sOldestPosi = 0; 
-        }
-        else
+        pstSrc -= g_sGh3x2xGsenorCurrentRemainPointNum;
+        usSrcNum += g_sGh3x2xGsenorCurrentRemainPointNum;
+    }
+    else
+    {
+        //points already covered by held point
+        GU16 usSkipNum = (GU16)(-g_sGh3x2xGsenorCurrentRemainPointNum);
+
+        if (usSkipNum > usSrcNum)
         {
-            uchExistOldData = 0;
+            usSkipNum = usSrcNum;
         }
-        EXAMPLE_LOG("[Non-Sync Gsensor]Gsensor data is not enough,add oldest point num = %d, uchExistOldData = %d.****\r\n",sPos2 - sPos1,uchExistOldData);
-        EXAMPLE_LOG("[Non-Sync Gsensor]GsensorHeadPos = %d.\r\n",sPos1);
-        if(uchExistOldData)
+        if (usSkipNum)
         {
-            for(sDesPosi = sPos1; sDesPosi < sOldestPosi;  sDesPosi++)  //copy oldest point value 
-            {
-                memcpy((GU8*)(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__ + sDesPosi),(GU8*)(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__ + sOldestPosi),sizeof(STGsensorRawdata));
-            }
+            g_stGh3x2xNonSyncGsensorHold = pstSrc[usSkipNum - 1];
         }
-        else  //copy 0
+        pstSrc += usSkipNum;
+        usSrcNum -= usSkipNum;
+        nSrcPos = g_sGh3x2xGsenorCurrentRemainPointNum + usSkipNum;    //<= 0, still covered if < 0
+    }
+    if (g_uchGh3x2xNonSyncGsensorRestart && usSrcNum)
+    {
+        //one point of delay: first output point is the first input point, held one point back
+        g_stGh3x2xNonSyncGsensorHold = pstSrc[0];
+        nSrcPos = -1;
+        g_uchGh3x2xNonSyncGsensorRestart = 0;
+    }
+
+    for (GU16 usPointCnt = 0; usPointCnt < usNeedPoinNum; usPointCnt++)
+    {
+        const STGsensorRawdata *pstPoint0 = Gh3x2xNonSyncGsensorPointGet(pstSrc, usSrcNum, nSrcPos);
+        const STGsensorRawdata *pstPoint1 = Gh3x2xNonSyncGsensorPointGet(pstSrc, usSrcNum, nSrcPos + 1);
+        STGsensorRawdata *pstOut = &g_stGh3x2xNonSyncGsensorOut[usPointCnt];
+
+        pstOut->sXAxisVal = Gh3x2xNonSyncGsensorLerp(pstPoint0->sXAxisVal, pstPoint1->sXAxisVal, usPhase, usDen);
+        pstOut->sYAxisVal = Gh3x2xNonSyncGsensorLerp(pstPoint0->sYAxisVal, pstPoint1->sYAxisVal, usPhase, usDen);
+        pstOut->sZAxisVal = Gh3x2xNonSyncGsensorLerp(pstPoint0->sZAxisVal, pstPoint1->sZAxisVal, usPhase, usDen);
+    #if __GS_GYRO_ENABLE__
+        pstOut->sXGyroVal = Gh3x2xNonSyncGsensorLerp(pstPoint0->sXGyroVal, pstPoint1->sXGyroVal, usPhase, usDen);
+        pstOut->sYGyroVal = Gh3x2xNonSyncGsensorLerp(pstPoint0->sYGyroVal, pstPoint1->sYGyroVal, usPhase, usDen);
+        pstOut->sZGyroVal = Gh3x2xNonSyncGsensorLerp(pstPoint0->sZGyroVal, pstPoint1->sZGyroVal, usPhase, usDen);
+    #endif
+        nSrcPos += usStepInt;
+        usPhase += usStepFrac;
+        if (usPhase >= usDen)
         {
-            memset((GU8*)gsensor_soft_fifo_buffer+ __GS_EXTRA_BUF_LEN__ + sDesPosi,0, usNeedPoinNum * sizeof(STGsensorRawdata));
+            usPhase -= usDen;
+            nSrcPos++;
         }
-
-        return sPos1;
     }
-    EXAMPLE_LOG("[Non-Sync Gsensor]GsensorHeadPos = %d.\r\n",sPos2);
-    return sPos2;
-}
+    if (usSrcNum)
+    {
+        g_stGh3x2xNonSyncGsensorHold = pstSrc[usSrcNum - 1];
+    }
 
-void Gh3x2xNonSyncGsenosrPostProcess(GU16 usCurrentGsenosrPoint,GU16 usNeedPoinNum ,GS16 sHeadPos)
-{
-    GS16 sRemainPointSrcStartPosi;
-    GS16 sRemainPointDesStartPosi;
-    GU16 usRemainPoinNum;
-    sRemainPointSrcStartPosi = (GS16)usNeedPoinNum + sHeadPos;
-    usRemainPoinNum = usCurrentGsenosrPoint - sRemainPointSrcStartPosi;
-    EXAMPLE_LOG("[Non-Sync Gsensor]raw usRemainPoinNum = %d.\r\n",usRemainPoinNum);
-    if(usRemainPoinNum > __GS_EXTRA_BUF_LEN__)
+    //keep points from next output point on for next block
+    nRemainNum = (GS32)usSrcNum - nSrcPos;
+    if (nRemainNum > __GS_EXTRA_BUF_LEN__)
     {
-        
-        EXAMPLE_LOG("[Non-Sync Gsensor]******Gsensor data is too much, give up oldest point num = %d.****************\r\n",(usRemainPoinNum - __GS_EXTRA_BUF_LEN__));
-        sRemainPointSrcStartPosi += (usRemainPoinNum - __GS_EXTRA_BUF_LEN__);  //give up oldest data
-        usRemainPoinNum = __GS_EXTRA_BUF_LEN__;
+        EXAMPLE_LOG("[Non-Sync Gsensor]******Gsensor data is too much, give up oldest point num = %d.****************\r\n",(int)(nRemainNum - __GS_EXTRA_BUF_LEN__));
+        nRemainNum = __GS_EXTRA_BUF_LEN__;
+    }
+    else if (nRemainNum < -(GS32)__GS_EXTRA_BUF_LEN__)
+    {
+        EXAMPLE_LOG("[Non-Sync Gsensor]Gsensor data is not enough, resync at next point.****\r\n");
+        nRemainNum = 0;
+        usPhase = 0;
+        g_uchGh3x2xNonSyncGsensorRestart = 1;
     }
-    sRemainPointDesStartPosi = ((GS16)0) - usRemainPoinNum;
-    //copy remain data to extral buf
-    if(usRemainPoinNum)
+    if (nRemainNum > 0)
     {
-        memcpy((GU8*)(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__ + sRemainPointDesStartPosi),(GU8*)(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__ + sRemainPointSrcStartPosi),usRemainPoinNum*sizeof(STGsensorRawdata));
+        memmove(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__ - nRemainNum, pstSrc + usSrcNum - nRemainNum,
+                nRemainNum * sizeof(STGsensorRawdata));
     }
-    //update g_sGh3x2xGsenorCurrentRemainPointNum
-    g_sGh3x2xGsenorCurrentRemainPointNum = usRemainPoinNum;
-    EXAMPLE_LOG("[Non-Sync Gsensor]GsenosrPostProcess: RemainPointNum= %d.\r\n",g_sGh3x2xGsenorCurrentRemainPointNum);
+    g_sGh3x2xGsenorCurrentRemainPointNum = (GS16)nRemainNum;
+    g_usGh3x2xNonSyncGsensorPhase = usPhase;
+    EXAMPLE_LOG("[Non-Sync Gsensor]GsenosrPostProcess: RemainPointNum= %d, phase = %d/%d.\r\n",
+                g_sGh3x2xGsenorCurrentRemainPointNum, usPhase, usDen);
+
+    return g_stGh3x2xNonSyncGsensorOut;
 }
 #endif
 
@@ -1355,7 +1799,7 @@ GCHAR* GH3X2X_GetEvkBootloaderVersion(void)
  *
  * @brief  normalize gsensor sensitivity to  512LSB/g
  *
- * @attention   None
+ * @attention   axes are remapped too, in place by Gh3x2xGsensorIngest. Not needed with __GS_INGEST_BY_HAL__
  *
  * @param[in]    gsensor_buffer          gsensor rawdata buffer
  * @param[in]   gsensor_point_num     gsensor rawdata point num
@@ -1365,14 +1809,7 @@ GCHAR* GH3X2X_GetEvkBootloaderVersion(void)
  */
 void Gh3x2x_NormalizeGsensorSensitivity(STGsensorRawdata gsensor_buffer[], GU16 gsensor_point_num)
 {
-    GU8 uchRightShift;
-    uchRightShift = __GS_SENSITIVITY_CONFIG__;
-    for(GU16 uchCnt = 0; uchCnt < gsensor_point_num; uchCnt++)
-    {
-        gsensor_buffer[uchCnt].sXAxisVal >>= uchRightShift;
-        gsensor_buffer[uchCnt].sYAxisVal >>= uchRightShift;
-        gsensor_buffer[uchCnt].sZAxisVal >>= uchRightShift;
-    }
+    Gh3x2xGsensorIngest(gsensor_buffer, gsensor_buffer, gsensor_point_num);
 }
 
 
@@ -1418,16 +1855,137 @@ void Gh3x2xDemoFunctionSampleRateSet(GU32 unFunctionID,  GU16 usSampleRate)
 }
 #endif
 
+#if (__GH3X2X_FIFO_DEMUX_EN__)
+#define GH3X2X_FIFO_DEMUX_TAG_NUM               (32)        /**< slot(3bit) + adc(2bit) tag of fifo word */
+#define GH3X2X_FIFO_DEMUX_TAG(puchWord)         ((puchWord)[0] >> 3)    /**< bit31~27 of big endian word, GH3X2X_CHANNEL_MAP >> 3 */
+
+/// opened functions subscribing to every fifo word tag, bit n: function offset n
+static GU32 g_unGh3x2xFifoDemuxRoute[GH3X2X_FIFO_DEMUX_TAG_NUM];
+
+/// words of every opened function, packed one function after another
+static GU32 g_unGh3x2xFifoDemuxBuffer[__GH3X2X_FIFO_DEMUX_BUFFER_SIZE__ / 4];
+
 /**
- * @fn     void Gh3x2xDemoFunctionProcess(GU8* puchReadFifoBuffer, STGsensorRawdata *pstGsAxisValueArr, 
- *                                              GU16 usGsDataNum, EMGsensorSensitivity emGsSensitivity)
+ * @fn     static void Gh3x2xDemoFifoDemuxRouteUpdate(void)
  *
- * @brief  Function process.This function will be called in Gh3x2xDemoInterruptProcess()
+ * @brief  build fifo word tag to function routing table from channel map of opened functions
  *
- * @attention   None
+ * @attention   called after opened functions change, generated routing table of loaded config is used if valid
  *
- * @param[in]   puchReadFifoBuffer      point to gh3x2x fifo data buffer
- * @param[in]   pstGsAxisValueArr       point to gsensor data buffer
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoFifoDemuxRouteUpdate(void)
+{
+#if (__GH3X2X_ROUTE_TABLE_EN__)
+    if (g_pstGh3x2xRouteTable)
+    {
+        GU32 unOpenFuncMode = 0;
+
+        for (GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
+        {
+            if (g_pstGh3x2xFrameInfo[uchFunCnt])
+            {
+                unOpenFuncMode |= (((GU32)1) << uchFunCnt);
+            }
+        }
+        unOpenFuncMode &= g_unDemoFuncMode;
+        for (GU8 uchTag = 0; uchTag < GH3X2X_FIFO_DEMUX_TAG_NUM; uchTag ++)
+        {
+            g_unGh3x2xFifoDemuxRoute[uchTag] = g_pstGh3x2xRouteTable->unTagRoute[uchTag] & unOpenFuncMode;
+        }
+        return;
+    }
+#endif
+    memset(g_unGh3x2xFifoDemuxRoute, 0, sizeof(g_unGh3x2xFifoDemuxRoute));
+    for (GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
+    {
+        const STGh3x2xFrameInfo *pstFrameInfo = g_pstGh3x2xFrameInfo[uchFunCnt];
+
+        if ((0 == pstFrameInfo) || (0 == (g_unDemoFuncMode & (((GU32)1) << uchFunCnt))))
+        {
+            continue;
+        }
+        for (GU8 uchChnlCnt = 0; (uchChnlCnt < pstFrameInfo->pstFunctionInfo->uchChnlNum)
+                                 && (uchChnlCnt < pstFrameInfo->uchFuntionChnlLimit); uchChnlCnt ++)
+        {
+            g_unGh3x2xFifoDemuxRoute[GH3X2X_FIFO_DEMUX_TAG(&pstFrameInfo->pchChnlMap[uchChnlCnt])] |= (((GU32)1) << uchFunCnt);
+        }
+    }
+}
+
+/**
+ * @fn     static GU8 Gh3x2xDemoFifoDemux(GU8 *puchReadFifoBuffer, GU16 usFifoBuffLen, GU16 usFuncWordOffset[], GU16 usFuncWordNum[])
+ *
+ * @brief  scatter fifo words to demux buffer of every subscribing function, word order of each function is kept
+ *
+ * @attention   tag of every word is read once to count words per tag, once more to scatter
+ *
+ * @param[in]   puchReadFifoBuffer      fifo data
+ * @param[in]   usFifoBuffLen           fifo data len
+ * @param[out]  usFuncWordOffset        word offset of every function in demux buffer
+ * @param[out]  usFuncWordNum           word num of every function
+ *
+ * @return  1: done  0: demux buffer is too small, block must be parsed whole
+ */
+static GU8 Gh3x2xDemoFifoDemux(GU8 *puchReadFifoBuffer, GU16 usFifoBuffLen, GU16 usFuncWordOffset[], GU16 usFuncWordNum[])
+{
+    GU16 usTagWordNum[GH3X2X_FIFO_DEMUX_TAG_NUM] = {0};
+    GU16 usFuncWordCursor[GH3X2X_FUNC_OFFSET_MAX];
+    GU16 usWordNum = usFifoBuffLen / 4;
+    GU32 unTotalWordNum = 0;
+
+    for (GU16 usWordCnt = 0; usWordCnt < usWordNum; usWordCnt ++)
+    {
+        usTagWordNum[GH3X2X_FIFO_DEMUX_TAG(&puchReadFifoBuffer[usWordCnt * 4])]++;
+    }
+    for (GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
+    {
+        usFuncWordNum[uchFunCnt] = 0;
+        for (GU8 uchTag = 0; uchTag < GH3X2X_FIFO_DEMUX_TAG_NUM; uchTag ++)
+        {
+            if (g_unGh3x2xFifoDemuxRoute[uchTag] & (((GU32)1) << uchFunCnt))
+            {
+                usFuncWordNum[uchFunCnt] += usTagWordNum[uchTag];
+            }
+        }
+        usFuncWordOffset[uchFunCnt] = (GU16)unTotalWordNum;
+        usFuncWordCursor[uchFunCnt] = (GU16)unTotalWordNum;
+        unTotalWordNum += usFuncWordNum[uchFunCnt];
+    }
+    if (unTotalWordNum > (__GH3X2X_FIFO_DEMUX_BUFFER_SIZE__ / 4))
+    {
+        return 0;
+    }
+    for (GU16 usWordCnt = 0; usWordCnt < usWordNum; usWordCnt ++)
+    {
+        GU8 *puchWord = &puchReadFifoBuffer[usWordCnt * 4];
+        GU32 unRoute = g_unGh3x2xFifoDemuxRoute[GH3X2X_FIFO_DEMUX_TAG(puchWord)];
+
+        while (unRoute)
+        {
+            GU8 uchFunCnt = (GU8)__builtin_ctz(unRoute);
+
+            memcpy(&g_unGh3x2xFifoDemuxBuffer[usFuncWordCursor[uchFunCnt]++], puchWord, 4);
+            unRoute &= (unRoute - 1);
+        }
+    }
+    return 1;
+}
+#endif
+
+/**
+ * @fn     void Gh3x2xDemoFunctionProcess(GU8* puchReadFifoBuffer, STGsensorRawdata *pstGsAxisValueArr, 
+ *                                              GU16 usGsDataNum, EMGsensorSensitivity emGsSensitivity)
+ *
+ * @brief  Function process.This function will be called in Gh3x2xDemoInterruptProcess()
+ *
+ * @attention   None
+ *
+ * @param[in]   puchReadFifoBuffer      point to gh3x2x fifo data buffer
+ * @param[in]   pstGsAxisValueArr       point to gsensor data buffer
  * @param[in]   usGsDataNum             gsensor data cnt
  * @param[in]   emGsSensitivity         sensitivity of gsensor
  * @param[out]  None
@@ -1437,6 +1995,25 @@ void Gh3x2xDemoFunctionSampleRateSet(GU32 unFunctionID,  GU16 usSampleRate)
 void Gh3x2xDemoFunctionProcess(GU8* puchReadFifoBuffer, GU16 usFifoBuffLen,STGsensorRawdata *pstGsAxisValueArr, GU16 usGsDataNum,
                                    STCapRawdata* pstCapValueArr,GU16 usCapDataNum,STTempRawdata* pstTempValueArr,GU16 usTempDataNum)
 {
+#if (__GH3X2X_FIFO_DEMUX_EN__)
+    GU16 usFuncWordOffset[GH3X2X_FUNC_OFFSET_MAX];
+    GU16 usFuncWordNum[GH3X2X_FUNC_OFFSET_MAX];
+
+    if (Gh3x2xDemoFifoDemux(puchReadFifoBuffer, usFifoBuffLen, usFuncWordOffset, usFuncWordNum))
+    {
+        for(GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
+        {
+            if(g_pstGh3x2xFrameInfo[uchFunCnt] && (g_unDemoFuncMode & (((GU32)1)<< uchFunCnt)))
+            {
+                GH3x2xFunctionProcess((GU8*)&g_unGh3x2xFifoDemuxBuffer[usFuncWordOffset[uchFunCnt]], usFuncWordNum[uchFunCnt] * 4,
+                                        (GS16*)pstGsAxisValueArr,usGsDataNum,
+                                        pstCapValueArr,usCapDataNum,pstTempValueArr,usTempDataNum,
+                                        g_pstGh3x2xFrameInfo[uchFunCnt]);
+            }
+        }
+        return;
+    }
+#endif
     for(GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
     {
         if(g_pstGh3x2xFrameInfo[uchFunCnt])
@@ -1471,10 +2048,13 @@ void Gh3x2xDemoFunctionProcess(GU8* puchReadFifoBuffer, GU16 usFifoBuffLen,STGse
  */
 GU8 Gh3x2xDemoMemCheckValid(void)
 {
-    if(0 == g_puchGh3x2xReadRawdataBuffer)
+    for (GU8 uchBufferIndex = 0; uchBufferIndex < __GH3X2X_RAWDATA_BUFFER_NUM__; uchBufferIndex++)
     {
-        EXAMPLE_LOG("%s : g_puchGh3x2xReadRawdataBuffer is invalid !!!\r\n", __FUNCTION__);
-        return 0;
+        if(0 == g_puchGh3x2xReadRawdataBufferRing[uchBufferIndex])
+        {
+            EXAMPLE_LOG("%s : g_puchGh3x2xReadRawdataBufferRing[%d] is invalid !!!\r\n", __FUNCTION__, uchBufferIndex);
+            return 0;
+        }
     }
     #if __GH3X2X_CASCADE_EN__
     if (GH3X2X_CascadeGetEcgEnFlag())
@@ -1492,14 +2072,15 @@ GU8 Gh3x2xDemoMemCheckValid(void)
 
 void Gh3x2xDemoMemInit(void)
 {
-    if(0 == g_puchGh3x2xReadRawdataBuffer)
+    for (GU8 uchBufferIndex = 0; uchBufferIndex < __GH3X2X_RAWDATA_BUFFER_NUM__; uchBufferIndex++)
     {
-        #if __GH3X2X_CASCADE_EN__
-        g_puchGh3x2xReadRawdataBuffer = Gh3x2xMallocUser(2 * __GH3X2X_RAWDATA_BUFFER_SIZE__);
-        #else
-        g_puchGh3x2xReadRawdataBuffer = Gh3x2xMallocUser(__GH3X2X_RAWDATA_BUFFER_SIZE__);
-        #endif
+        if(0 == g_puchGh3x2xReadRawdataBufferRing[uchBufferIndex])
+        {
+            g_puchGh3x2xReadRawdataBufferRing[uchBufferIndex] = Gh3x2xMallocUser(GH3X2X_READ_RAWDATA_BUFFER_SIZE);
+        }
     }
+    g_uchGh3x2xReadRawdataBufferIndex = 0;
+    g_puchGh3x2xReadRawdataBuffer = g_puchGh3x2xReadRawdataBufferRing[0];
     if(0 == Gh3x2xDemoMemCheckValid())
     {
         while(1);
@@ -1539,6 +2120,10 @@ int Gh3x2xDemoInit(void)
     Gh3x2xDemoMemInit();
     #endif
 
+    #if (__GH3X2X_CYCLE_CNT_EN__)
+    Gh3x2xCycleCntInit();
+    #endif
+
     #ifdef GOODIX_DEMO_PLANFORM
     EXAMPLE_LOG("%s : Firmware Version : %s\r\n", __FUNCTION__, GH3X2X_GetFirmwareVersion());
     #endif
@@ -1627,7 +2212,7 @@ int Gh3x2xDemoInit(void)
     EXAMPLE_LOG("xdg2\r\n");
     /* Step 3: Init gh3x2x chip */
     g_uchGh3x2xRegCfgArrIndex = 0;
-    schret = GH3X2X_Init(&g_stGh3x2xCfgListArr[0]);
+    schret = Gh3x2xDemoLoadRegCfg(&g_stGh3x2xCfgListArr[0], "init");
     EXAMPLE_LOG("xdg3\r\n");
     if (GH3X2X_RET_OK == schret)
     {
@@ -1697,6 +2282,84 @@ int Gh3x2xDemoInit(void)
     return (int)schret;
 }
 
+#if (0 == __GH3X2X_INT_PIPELINE_EN__)
+/**
+ * @fn     static GU8 Gh3x2xDemoNextReadRawdataBufferIndex(void)
+ *
+ * @brief  index of ring buffer that next fifo read goes into
+ *
+ * @attention   never the buffer of block under processing
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  buffer index in ring
+ */
+static GU8 Gh3x2xDemoNextReadRawdataBufferIndex(void)
+{
+    GU8 uchIndex = g_uchGh3x2xReadRawdataBufferIndex + 1;
+
+    if (uchIndex >= __GH3X2X_RAWDATA_BUFFER_NUM__)
+    {
+        uchIndex = 0;
+    }
+    return uchIndex;
+}
+#endif
+
+/**
+ * @fn     static void Gh3x2xDemoSwitchReadRawdataBuffer(void)
+ *
+ * @brief  move read buffer to next buffer of ring, call it before every fifo read
+ *
+ * @attention   with fifo prefetch, next block is read into the idle buffer while current one is processed, so
+ *              the block pointer is valid only until next int edge
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoSwitchReadRawdataBuffer(void)
+{
+#if (__GH3X2X_INT_PIPELINE_EN__)
+    /* read buffer is set to free slot at push, queued slots are not dma target */
+    __atomic_store_n(&g_uchGh3x2xPipelineBlockRead, 1, __ATOMIC_RELEASE);
+#elif (__GH3X2X_RAWDATA_BUFFER_NUM__ > 1)
+    g_uchGh3x2xReadRawdataBufferIndex = Gh3x2xDemoNextReadRawdataBufferIndex();
+    g_puchGh3x2xReadRawdataBuffer = g_puchGh3x2xReadRawdataBufferRing[g_uchGh3x2xReadRawdataBufferIndex];
+#endif
+}
+
+#if (__GH3X2X_RAWDATA_BUFFER_NUM__ > 1)
+/**
+ * @fn     GU8 *Gh3x2xDemoGetIdleRawdataBuffer(void)
+ *
+ * @brief  get ring buffer that next fifo read goes into, fifo prefetch reads into it while current block is
+ *         processed
+ *
+ * @attention   size is __GH3X2X_RAWDATA_BUFFER_SIZE__, no drv lib lock needed
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  pointer to idle buffer, NULL if buffer is not allocated yet or there is no idle buffer now
+ */
+GU8 *Gh3x2xDemoGetIdleRawdataBuffer(void)
+{
+#if (__GH3X2X_INT_PIPELINE_EN__)
+    /* from fifo read to push, read buffer holds the block and the other slots may be queued */
+    if (__atomic_load_n(&g_uchGh3x2xPipelineBlockRead, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+    return __atomic_load_n(&g_puchGh3x2xReadRawdataBuffer, __ATOMIC_ACQUIRE);
+#else
+    return g_puchGh3x2xReadRawdataBufferRing[Gh3x2xDemoNextReadRawdataBufferIndex()];
+#endif
+}
+#endif
+
 /**
  * @fn     void Gh3x2xInterruptModeSwitch(GU8 uchIntModeType)
  *
@@ -1725,108 +2388,1370 @@ GU8 Gh3x2xGetInterruptMode(void)
     return g_uchGh3x2xIntMode;
 }
 
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+#define GH3X2X_TIMESTAMP_Q                      (8)         /**< frame time and period are in us Q8, keeps fraction of period */
+#define GH3X2X_TIMESTAMP_PERIOD_GAIN            (8)         /**< 1/8 of frame period error of a block is corrected */
+#define GH3X2X_TIMESTAMP_PERIOD_RANGE           (16)        /**< measured frame period is kept in nominal +/- 1/16 */
+#define GH3X2X_TIMESTAMP_PHASE_GAIN             (4)         /**< 1/4 of frame phase error of a block is corrected */
+
+/// frame timing of one function
+typedef struct
+{
+    GS64 llNextUsQ;             /**< timestamp of next frame, us Q8 */
+    GS64 llLastUs;              /**< timestamp of last frame */
+    GS64 llBlockStartUs;        /**< anchor of last block, frames of current block are written after it */
+    GU32 unPeriodUsQ;           /**< frame period, us Q8, 0: function is not sampling */
+    GU32 unNominalPeriodUsQ;    /**< frame period of function sample rate, us Q8 */
+    GU16 usBlockFrameCnt;       /**< frames of current block */
+} STGh3x2xFrameTimeStamp;
+
+static STGh3x2xFrameTimeStamp g_stGh3x2xFrameTimeStamp[GH3X2X_FUNC_OFFSET_MAX];
+
+/// time of newest fifo word of block read by int process
+static GS64 g_llGh3x2xTimeStampReadAnchorUs = 0;
+
+/// time of newest fifo word of block in processing
+static GS64 g_llGh3x2xTimeStampBlockAnchorUs = 0;
+
+/// last watermark int edge and fifo words read at it, 0 words: fifo was drained without edge after it
+static GS64 g_llGh3x2xTimeStampLastEdgeUs = 0;
+static GU16 g_usGh3x2xTimeStampLastEdgeWordNum = 0;
+
+/// fifo word period measured between watermark int edges, us Q8, 0: not measured
+static GU32 g_unGh3x2xTimeStampWordPeriodUsQ = 0;
+
 /**
- * @fn     GU8 Gh3x2xDemoInterruptProcess(void)
+ * @fn     static GU8 Gh3x2xDemoTimeStampFuncOffsetGet(GU32 unFunctionID)
  *
- * @brief  Interrupt process of GH3x2x.
+ * @brief  get function offset of function id
  *
  * @attention   None
  *
- * @param[in]   None
+ * @param[in]   unFunctionID    GH3X2X_FUNCTION_XXX
  * @param[out]  None
  *
- * @return  None
+ * @return  function offset, GH3X2X_FUNC_OFFSET_MAX: no function
  */
-void Gh3x2xDemoInterruptProcess(void)
+static GU8 Gh3x2xDemoTimeStampFuncOffsetGet(GU32 unFunctionID)
 {
-    if(0 == g_uchGh3x2xInitFlag)
+    GU8 uchFunCnt;
+
+    for (uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
     {
-        EXAMPLE_LOG("[%s]:gh3x2x is not init!!!\r\n", __FUNCTION__);
-        return;
+        if (unFunctionID & (((GU32)1) << uchFunCnt))
+        {
+            break;
+        }
     }
+    return uchFunCnt;
+}
 
-    GU8 uchRet = 0;
-    GU16 usGotEvent = 0;
-    GU8 uchIntRepeatNum = 0;
-#if (__GH3X2X_CASCADE_EN__)
-    GU16 usGotSlaverEvent = 0;
-#endif
-    GU8 uchEventEx = 0;     //bit0:  0: object/no objiect   1: living/nonliving object
-                            //bit1:  0: None                1: chip0 lead on
-                            //bit2:  0: None                1: chip0 lead off
-                            //bit3:  0: None                1: chip1 lead on
-                            //bit4:  0: None                1: chip1 lead off
-
-    g_uchGh3x2xInterruptProNotFinishFlag = 1;
+/**
+ * @fn     static void Gh3x2xDemoTimeStampAnchor(GU16 usFifoWordNum, GU8 uchIsWatermarkEdge)
+ *
+ * @brief  get time of newest fifo word of block to read, from captured int edge or from now
+ *
+ * @attention   called right after fifo use count is read. At watermark edge fifo use count is just the
+ *              watermark, words over it are written after edge. Words read at last edge are the words written
+ *              from last edge to this one, which gives fifo word period
+ *
+ * @param[in]   usFifoWordNum       fifo use count
+ * @param[in]   uchIsWatermarkEdge  1: int process is run by watermark int
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoTimeStampAnchor(GU16 usFifoWordNum, GU8 uchIsWatermarkEdge)
+{
+    GS64 llNowUs = hal_gh3x2x_timestamp_now_us();
+    GS64 llEdgeUs = 0;
+    GU8 uchHasEdge = hal_gh3x2x_timestamp_int_edge_get(&llEdgeUs);     //always taken, so an old edge is never used later
+    GU16 usWatermark = GH3X2X_GetCurrentFifoWaterLine();
 
-#if (__FUNC_TYPE_ECG_ENABLE__)
-    STSoftLeadResult stLeadResult = {0, 0};
+#if (__MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    if (g_uchGh3x2xIntMode == __POLLING_INT_PROCESS_MODE__)
+    {
+        uchIsWatermarkEdge = 0;     //watermark bit is set by polling
+    }
 #endif
-
-    if(GH3X2X_DEMO_WORK_MODE_MPT == g_uchDemoWorkMode)
+    g_llGh3x2xTimeStampReadAnchorUs = llNowUs;
+    if ((0 == uchHasEdge) || (0 == uchIsWatermarkEdge))
     {
+        g_usGh3x2xTimeStampLastEdgeWordNum = 0;
         return;
     }
-
-#if __USER_DYNAMIC_DRV_BUF_EN__
-    if(0 == Gh3x2xDemoMemCheckValid())    //dynamic mem is not valid
+    if (g_usGh3x2xTimeStampLastEdgeWordNum != 0)
     {
-        EXAMPLE_LOG("[%s]Warning, dynamic mem is not valid !!!\r\n",__FUNCTION__);
-        return;
+        g_unGh3x2xTimeStampWordPeriodUsQ = (GU32)(((llEdgeUs - g_llGh3x2xTimeStampLastEdgeUs) << GH3X2X_TIMESTAMP_Q)
+                                                 / g_usGh3x2xTimeStampLastEdgeWordNum);
     }
-#endif
-
-
-
-
-#if __FUNC_TYPE_SOFT_ADT_ENABLE__
-#if (__USE_POLLING_TIMER_AS_ADT_TIMER__)&&(__POLLING_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
-    if (g_uchGh3x2xIntMode == __POLLING_INT_PROCESS_MODE__ && 1 == g_uchVirtualAdtTimerCtrlStatus && GH3X2X_GetSoftWearOffDetEn())
+    g_llGh3x2xTimeStampLastEdgeUs = llEdgeUs;
+    g_usGh3x2xTimeStampLastEdgeWordNum = usFifoWordNum;
+    if (usFifoWordNum > usWatermark)
     {
-        Gh3x2xDemoMoveDetectTimerHandler();
+        llEdgeUs += ((GS64)(usFifoWordNum - usWatermark) * g_unGh3x2xTimeStampWordPeriodUsQ) >> GH3X2X_TIMESTAMP_Q;
     }
-#endif
-#endif
+    if (llEdgeUs < llNowUs)
+    {
+        g_llGh3x2xTimeStampReadAnchorUs = llEdgeUs;
+    }
+}
 
-#if __GH_MSG_WITH_ALGO_LAYER_EN__
-        GH3X2X_PRO_MSG_SOFT_WEAR_EVEVT();
-#endif
+/**
+ * @fn     static void Gh3x2xDemoTimeStampUpdate(void)
+ *
+ * @brief  start frame timing of newly opened functions at now, clear it of closed functions
+ *
+ * @attention   called after opened functions change
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoTimeStampUpdate(void)
+{
+    GS64 llNowUs = hal_gh3x2x_timestamp_now_us();
 
-    //check "Gh3x2xDemoInterruptProcess" call is legal or not
-#if (__NORMAL_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
-    if (g_uchGh3x2xIntMode == __NORMAL_INT_PROCESS_MODE__)
+    for (GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
     {
-        if((0 == GH3X2X_GetSoftEvent())&&(0 == g_uchGh3x2xIntCallBackIsCalled))
+        STGh3x2xFrameTimeStamp *pstTimeStamp = &g_stGh3x2xFrameTimeStamp[uchFunCnt];
+
+        if ((0 == g_pstGh3x2xFrameInfo[uchFunCnt]) || (0 == (g_unDemoFuncMode & (((GU32)1) << uchFunCnt)))
+            || (0 == g_pstGh3x2xFrameInfo[uchFunCnt]->pstFunctionInfo->usSampleRate))
         {
-    #if (0 == __PLATFORM_WITHOUT_OS__)
-            EXAMPLE_LOG("InterruptProcess: plese check hal_gh3x2x_int_handler_call_back is called or not !!!\r\n");
-    #endif
-            EXAMPLE_LOG("InterruptProcess:invalid call, do not process.\r\n");
-            return;
+            memset(pstTimeStamp, 0, sizeof(STGh3x2xFrameTimeStamp));
+        }
+        else if (0 == pstTimeStamp->unPeriodUsQ)
+        {
+            pstTimeStamp->unNominalPeriodUsQ = (GU32)((((GS64)1000000) << GH3X2X_TIMESTAMP_Q)
+                                                      / g_pstGh3x2xFrameInfo[uchFunCnt]->pstFunctionInfo->usSampleRate);
+            pstTimeStamp->unPeriodUsQ = pstTimeStamp->unNominalPeriodUsQ;
+            pstTimeStamp->llNextUsQ = (llNowUs << GH3X2X_TIMESTAMP_Q) + pstTimeStamp->unPeriodUsQ;
+            pstTimeStamp->llLastUs = 0;
+            pstTimeStamp->llBlockStartUs = llNowUs;
+            pstTimeStamp->usBlockFrameCnt = 0;
         }
     }
-#endif
+}
 
-#if (__NORMAL_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
-    if (g_uchGh3x2xIntMode == __NORMAL_INT_PROCESS_MODE__)
+/**
+ * @fn     static void Gh3x2xDemoTimeStampBlockDone(void)
+ *
+ * @brief  correct frame period and phase of every function by anchor of block just processed
+ *
+ * @attention   frames of block are written from last anchor to this one, and the last one ends less than one
+ *              frame period before this anchor, so next frame is aimed at half a period after it
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoTimeStampBlockDone(void)
+{
+    GS64 llAnchorUs = g_llGh3x2xTimeStampBlockAnchorUs;
+
+    for (GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
     {
-        g_uchGh3x2xIntCallBackIsCalled = 0;
-    }  
-#endif
+        STGh3x2xFrameTimeStamp *pstTimeStamp = &g_stGh3x2xFrameTimeStamp[uchFunCnt];
+        GS64 llPeriodUsQ;
+        GS64 llRangeUsQ;
 
-    do{
-        uchRet = GH3X2X_INT_PROCESS_SUCCESS;
-        usGotEvent = 0;
-    #if __GH3X2X_CASCADE_EN__
-         usGotSlaverEvent = 0;
-    #endif
+        if ((0 == pstTimeStamp->unPeriodUsQ) || (0 == pstTimeStamp->usBlockFrameCnt)
+            || (llAnchorUs <= pstTimeStamp->llBlockStartUs))
+        {
+            continue;
+        }
+        llPeriodUsQ = ((llAnchorUs - pstTimeStamp->llBlockStartUs) << GH3X2X_TIMESTAMP_Q) / pstTimeStamp->usBlockFrameCnt;
+        llRangeUsQ = pstTimeStamp->unNominalPeriodUsQ / GH3X2X_TIMESTAMP_PERIOD_RANGE;
+        if (llPeriodUsQ > ((GS64)pstTimeStamp->unNominalPeriodUsQ + llRangeUsQ))
+        {
+            llPeriodUsQ = (GS64)pstTimeStamp->unNominalPeriodUsQ + llRangeUsQ;
+        }
+        else if (llPeriodUsQ < ((GS64)pstTimeStamp->unNominalPeriodUsQ - llRangeUsQ))
+        {
+            llPeriodUsQ = (GS64)pstTimeStamp->unNominalPeriodUsQ - llRangeUsQ;
+        }
+        pstTimeStamp->unPeriodUsQ = (GU32)((GS64)pstTimeStamp->unPeriodUsQ
+                                           + (llPeriodUsQ - (GS64)pstTimeStamp->unPeriodUsQ) / GH3X2X_TIMESTAMP_PERIOD_GAIN);
+        pstTimeStamp->llNextUsQ += ((llAnchorUs << GH3X2X_TIMESTAMP_Q) + (pstTimeStamp->unPeriodUsQ / 2)
+                                    - pstTimeStamp->llNextUsQ) / GH3X2X_TIMESTAMP_PHASE_GAIN;
+        pstTimeStamp->llBlockStartUs = llAnchorUs;
+        pstTimeStamp->usBlockFrameCnt = 0;
+    }
+}
 
-        /* Step 1: read irq status */
+/**
+ * @fn     void Gh3x2xDemoFrameTimeStampNext(const STGh3x2xFrameInfo * const pstFrameInfo)
+ *
+ * @brief  give timestamp to one decoded frame, read back by Gh3x2xDemoFrameTimeStampGet
+ *
+ * @attention   called once for every frame by frame data hook
+ *
+ * @param[in]   pstFrameInfo    decoded frame
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoFrameTimeStampNext(const STGh3x2xFrameInfo * const pstFrameInfo)
+{
+    GU8 uchFuncOffset = Gh3x2xDemoTimeStampFuncOffsetGet(pstFrameInfo->unFunctionID);
+    STGh3x2xFrameTimeStamp *pstTimeStamp;
+
+    if (uchFuncOffset >= GH3X2X_FUNC_OFFSET_MAX)
+    {
+        return;
+    }
+    pstTimeStamp = &g_stGh3x2xFrameTimeStamp[uchFuncOffset];
+    if (0 == pstTimeStamp->unPeriodUsQ)
+    {
+        return;
+    }
+    pstTimeStamp->llLastUs = pstTimeStamp->llNextUsQ >> GH3X2X_TIMESTAMP_Q;
+    pstTimeStamp->llNextUsQ += pstTimeStamp->unPeriodUsQ;
+    pstTimeStamp->usBlockFrameCnt++;
+}
+#endif
+
+/**
+ * @fn     GS64 Gh3x2xDemoFrameTimeStampGet(GU32 unFunctionID)
+ *
+ * @brief  get timestamp of last decoded frame of function
+ *
+ * @attention   only with __GH3X2X_HW_TIMESTAMP_EN__. Valid in frame hooks of the same thread; with gsensor
+ *              timestamp sync, io data hook may be called after newer frames are decoded
+ *
+ * @param[in]   unFunctionID    GH3X2X_FUNCTION_XXX, one function
+ * @param[out]  None
+ *
+ * @return  frame time in us, time base of hal_gh3x2x_timestamp_now_us, 0: function is not sampling
+ */
+GS64 Gh3x2xDemoFrameTimeStampGet(GU32 unFunctionID)
+{
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+    GU8 uchFuncOffset = Gh3x2xDemoTimeStampFuncOffsetGet(unFunctionID);
+
+    if (uchFuncOffset < GH3X2X_FUNC_OFFSET_MAX)
+    {
+        return g_stGh3x2xFrameTimeStamp[uchFuncOffset].llLastUs;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @fn     static void Gh3x2xDemoFifoBlockProcess(GU8 *puchRawdata, GU16 usRawdataLen)
+ *
+ * @brief  fetch gsensor/cap/temp data and run algorithm on one fifo block
+ *
+ * @attention   None
+ *
+ * @param[in]   puchRawdata     fifo data read at fifo watermark
+ * @param[in]   usRawdataLen    fifo data len
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoFifoBlockProcess(GU8 *puchRawdata, GU16 usRawdataLen)
+{
+#if __GS_NONSYNC_READ_EN__
+    GU16 usGsensorNeedPointNum;
+    STGsensorRawdata *pstGsensorResample;
+#endif
+    GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_GSENSOR);
+    if (GH3X2X_GetGsensorEnableFlag())
+    {
+    #if (0 == __GS_TIMESTAMP_READ_EN__)
+    #if (__FUNC_TYPE_SOFT_ADT_ENABLE__)
+        if (g_uchVirtualAdtTimerCtrlStatus == 0)
+    #endif
+        {
+            hal_gsensor_drv_get_fifo_data(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__, &gsensor_soft_fifo_buffer_index);        
+        #if !(__GS_INGEST_BY_HAL__)
+            Gh3x2x_NormalizeGsensorSensitivity(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__ ,gsensor_soft_fifo_buffer_index);
+        #endif
+        }
+    #endif
+    }
+    /*extra step: get cap and temp data from other sensor*/
+    #if __CAP_ENABLE__
+    if (GH3X2X_GetCapEnableFlag())
+    {
+        hal_cap_drv_get_fifo_data(cap_soft_fifo_buffer, &cap_soft_fifo_buffer_index);
+    }
+    #endif
+    #if __TEMP_ENABLE__
+    if (GH3X2X_GetTempEnableFlag())
+    {
+        hal_temp_drv_get_fifo_data(temp_soft_fifo_buffer, &temp_soft_fifo_buffer_index);
+    }
+    #endif
+    GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_GSENSOR);
+    /* Step 8: algorithm process*/
+    #if __GH3X2X_MEM_POOL_CHECK_EN__
+    Gh3x2xCheckMemPollBeforeAlgoCal();
+    #endif
+
+#ifdef GOODIX_DEMO_PLANFORM
+    if (((GH3X2X_DEMO_WORK_MODE_MCU_ONLINE == g_uchDemoWorkMode) ||\
+                (GH3X2X_DEMO_WORK_MODE_PASS_THROUGH == g_uchDemoWorkMode) ||\
+                (GH3X2X_DEMO_WORK_MODE_APP == g_uchDemoWorkMode) ||\
+                (GH3X2X_DEMO_WORK_MODE_EVK == g_uchDemoWorkMode)) &&\
+                ((g_usDumpMode & 0x3) == 0))
+#endif
+    {
+        GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_FUNC_PROCESS);
+    #if __GS_NONSYNC_READ_EN__
+        usGsensorNeedPointNum = Gh3x2xGetGsensorNeedPointNum(gsensor_soft_fifo_buffer_index, puchRawdata, usRawdataLen);
+        pstGsensorResample = Gh3x2xNonSyncGsensorResample(gsensor_soft_fifo_buffer_index, usGsensorNeedPointNum);
+        Gh3x2xDemoFunctionProcess(puchRawdata,usRawdataLen, pstGsensorResample, usGsensorNeedPointNum,
+                                        cap_soft_fifo_buffer,cap_soft_fifo_buffer_index,temp_soft_fifo_buffer,temp_soft_fifo_buffer_index);
+
+
+        for(GU16 usPointCnt = 0; usPointCnt < usGsensorNeedPointNum; usPointCnt++)
+        {
+            EXAMPLE_LOG("[Gsensor show]x = %d,y = %d, z = %d\r\n",pstGsensorResample[usPointCnt].sXAxisVal,pstGsensorResample[usPointCnt].sYAxisVal,pstGsensorResample[usPointCnt].sZAxisVal);
+        }
+    #else
+        Gh3x2xDemoFunctionProcess(puchRawdata,usRawdataLen, gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__, gsensor_soft_fifo_buffer_index,
+                                        cap_soft_fifo_buffer,cap_soft_fifo_buffer_index,temp_soft_fifo_buffer,temp_soft_fifo_buffer_index);
+    #endif
+        GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_FUNC_PROCESS);
+    #if (__GH3X2X_HW_TIMESTAMP_EN__)
+        Gh3x2xDemoTimeStampBlockDone();
+    #endif
+        gh3x2x_fifo_block_done_hook_func();
+    }
+    #if __GH3X2X_MEM_POOL_CHECK_EN__
+    Gh3x2xUpdataMemPollChkSumAfterAlgoCal();
+    #endif
+    GH3X2X_STAGE_PROF_DONE(GH3X2X_STAGE_BLOCK_MASK);
+}
+
+#if (__GH3X2X_INT_PIPELINE_EN__)
+/**
+ * @fn     static void Gh3x2xDemoPipelinePush(void)
+ *
+ * @brief  queue fifo block in read buffer for processing thread, read buffer moves to next free slot
+ *
+ * @attention   one slot is always kept for next fifo read, block is dropped and counted when the others are full
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoPipelinePush(void)
+{
+    GU32 unDepth = g_unGh3x2xPipelineHead - __atomic_load_n(&g_unGh3x2xPipelineTail, __ATOMIC_ACQUIRE);
+    STGh3x2xPipelineBlock *pstBlock = &g_stGh3x2xPipelineBlock[g_unGh3x2xPipelineHead % __GH3X2X_RAWDATA_BUFFER_NUM__];
+
+    if (unDepth >= (__GH3X2X_RAWDATA_BUFFER_NUM__ - 1))
+    {
+        g_stGh3x2xPipelineStat.unOverrunCnt++;
+    }
+    else
+    {
+        pstBlock->puchRawdata = g_puchGh3x2xReadRawdataBufferRing[g_unGh3x2xPipelineHead % __GH3X2X_RAWDATA_BUFFER_NUM__];
+        pstBlock->usRawdataLen = g_uchGh3x2xPipelineBlockRead ? g_usGh3x2xReadRawdataLen : 0;
+        pstBlock->unGeneration = __atomic_load_n(&g_unGh3x2xPipelineGeneration, __ATOMIC_RELAXED);
+    #if (__GH3X2X_HW_TIMESTAMP_EN__)
+        pstBlock->llTimeStampUs = g_llGh3x2xTimeStampReadAnchorUs;
+    #endif
+        __atomic_store_n(&g_unGh3x2xPipelineHead, g_unGh3x2xPipelineHead + 1, __ATOMIC_RELEASE);
+        g_stGh3x2xPipelineStat.unPushCnt++;
+        if ((unDepth + 1) > g_stGh3x2xPipelineStat.usMaxDepth)
+        {
+            g_stGh3x2xPipelineStat.usMaxDepth = (GU16)(unDepth + 1);
+        }
+        hal_gh3x2x_pipeline_notify();
+    }
+
+    /* block belongs to processing thread now, lead/agc of a repeated int process must not touch it; read buffer
+       is published before it is marked idle, fifo prefetch takes it without drv lib lock */
+    g_usGh3x2xReadRawdataLen = 0;
+    g_uchGh3x2xReadRawdataBufferIndex = g_unGh3x2xPipelineHead % __GH3X2X_RAWDATA_BUFFER_NUM__;
+    __atomic_store_n(&g_puchGh3x2xReadRawdataBuffer, g_puchGh3x2xReadRawdataBufferRing[g_uchGh3x2xReadRawdataBufferIndex],
+                     __ATOMIC_RELEASE);
+    __atomic_store_n(&g_uchGh3x2xPipelineBlockRead, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @fn     static void Gh3x2xDemoPipelineDropQueued(void)
+ *
+ * @brief  blocks queued before now are dropped by processing thread
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoPipelineDropQueued(void)
+{
+    __atomic_fetch_add(&g_unGh3x2xPipelineGeneration, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @fn     void Gh3x2xDemoPipelineProcess(void)
+ *
+ * @brief  process all fifo blocks queued by int process: gsensor/cap/temp fetch and algorithm
+ *
+ * @attention   only called by processing thread, it is the single consumer of ring. Drv lib lock is taken per
+ *              block, int process gets in between blocks
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoPipelineProcess(void)
+{
+    GU32 unTail = g_unGh3x2xPipelineTail;
+
+    while (unTail != __atomic_load_n(&g_unGh3x2xPipelineHead, __ATOMIC_ACQUIRE))
+    {
+        STGh3x2xPipelineBlock *pstBlock = &g_stGh3x2xPipelineBlock[unTail % __GH3X2X_RAWDATA_BUFFER_NUM__];
+
+        GH3X2X_DRV_LOCK();
+        if (pstBlock->unGeneration == __atomic_load_n(&g_unGh3x2xPipelineGeneration, __ATOMIC_RELAXED))
+        {
+        #if (__GH3X2X_HW_TIMESTAMP_EN__)
+            g_llGh3x2xTimeStampBlockAnchorUs = pstBlock->llTimeStampUs;
+        #endif
+            Gh3x2xDemoFifoBlockProcess(pstBlock->puchRawdata, pstBlock->usRawdataLen);
+            g_stGh3x2xPipelineStat.unPopCnt++;
+        }
+        else
+        {
+            g_stGh3x2xPipelineStat.unStaleCnt++;
+        }
+        unTail++;
+        __atomic_store_n(&g_unGh3x2xPipelineTail, unTail, __ATOMIC_RELEASE);    //slot is free for int process
+        GH3X2X_DRV_UNLOCK();
+    }
+}
+
+/**
+ * @fn     void Gh3x2xDemoPipelineGetStat(STGh3x2xPipelineStat *pstStat)
+ *
+ * @brief  get statistics of fifo block ring
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  pstStat     pointer to statistics
+ *
+ * @return  None
+ */
+void Gh3x2xDemoPipelineGetStat(STGh3x2xPipelineStat *pstStat)
+{
+    *pstStat = g_stGh3x2xPipelineStat;
+    pstStat->usDepth = (GU16)(__atomic_load_n(&g_unGh3x2xPipelineHead, __ATOMIC_ACQUIRE)
+                              - __atomic_load_n(&g_unGh3x2xPipelineTail, __ATOMIC_ACQUIRE));
+}
+#endif
+
+#if (__POLLING_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+#define GH3X2X_POLLING_RATE_EWMA_SHIFT          (3)         /**< weight of new fill rate sample is 1/8 */
+#define GH3X2X_POLLING_PHASE_GAIN_SHIFT         (1)         /**< half of phase error is corrected per poll */
+
+/// nominal polling period in us, whole frames of slowest opened function, 0: polling stopped
+static GU32 g_unGh3x2xPollingPeriodUs = 0;
+
+/// fifo fill rate in words per second, seeded from function info and tracked by polls
+static GU32 g_unGh3x2xPollingWordRate = 0;
+
+/// fifo use count read by last polling pass
+static GU16 g_usGh3x2xPollingFifoWordNum = 0;
+
+#if (__MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+/// ints from int pin since last int rate check
+static GU32 g_unGh3x2xPollingIntCnt = 0;
+
+/**
+ * @fn     static void Gh3x2xDemoIntModeAutoSwitch(GU8 uchIntMode)
+ *
+ * @brief  switch between int pin and polling at runtime in mix mode, chip config is kept
+ *
+ * @attention   None
+ *
+ * @param[in]   uchIntMode      __NORMAL_INT_PROCESS_MODE__ or __POLLING_INT_PROCESS_MODE__
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoIntModeAutoSwitch(GU8 uchIntMode)
+{
+    EXAMPLE_LOG("[%s]:int process switch to = %d, fill rate = %d words/s\r\n", __FUNCTION__, (int)uchIntMode, (int)g_unGh3x2xPollingWordRate);
+    if (__NORMAL_INT_PROCESS_MODE__ == uchIntMode)
+    {
+        hal_gh3x2x_int_init();
+    }
+    g_unGh3x2xPollingIntCnt = 0;
+    g_uchGh3x2xIntMode = uchIntMode;
+}
+#endif
+
+/**
+ * @fn     static void Gh3x2xDemoPollingUpdate(void)
+ *
+ * @brief  align polling period to frame period of slowest opened function and (re)start polling timer
+ *
+ * @attention   called after opened functions change
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoPollingUpdate(void)
+{
+    GU16 usMinSampleRate = 0;
+    GU32 unWordRate = 0;
+    GU32 unFramePeriodUs;
+    GU32 unFrameNum;
+
+    for (GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
+    {
+        if (g_pstGh3x2xFrameInfo[uchFunCnt] && (g_unDemoFuncMode & (((GU32)1) << uchFunCnt)))
+        {
+            GU16 usSampleRate = g_pstGh3x2xFrameInfo[uchFunCnt]->pstFunctionInfo->usSampleRate;
+            GU32 unFuncWordRate = (GU32)usSampleRate * g_pstGh3x2xFrameInfo[uchFunCnt]->pstFunctionInfo->uchChnlNum;
+
+            if (usSampleRate && ((0 == usMinSampleRate) || (usSampleRate < usMinSampleRate)))
+            {
+                usMinSampleRate = usSampleRate;
+            }
+            if (unWordRate < unFuncWordRate)
+            {
+                unWordRate = unFuncWordRate;
+            }
+        }
+    }
+
+    if (0 == usMinSampleRate)
+    {
+        g_unGh3x2xPollingPeriodUs = 0;
+        hal_gh3x2x_polling_timer_stop();
+        return;
+    }
+    unFramePeriodUs = 1000000 / usMinSampleRate;
+    unFrameNum = (__GH3X2X_POLLING_PERIOD_MS__ * 1000 + unFramePeriodUs / 2) / unFramePeriodUs;
+    if (0 == unFrameNum)
+    {
+        unFrameNum = 1;
+    }
+    g_unGh3x2xPollingPeriodUs = unFrameNum * 1000000 / usMinSampleRate;
+    g_unGh3x2xPollingWordRate = unWordRate;
+#if (__MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    g_unGh3x2xPollingIntCnt = 0;
+    if (__NORMAL_INT_PROCESS_MODE__ == g_uchGh3x2xIntMode)
+    {
+        hal_gh3x2x_polling_timer_start(__GH3X2X_POLLING_MIX_CHECK_MS__ * 1000);
+    }
+    else
+#endif
+    {
+        hal_gh3x2x_polling_timer_start(g_unGh3x2xPollingPeriodUs);
+    }
+    EXAMPLE_LOG("[%s]:polling period = %d us, %d frames of %d Hz\r\n", __FUNCTION__,
+                (int)g_unGh3x2xPollingPeriodUs, (int)unFrameNum, (int)usMinSampleRate);
+}
+
+/**
+ * @fn     GU32 Gh3x2xDemoPollingProcess(GU32 unElapsedUs)
+ *
+ * @brief  process of polling timer expiry: polling pass of int process, or int rate check in mix mode
+ *
+ * @attention   only called by polling work. fill rate is tracked from words of every poll, next poll
+ *              is moved by half of the time the fifo is ahead of or behind expected fill, so polls stay
+ *              locked to chip sample clock instead of drifting against host clock
+ *
+ * @param[in]   unElapsedUs     time since last call
+ * @param[out]  None
+ *
+ * @return  delay in us to next call, 0: stop polling
+ */
+GU32 Gh3x2xDemoPollingProcess(GU32 unElapsedUs)
+{
+    GU32 unWordNum;
+    GU32 unExpectWordNum;
+    GS32 nPhaseErrUs;
+    GS32 nPhaseErrMaxUs = (GS32)(g_unGh3x2xPollingPeriodUs / 4);
+
+    if (0 == g_unGh3x2xPollingPeriodUs)
+    {
+        return 0;
+    }
+#if (__MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    if (__NORMAL_INT_PROCESS_MODE__ == g_uchGh3x2xIntMode)
+    {
+        GU32 unIntCnt = g_unGh3x2xPollingIntCnt;
+
+        g_unGh3x2xPollingIntCnt = 0;
+        if (unIntCnt && ((unElapsedUs / unIntCnt) < g_unGh3x2xPollingPeriodUs))
+        {
+            Gh3x2xDemoIntModeAutoSwitch(__POLLING_INT_PROCESS_MODE__);     //int comes more often than polls
+            return g_unGh3x2xPollingPeriodUs;
+        }
+        return __GH3X2X_POLLING_MIX_CHECK_MS__ * 1000;
+    }
+#endif
+
+    g_usGh3x2xPollingFifoWordNum = 0;
+    Gh3x2xDemoInterruptProcess();
+    unWordNum = g_usGh3x2xPollingFifoWordNum;
+    if (unElapsedUs)
+    {
+        GU32 unWordRate = (GU32)((uint64_t)unWordNum * 1000000 / unElapsedUs);
+        g_unGh3x2xPollingWordRate = (GU32)((GS32)g_unGh3x2xPollingWordRate
+                                    + (((GS32)unWordRate - (GS32)g_unGh3x2xPollingWordRate) / (1 << GH3X2X_POLLING_RATE_EWMA_SHIFT)));
+    }
+    if (0 == g_unGh3x2xPollingWordRate)
+    {
+        return g_unGh3x2xPollingPeriodUs;
+    }
+
+#if (__MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    if (((uint64_t)GH3X2X_GetCurrentFifoWaterLine() * 1000000 / g_unGh3x2xPollingWordRate) > ((uint64_t)g_unGh3x2xPollingPeriodUs * 2))
+    {
+        Gh3x2xDemoIntModeAutoSwitch(__NORMAL_INT_PROCESS_MODE__);      //watermark int is rarer than polls
+        return __GH3X2X_POLLING_MIX_CHECK_MS__ * 1000;
+    }
+#endif
+
+    unExpectWordNum = (GU32)((uint64_t)g_unGh3x2xPollingWordRate * g_unGh3x2xPollingPeriodUs / 1000000);
+    nPhaseErrUs = (GS32)(((int64_t)unExpectWordNum - (int64_t)unWordNum) * 1000000 / g_unGh3x2xPollingWordRate);
+    nPhaseErrUs /= (1 << GH3X2X_POLLING_PHASE_GAIN_SHIFT);
+    if (nPhaseErrUs > nPhaseErrMaxUs)
+    {
+        nPhaseErrUs = nPhaseErrMaxUs;
+    }
+    else if (nPhaseErrUs < -nPhaseErrMaxUs)
+    {
+        nPhaseErrUs = -nPhaseErrMaxUs;
+    }
+    return (GU32)((GS32)g_unGh3x2xPollingPeriodUs + nPhaseErrUs);
+}
+#endif
+
+#if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+#define GH3X2X_CHIP_RESET_RECOVERY_TRY_CNT      (5)         /**< max times of reset + reg config reload */
+#define GH3X2X_CHIP_RESET_RECOVERY_DELAY_MS     (30)        /**< wait after reset before reg config reload */
+
+/// step of chip reset recovery
+typedef enum
+{
+    GH3X2X_CHIP_RESET_RECOVERY_IDLE = 0,
+    GH3X2X_CHIP_RESET_RECOVERY_RESET,       /**< reset chip */
+    GH3X2X_CHIP_RESET_RECOVERY_INIT,        /**< stop sampling and reload reg config */
+    GH3X2X_CHIP_RESET_RECOVERY_RESTART,     /**< restore sampling of functions before chip reset */
+} EMGh3x2xChipResetRecoveryState;
+
+static volatile EMGh3x2xChipResetRecoveryState g_emGh3x2xChipResetRecoveryState = GH3X2X_CHIP_RESET_RECOVERY_IDLE;
+static GU8 g_uchGh3x2xChipResetRecoveryTryCnt = 0;
+static GU32 g_unGh3x2xDemoFuncModeBeforeChipReset = 0;
+
+/// int or soft event came in during recovery, int process is called once after recovery
+static GU8 g_uchGh3x2xChipResetRecoveryIntPending = 0;
+
+#define GH3X2X_CHIP_RESET_RECOVERY_LATCH_NUM    (4)         /**< max sampling control calls latched during recovery */
+
+/// sampling control call of other thread between recovery steps, replayed after recovery
+typedef struct
+{
+    GU32 unFuncMode;
+    EMUprotocolParseCmdType emSwitch;
+    GU8 uchWithAlgo;        /**< 1: Gh3x2xDemoStartSampling/Gh3x2xDemoStopSampling   0: Gh3x2xDemoSamplingControl */
+} STGh3x2xChipResetRecoveryLatch;
+
+static STGh3x2xChipResetRecoveryLatch g_stGh3x2xChipResetRecoveryLatch[GH3X2X_CHIP_RESET_RECOVERY_LATCH_NUM];
+static GU8 g_uchGh3x2xChipResetRecoveryLatchNum = 0;
+
+/// recovery step is running, sampling control calls in it are steps of recovery itself
+static GU8 g_uchGh3x2xChipResetRecoveryStepRunning = 0;
+
+/**
+ * @fn     static void Gh3x2xDemoChipResetRecoveryStart(void)
+ *
+ * @brief  start chip reset recovery, steps run in recovery work after int process returns
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoChipResetRecoveryStart(void)
+{
+    EXAMPLE_LOG("Gh3x2xDemoInterruptProcess:start chip reset recovery...\r\n");
+    GH3x2x_SetChipResetRecoveringFlag(1);
+    g_unGh3x2xDemoFuncModeBeforeChipReset = g_unDemoFuncMode;
+    g_uchGh3x2xChipResetRecoveryTryCnt = GH3X2X_CHIP_RESET_RECOVERY_TRY_CNT;
+    g_emGh3x2xChipResetRecoveryState = GH3X2X_CHIP_RESET_RECOVERY_RESET;
+    hal_gh3x2x_chip_reset_recovery_start();
+}
+
+/**
+ * @fn     static GU8 Gh3x2xDemoChipResetRecoveryLatch(GU32 unFuncMode, EMUprotocolParseCmdType emSwitch, GU8 uchWithAlgo)
+ *
+ * @brief  latch sampling control that comes while chip is being reset, RESTART step would overwrite it
+ *
+ * @attention   drv lib lock is held by caller
+ *
+ * @param[in]   unFuncMode      function that will be started or stopped
+ * @param[in]   emSwitch        stop/start sampling
+ * @param[in]   uchWithAlgo     1: call of Gh3x2xDemoStartSampling/Gh3x2xDemoStopSampling  0: Gh3x2xDemoSamplingControl
+ * @param[out]  None
+ *
+ * @return  1: latched(or dropped when latch is full), caller must not touch chip  0: no recovery, go on
+ */
+static GU8 Gh3x2xDemoChipResetRecoveryLatch(GU32 unFuncMode, EMUprotocolParseCmdType emSwitch, GU8 uchWithAlgo)
+{
+    if ((GH3X2X_CHIP_RESET_RECOVERY_IDLE == g_emGh3x2xChipResetRecoveryState) || g_uchGh3x2xChipResetRecoveryStepRunning)
+    {
+        return 0;
+    }
+    if (g_uchGh3x2xChipResetRecoveryLatchNum < GH3X2X_CHIP_RESET_RECOVERY_LATCH_NUM)
+    {
+        STGh3x2xChipResetRecoveryLatch *pstLatch = &g_stGh3x2xChipResetRecoveryLatch[g_uchGh3x2xChipResetRecoveryLatchNum];
+
+        pstLatch->unFuncMode = unFuncMode;
+        pstLatch->emSwitch = emSwitch;
+        pstLatch->uchWithAlgo = uchWithAlgo;
+        g_uchGh3x2xChipResetRecoveryLatchNum++;
+        EXAMPLE_LOG("[%s]chip reset recovery is running, cmd %d of func 0x%X is done after it\r\n", __FUNCTION__,
+                    (int)emSwitch, (int)unFuncMode);
+    }
+    else
+    {
+        EXAMPLE_LOG("[%s]chip reset recovery is running and latch is full, cmd %d of func 0x%X is dropped!!!\r\n",
+                    __FUNCTION__, (int)emSwitch, (int)unFuncMode);
+    }
+    return 1;
+}
+
+/**
+ * @fn     static void Gh3x2xDemoChipResetRecoveryReplay(void)
+ *
+ * @brief  replay sampling control latched during recovery, in call order
+ *
+ * @attention   recovery is idle now, so calls go to chip
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoChipResetRecoveryReplay(void)
+{
+    for (GU8 uchLatchCnt = 0; uchLatchCnt < g_uchGh3x2xChipResetRecoveryLatchNum; uchLatchCnt++)
+    {
+        STGh3x2xChipResetRecoveryLatch *pstLatch = &g_stGh3x2xChipResetRecoveryLatch[uchLatchCnt];
+
+        if (0 == pstLatch->uchWithAlgo)
+        {
+            Gh3x2xDemoSamplingControl(pstLatch->unFuncMode, pstLatch->emSwitch);
+        }
+        else if (UPROTOCOL_CMD_START == pstLatch->emSwitch)
+        {
+            Gh3x2xDemoStartSampling(pstLatch->unFuncMode);
+        }
+        else
+        {
+            Gh3x2xDemoStopSampling(pstLatch->unFuncMode);
+        }
+    }
+    g_uchGh3x2xChipResetRecoveryLatchNum = 0;
+}
+
+/**
+ * @fn     static GS32 Gh3x2xDemoChipResetRecoveryStepRun(void)
+ *
+ * @brief  body of Gh3x2xDemoChipResetRecoveryStep
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  delay in ms before next step, < 0: recovery is done
+ */
+static GS32 Gh3x2xDemoChipResetRecoveryStepRun(void)
+{
+    GS8 schret;
+
+    switch (g_emGh3x2xChipResetRecoveryState)
+    {
+    case GH3X2X_CHIP_RESET_RECOVERY_RESET:
+        GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_CHIP_RESET);
+    #if __SUPPORT_HARD_RESET_CONFIG__
+        GH3X2X_HardReset();
+    #else
+        GH3X2X_SoftReset();
+    #endif
+        g_emGh3x2xChipResetRecoveryState = GH3X2X_CHIP_RESET_RECOVERY_INIT;
+        return GH3X2X_CHIP_RESET_RECOVERY_DELAY_MS;
+
+    case GH3X2X_CHIP_RESET_RECOVERY_INIT:
+        GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_CHIP_RESET);
+        Gh3x2xDemoStopSampling(g_unDemoFuncMode);
+        schret = Gh3x2xDemoLoadRegCfg(g_stGh3x2xCfgListArr+g_uchGh3x2xRegCfgArrIndex, "reset recovery");
+        g_uchGh3x2xChipResetRecoveryTryCnt --;
+        if (GH3X2X_RET_OK == schret)
+        {
+            EXAMPLE_LOG("Gh3x2xDemoInterruptProcess:recovery init success\r\n");
+            g_emGh3x2xChipResetRecoveryState = GH3X2X_CHIP_RESET_RECOVERY_RESTART;
+        }
+        else
+        {
+            EXAMPLE_LOG("Gh3x2xDemoInterruptProcess:recovery init fail, error code: %d\r\n", schret);
+            g_emGh3x2xChipResetRecoveryState = (g_uchGh3x2xChipResetRecoveryTryCnt > 0) ? GH3X2X_CHIP_RESET_RECOVERY_RESET
+                                                                                         : GH3X2X_CHIP_RESET_RECOVERY_RESTART;
+        }
+        return 0;
+
+    case GH3X2X_CHIP_RESET_RECOVERY_RESTART:
+        GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_CHIP_RESET);
+        GH3X2X_EnterLowPowerMode();
+    #if __GH3X2X_CASCADE_EN__
+        GH3X2X_CascadeOperationSlaverChip();
+        GH3X2X_EnterLowPowerMode();
+        GH3X2X_CascadeOperationMasterChip();
+    #endif
+
+    #if (__SUPPORT_ENGINEERING_MODE__)
+        if(1 == g_uchEngineeringModeStatus)
+        {
+            Gh3x2xDemoStartSamplingForEngineeringMode(g_unGh3x2xDemoFuncModeBeforeChipReset, g_uchGh3x2xRegCfgArrIndex, g_pstSampleParaGroup, g_uchEngineeringModeSampleParaGroupNum);
+        }
+        else
+    #endif
+        {
+            Gh3x2xDemoStartSampling(g_unGh3x2xDemoFuncModeBeforeChipReset);
+        }
+        GH3x2x_SetChipResetRecoveringFlag(0);
+        g_emGh3x2xChipResetRecoveryState = GH3X2X_CHIP_RESET_RECOVERY_IDLE;
+        GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_OTHER);
+        return -1;
+
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @fn     GS32 Gh3x2xDemoChipResetRecoveryStep(void)
+ *
+ * @brief  run one step of chip reset recovery: reset, reg config reload(with retry), restore sampling
+ *
+ * @attention   only called by chip reset recovery work. Sampling control of other threads between steps is
+ *              latched and replayed when recovery is done
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  delay in ms before next step, < 0: recovery is done
+ */
+GS32 Gh3x2xDemoChipResetRecoveryStep(void)
+{
+    GS32 nDelayMs;
+
+    g_uchGh3x2xChipResetRecoveryStepRunning = 1;
+    nDelayMs = Gh3x2xDemoChipResetRecoveryStepRun();
+    g_uchGh3x2xChipResetRecoveryStepRunning = 0;
+    if (nDelayMs < 0)
+    {
+        Gh3x2xDemoChipResetRecoveryReplay();
+        if (g_uchGh3x2xChipResetRecoveryIntPending)
+        {
+            g_uchGh3x2xChipResetRecoveryIntPending = 0;
+            Gh3x2xDemoInterruptProcess();
+        }
+    }
+    return nDelayMs;
+}
+#endif
+
+/**
+ * @fn     static void Gh3x2xDemoIntFifoRead(GU16 usGotEvent, GU8 uchIsForceRead)
+ *
+ * @brief  read gh3x2x fifo data of one int process pass
+ *
+ * @attention   drv lib lock is held by caller, it clears force/try read fifo soft events
+ *
+ * @param[in]   usGotEvent       irq events of the pass
+ *              uchIsForceRead   1: read even if fifo data is less than water line
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoIntFifoRead(GU16 usGotEvent, GU8 uchIsForceRead)
+{
+    GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_FIFO_CNT);
+    GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_FIFO_READ);
+#if (__GH3X2X_CASCADE_CONCURRENT_READ_EN__)
+    GU16 usFifoByteNum = 0;
+    GU16 usFifoByteNumSlaver = 0;
+    if (GH3X2X_CascadeGetEcgEnFlag())
+    {
+        Gh3x2xCascadeFifoByteNumRead(&usFifoByteNum, &usFifoByteNumSlaver);   //both chips at the same time
+    }
+    else
+    {
+        usFifoByteNum = ((GU16)4)*GH3X2X_ReadReg(GH3X2X_INT_FIFO_UR_REG_ADDR);
+    }
+#else
+    GU16 usFifoByteNum = ((GU16)4)*GH3X2X_ReadReg(GH3X2X_INT_FIFO_UR_REG_ADDR); //read fifo use
+#if (__GH3X2X_CASCADE_EN__)
+    //vTaskDelay(5);
+    GU16 usFifoByteNumSlaver = 0;
+    if (GH3X2X_CascadeGetEcgEnFlag())
+    {
+        GH3X2X_CascadeOperationSlaverChip();
+        usFifoByteNumSlaver = ((GU16)4)*GH3X2X_ReadReg(GH3X2X_INT_FIFO_UR_REG_ADDR);
+        GH3X2X_CascadeOperationMasterChip();
+    }
+
+#endif
+#endif
+#if (__POLLING_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    g_usGh3x2xPollingFifoWordNum = usFifoByteNum / 4;
+#endif
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+    Gh3x2xDemoTimeStampAnchor(usFifoByteNum / 4, (usGotEvent & GH3X2X_IRQ_MSK_FIFO_WATERMARK_BIT) ? 1 : 0);
+#endif
+#if (__NORMAL_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    if (g_uchGh3x2xIntMode == __NORMAL_INT_PROCESS_MODE__)
+    {
+        if(0 == uchIsForceRead)
+        {
+            if(usFifoByteNum < ((GU16)4)*GH3X2X_GetCurrentFifoWaterLine())  //data is too less
+            {
+                usFifoByteNum = 0;   //no need read
+            }
+        }
+    }
+#endif
+
+    GH3X2X_ClearSoftEvent(GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO|GH3X2X_SOFT_EVENT_NEED_TRY_READ_FIFO);
+    g_usGh3x2xReadRawdataLen = 0;
+    if (usFifoByteNum != 0)
+    {
+        GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_FIFO_READ);
+        Gh3x2xDemoSwitchReadRawdataBuffer();
+    #if (__DRIVER_LIB_MODE__ == __DRV_LIB_WITH_ALGO__)
+        GH3X2X_TimestampSyncSetPpgIntFlag(1);
+    #endif
+    #if !(__GH3X2X_CASCADE_EN__)
+        if (GH3X2X_RET_READ_FIFO_CONTINUE == GH3X2X_ReadFifodata(g_puchGh3x2xReadRawdataBuffer, &g_usGh3x2xReadRawdataLen, usFifoByteNum))
+        {
+            GH3X2X_SetSoftEvent(GH3X2X_SOFT_EVENT_NEED_TRY_READ_FIFO);
+        }
+    #else
+        if (GH3X2X_CascadeGetEcgEnFlag())
+        {
+            //EXAMPLE_LOG("Master fifo:%d  Slaver Fifo:%d CurrentFifoWaterLine:%d\r\n", usFifoByteNum/4, usFifoByteNumSlaver/4, GH3X2X_GetCurrentFifoWaterLine());
+            if (usFifoByteNum > usFifoByteNumSlaver)
+            {
+                usFifoByteNum = usFifoByteNumSlaver;
+            }
+            if (usFifoByteNum > __GH3X2X_RAWDATA_SLAVE_BUFFER_SIZE__)
+            {
+                usFifoByteNum = __GH3X2X_RAWDATA_SLAVE_BUFFER_SIZE__;
+            }
+        #if (__GH3X2X_CASCADE_CONCURRENT_READ_EN__)
+            Gh3x2xCascadeFifoPrefetch(usFifoByteNum);   //drain both fifos at the same time, drv lib aligns them from ram
+        #endif
+            if (GH3X2X_RET_READ_FIFO_CONTINUE == GH3X2X_CascadeReadFifodata(g_puchGh3x2xReadRawdataBuffer,g_puchGh3x2xReadRawdataBufferSlaveChip, &g_usGh3x2xReadRawdataLen ,usFifoByteNum, 0x08))
+            {
+                GH3X2X_SetSoftEvent(GH3X2X_SOFT_EVENT_NEED_TRY_READ_FIFO);
+            }
+        }
+
+        else
+        {
+            if (GH3X2X_RET_READ_FIFO_CONTINUE == GH3X2X_ReadFifodata(g_puchGh3x2xReadRawdataBuffer, &g_usGh3x2xReadRawdataLen, usFifoByteNum))
+            {
+                GH3X2X_SetSoftEvent(GH3X2X_SOFT_EVENT_NEED_TRY_READ_FIFO);
+            }
+        }
+    #endif
+    #if (__GH3X2X_INT_LATENCY_MEASURE_EN__)
+        Gh3x2xIntLatencyFifoDataReady();
+    #endif
+    #if (__GH3X2X_FIFO_WM_ADAPTIVE_EN__)
+        if (g_uchGh3x2xFifoWmAdaptiveDirty)
+        {
+            Gh3x2xDemoFifoWmAdaptiveApply();    //fifo is just drained
+        }
+    #endif
+        GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_FIFO_READ);
+        GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_PROCESS);
+        GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_PROTOCOL);
+    #if ((__SUPPORT_PROTOCOL_ANALYZE__)||(__SUPPORT_ALGO_INPUT_OUTPUT_DATA_HOOK_CONFIG__))
+    #if (__SUPPORT_ELECTRODE_WEAR_STATUS_DUMP__)
+        GH3X2X_ReadElectrodeWearDumpData();
+    #endif
+        GH3X2X_RecordDumpData();
+    #endif
+        GH3X2X_RecordTiaGainInfo();
+        GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_PROTOCOL);
+    }
+}
+
+/**
+ * @fn     static GU16 Gh3x2xDemoIntRawdataHandle(GU16 usGotEvent, GU16 usGotSlaverEvent, GU8 *puchEventEx)
+ *
+ * @brief  ecg calibration, soft lead off, soft agc and fifo package send of rawdata just read
+ *
+ * @attention   drv lib lock is held by caller
+ *
+ * @param[in]   usGotEvent         irq events of the pass
+ *              usGotSlaverEvent   irq events of slaver chip(cascade only)
+ * @param[out]  puchEventEx        extra event bits
+ *
+ * @return  irq events after soft lead off process
+ */
+static GU16 Gh3x2xDemoIntRawdataHandle(GU16 usGotEvent, GU16 usGotSlaverEvent, GU8 *puchEventEx)
+{
+#if (__FUNC_TYPE_ECG_ENABLE__)
+    STSoftLeadResult stLeadResult = {0, 0};
+#endif
+
+#if (__FUNC_TYPE_ECG_ENABLE__)
+    /* extra step: ECG Gain calibration*/
+    GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_ECG_CALI);
+    #if !(__GH3X2X_CASCADE_EN__)
+    GH3X2X_CalibrateECGGain(g_puchGh3x2xReadRawdataBuffer,g_usGh3x2xReadRawdataLen);
+    #else
+    if (GH3X2X_CascadeGetEcgEnFlag())
+    {
+        GH3X2X_CascadeCalibrateECGGain(g_puchGh3x2xReadRawdataBuffer,g_usGh3x2xReadRawdataLen);
+    }
+    else
+    {
+        GH3X2X_CalibrateECGGain(g_puchGh3x2xReadRawdataBuffer,g_usGh3x2xReadRawdataLen);
+    }
+    #endif
+
+    GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_ECG_CALI);
+
+    /* Step 4: if ECG enabled, do soft lead off process */
+    GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_LEAD);
+    #if (__GH3X2X_CASCADE_EN__)
+    if (GH3X2X_CascadeGetEcgEnFlag())
+    {
+        usGotEvent = GH3X2X_CascadeLeadOnEventPreDeal(usGotEvent, usGotSlaverEvent,puchEventEx);
+    }
+    #endif
+    stLeadResult = GH3X2X_LeadHandle(usGotEvent, g_puchGh3x2xReadRawdataBuffer, &g_usGh3x2xReadRawdataLen);
+    usGotEvent = stLeadResult.usEvent;
+
+    if(stLeadResult.uchNeedForceReadFifo)
+    {
+        GH3X2X_SetSoftEvent(GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO);
+    }
+    GH3X2X_EcgRsHandle(g_puchGh3x2xReadRawdataBuffer, &g_usGh3x2xReadRawdataLen);
+    GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_LEAD);
+#endif
+
+    /* Step 5: do soft agc process*/
+    GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_AGC);
+    GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_AGC);
+    Gh3x2x_UserHandleCurrentInfo();
+#if (__SUPPORT_ENGINEERING_MODE__)
+    if(0 == g_uchEngineeringModeStatus)  //in engineering mode,  disable soft agc function
+#endif
+        {
+        if(0 != (usGotEvent & (GH3X2X_IRQ_MSK_TUNNING_FAIL_BIT | GH3X2X_IRQ_MSK_TUNNING_DONE_BIT)))
+        {
+//                GH3X2X_SoftLedADJAutoADJInt();
+        }
+    #if (__SUPPORT_SAMPLE_DEBUG_MODE__)
+        if((g_usDumpMode & 0x3) != 0)
+        {
+            GH3X2X_LedAgcProcessExDump(g_puchGh3x2xReadRawdataBuffer);
+        }
+        else
+    #endif
+        {    
+            GH3X2X_LedAgcProcess(g_puchGh3x2xReadRawdataBuffer, g_usGh3x2xReadRawdataLen);
+        }
+    }
+    GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_AGC);
+
+    GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_PROCESS);
+
+    /* Extern Step: send fifo*/
+#if (__FIFO_PACKAGE_SEND_ENABLE__)
+    if (GH3X2X_GetFifoPackageMode())
+    {
+        GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_PROTOCOL);
+        GH3X2X_SendRawdataFifoPackage(g_puchGh3x2xReadRawdataBuffer, g_usGh3x2xReadRawdataLen);
+        GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_PROTOCOL);
+    }
+#endif
+    return usGotEvent;
+}
+
+/**
+ * @fn     static void Gh3x2xDemoIntEnterLowPower(void)
+ *
+ * @brief  put chip(s) into low power mode at the end of a pass
+ *
+ * @attention   drv lib lock is held by caller
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoIntEnterLowPower(void)
+{
+    GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_LOW_POWER);
+    GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_LOW_POWER);
+#if !(__GH3X2X_CASCADE_EN__)
+    GH3X2X_EnterLowPowerMode();
+    #else
+    if (GH3X2X_CascadeGetEcgEnFlag())
+    {
+        GH3X2X_EnterLowPowerMode();
+        GH3X2X_CascadeOperationSlaverChip();
+        GH3X2X_EnterLowPowerMode();
+        GH3X2X_CascadeOperationMasterChip();
+    }
+    else
+    {
+        GH3X2X_EnterLowPowerMode();
+    }
+#endif
+    GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_LOW_POWER);
+}
+
+/**
+ * @fn     static GU16 Gh3x2xDemoIntEventReport(GU16 usGotEvent, GU8 uchEventEx)
+ *
+ * @brief  report events of a pass by protocol
+ *
+ * @attention   drv lib lock is held by caller
+ *
+ * @param[in]   usGotEvent   events of the pass
+ *              uchEventEx   extra event bits
+ * @param[out]  None
+ *
+ * @return  events left for event hook
+ */
+static GU16 Gh3x2xDemoIntEventReport(GU16 usGotEvent, GU8 uchEventEx)
+{
+#if (__SUPPORT_PROTOCOL_ANALYZE__)
+#if (__SUPPORT_PROTOCOL_ANALYZE__)
+    GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_PROTOCOL);
+#if (__SUPPORT_SAMPLE_DEBUG_MODE__)
+    if (GH3X2X_ElectrodeWearRevertDebugModeIsEnabled())
+    {
+        if (usGotEvent & GH3X2X_IRQ_MSK_WEAR_ON_BIT)
+        {
+            GH3X2X_AddElectrodeWearRevCnt();
+        }
+        usGotEvent &= ~(GH3X2X_IRQ_MSK_WEAR_ON_BIT | GH3X2X_IRQ_MSK_WEAR_OFF_BIT);
+    }
+#endif
+    Gh3x2xDemoReportEvent(usGotEvent,uchEventEx);
+    if(uchEventEx&GH3X2X_EVENT_EX_BIT_CHIP0_LEAD_ON)
+    {
+        EXAMPLE_LOG("chip0 lead on\r\n");
+        //while(1);
+    }
+    if(uchEventEx&GH3X2X_EVENT_EX_BIT_CHIP1_LEAD_ON)
+    {
+        EXAMPLE_LOG("chip1 lead on\r\n");
+        //while(1);
+    }
+    GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_PROTOCOL);
+#endif
+#endif
+    return usGotEvent;
+}
+
+/**
+ * @fn     static void Gh3x2xDemoIntFifoBlockDispatch(void)
+ *
+ * @brief  hand the rawdata block just read to algorithm
+ *
+ * @attention   drv lib lock is held by caller
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoIntFifoBlockDispatch(void)
+{
+#if (__GH3X2X_INT_PIPELINE_EN__)
+    Gh3x2xDemoPipelinePush();   //algorithm runs in processing thread
+#else
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+    g_llGh3x2xTimeStampBlockAnchorUs = g_llGh3x2xTimeStampReadAnchorUs;
+#endif
+    Gh3x2xDemoFifoBlockProcess(g_puchGh3x2xReadRawdataBuffer, g_usGh3x2xReadRawdataLen);
+#endif
+}
+
+/**
+ * @fn     static void Gh3x2xDemoIntEventHook(GU16 usGotEvent, GU8 uchEventEx)
+ *
+ * @brief  call lead and wear event hooks of a pass
+ *
+ * @attention   drv lib lock is held by caller
+ *
+ * @param[in]   usGotEvent   events of the pass
+ *              uchEventEx   extra event bits
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoIntEventHook(GU16 usGotEvent, GU8 uchEventEx)
+{
+#if (__FUNC_TYPE_ECG_ENABLE__)
+    if (usGotEvent & GH3X2X_IRQ_MSK_LEAD_ON_DET_BIT)
+    {
+        Gh3x2x_LeadOnEventHook();
+        EXAMPLE_LOG("Lead on!!!\r\n");
+    }
+    if (usGotEvent & GH3X2X_IRQ_MSK_LEAD_OFF_DET_BIT)
+    {
+        Gh3x2x_LeadOffEventHook();
+        EXAMPLE_LOG("Lead off!!!\r\n");
+    }
+#endif
+
+#if (__SUPPORT_HARD_ADT_CONFIG__)
+    if ((usGotEvent & GH3X2X_IRQ_MSK_WEAR_ON_BIT) || (usGotEvent & GH3X2X_IRQ_MSK_WEAR_OFF_BIT))
+    {
+    #if (__GH3X2X_CASCADE_EN__)
+        Gh3x2x_WearEventCascadeEcgHandle(usGotEvent);
+    #endif
+        Gh3x2x_WearEventHook(usGotEvent, uchEventEx);
+    }
+#endif
+}
 
-    #if (__FUNC_TYPE_ECG_ENABLE__)
-        memset((GU8*)(&stLeadResult),0,sizeof(stLeadResult));
+/**
+ * @fn     static void Gh3x2xDemoIntProcess(void)
+ *
+ * @brief  Interrupt process of GH3x2x, body of Gh3x2xDemoInterruptProcess.
+ *
+ * @attention   drv lib lock is held by caller
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoIntProcess(void)
+{
+    if(0 == g_uchGh3x2xInitFlag)
+    {
+        EXAMPLE_LOG("[%s]:gh3x2x is not init!!!\r\n", __FUNCTION__);
+        return;
+    }
+#if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+    if (GH3X2X_CHIP_RESET_RECOVERY_IDLE != g_emGh3x2xChipResetRecoveryState)
+    {
+        g_uchGh3x2xChipResetRecoveryIntPending = 1;     //chip is being reset, process after recovery
+        return;
+    }
+#endif
+
+    GU8 uchRet = 0;
+    GU16 usGotEvent = 0;
+#if (0 == __GH3X2X_SOFT_EVENT_DISPATCH_EN__)
+    GU8 uchIntRepeatNum = 0;
+#endif
+    GU16 usGotSlaverEvent = 0;
+    GU8 uchEventEx = 0;     //bit0:  0: object/no objiect   1: living/nonliving object
+                            //bit1:  0: None                1: chip0 lead on
+                            //bit2:  0: None                1: chip0 lead off
+                            //bit3:  0: None                1: chip1 lead on
+                            //bit4:  0: None                1: chip1 lead off
+
+    g_uchGh3x2xInterruptProNotFinishFlag = 1;
+
+
+    if(GH3X2X_DEMO_WORK_MODE_MPT == g_uchDemoWorkMode)
+    {
+        return;
+    }
+
+#if __USER_DYNAMIC_DRV_BUF_EN__
+    if(0 == Gh3x2xDemoMemCheckValid())    //dynamic mem is not valid
+    {
+        EXAMPLE_LOG("[%s]Warning, dynamic mem is not valid !!!\r\n",__FUNCTION__);
+        return;
+    }
+#endif
+
+
+
+
+#if __FUNC_TYPE_SOFT_ADT_ENABLE__
+#if (__USE_POLLING_TIMER_AS_ADT_TIMER__)&&(__POLLING_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    if (g_uchGh3x2xIntMode == __POLLING_INT_PROCESS_MODE__ && 1 == g_uchVirtualAdtTimerCtrlStatus && GH3X2X_GetSoftWearOffDetEn())
+    {
+        Gh3x2xDemoMoveDetectTimerHandler();
+    }
+#endif
+#endif
+
+#if __GH_MSG_WITH_ALGO_LAYER_EN__
+        GH3X2X_PRO_MSG_SOFT_WEAR_EVEVT();
+#endif
+
+    //check "Gh3x2xDemoInterruptProcess" call is legal or not
+#if (__NORMAL_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    if (g_uchGh3x2xIntMode == __NORMAL_INT_PROCESS_MODE__)
+    {
+        if((0 == GH3X2X_GetSoftEvent())&&(0 == g_uchGh3x2xIntCallBackIsCalled))
+        {
+    #if (0 == __PLATFORM_WITHOUT_OS__)
+            EXAMPLE_LOG("InterruptProcess: plese check hal_gh3x2x_int_handler_call_back is called or not !!!\r\n");
+    #endif
+            EXAMPLE_LOG("InterruptProcess:invalid call, do not process.\r\n");
+            return;
+        }
+    }
+#endif
+
+#if (__NORMAL_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    if (g_uchGh3x2xIntMode == __NORMAL_INT_PROCESS_MODE__)
+    {
+    #if (__MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+        if (g_uchGh3x2xIntCallBackIsCalled)
+        {
+            g_unGh3x2xPollingIntCnt++;
+        }
+    #endif
+        g_uchGh3x2xIntCallBackIsCalled = 0;
+    }  
+#endif
+
+    do{
+        GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_INT_PASS);
+        uchRet = GH3X2X_INT_PROCESS_SUCCESS;
+        usGotEvent = 0;
+    #if __GH3X2X_CASCADE_EN__
+         usGotSlaverEvent = 0;
     #endif
 
+        /* Step 1: read irq status */
+
+        GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_IRQ_STATUS);
+        GH3X2X_STAGE_PROF_START(GH3X2X_STAGE_IRQ_READ);
         usGotEvent = GH3X2X_GetIrqStatus();
     #if (__GH3X2X_CASCADE_EN__)
          if (GH3X2X_CascadeGetEcgEnFlag())
@@ -1844,8 +3769,16 @@ void Gh3x2xDemoInterruptProcess(void)
             EXAMPLE_LOG("usGotMasterEvent:0x%04x \r\n",usGotEvent);
          }
     #endif
+        GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_IRQ_READ);
         usGotEvent &= __GH3X2X_EVENT_PROCESS_MASK__;
         EXAMPLE_LOG("usGotEvent = 0x%x\r\n", usGotEvent);
+    #if (__GH3X2X_REG_SHADOW_EN__)
+        if (usGotEvent & (GH3X2X_IRQ_MSK_CHIP_RESET_BIT | GH3X2X_IRQ_MSK_TUNNING_DONE_BIT | GH3X2X_IRQ_MSK_TUNNING_FAIL_BIT))
+        {
+            Gh3x2xRegShadowInvalidate();    //regs are changed by chip
+        }
+    #endif
+        GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_WEAR);
 
 
 
@@ -1913,155 +3846,29 @@ void Gh3x2xDemoInterruptProcess(void)
         if ((usGotEvent & (GH3X2X_IRQ_MSK_FIFO_WATERMARK_BIT | GH3X2X_IRQ_MSK_FIFO_FULL_BIT)) \
             || (GH3X2X_GetSoftEvent() & (GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO|GH3X2X_SOFT_EVENT_NEED_TRY_READ_FIFO)))
         {
-            GU16 usFifoByteNum = ((GU16)4)*GH3X2X_ReadReg(GH3X2X_INT_FIFO_UR_REG_ADDR); //read fifo use
-        #if (__GH3X2X_CASCADE_EN__)
-            //vTaskDelay(5);
-            GU16 usFifoByteNumSlaver = 0;
-            if (GH3X2X_CascadeGetEcgEnFlag())
-            {
-                GH3X2X_CascadeOperationSlaverChip();
-                usFifoByteNumSlaver = ((GU16)4)*GH3X2X_ReadReg(GH3X2X_INT_FIFO_UR_REG_ADDR);
-                GH3X2X_CascadeOperationMasterChip();
-            }
-
-        #endif
-        #if (__NORMAL_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
-            if (g_uchGh3x2xIntMode == __NORMAL_INT_PROCESS_MODE__)
-            {
-                GU8 uchIsForceRead = (GH3X2X_GetSoftEvent() & GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO);
-                if(0 == uchIsForceRead)
-                {
-                    if(usFifoByteNum < ((GU16)4)*GH3X2X_GetCurrentFifoWaterLine())  //data is too less
-                    {
-                        usFifoByteNum = 0;   //no need read
-                    }
-                }
-            }
-        #endif
-
-            GH3X2X_ClearSoftEvent(GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO|GH3X2X_SOFT_EVENT_NEED_TRY_READ_FIFO);
-            g_usGh3x2xReadRawdataLen = 0;
-            if (usFifoByteNum != 0)
-            {
-            #if (__DRIVER_LIB_MODE__ == __DRV_LIB_WITH_ALGO__)
-                GH3X2X_TimestampSyncSetPpgIntFlag(1);
-            #endif
-            #if !(__GH3X2X_CASCADE_EN__)
-                if (GH3X2X_RET_READ_FIFO_CONTINUE == GH3X2X_ReadFifodata(g_puchGh3x2xReadRawdataBuffer, &g_usGh3x2xReadRawdataLen, usFifoByteNum))
-                {
-                    GH3X2X_SetSoftEvent(GH3X2X_SOFT_EVENT_NEED_TRY_READ_FIFO);
-                }
-            #else
-                if (GH3X2X_CascadeGetEcgEnFlag())
-                {
-                    //EXAMPLE_LOG("Master fifo:%d  Slaver Fifo:%d CurrentFifoWaterLine:%d\r\n", usFifoByteNum/4, usFifoByteNumSlaver/4, GH3X2X_GetCurrentFifoWaterLine());
-                    if (usFifoByteNum > usFifoByteNumSlaver)
-                    {
-                        usFifoByteNum = usFifoByteNumSlaver;
-                    }
-                    if (usFifoByteNum > __GH3X2X_RAWDATA_SLAVE_BUFFER_SIZE__)
-                    {
-                        usFifoByteNum = __GH3X2X_RAWDATA_SLAVE_BUFFER_SIZE__;
-                    }
-                    if (GH3X2X_RET_READ_FIFO_CONTINUE == GH3X2X_CascadeReadFifodata(g_puchGh3x2xReadRawdataBuffer,g_puchGh3x2xReadRawdataBufferSlaveChip, &g_usGh3x2xReadRawdataLen ,usFifoByteNum, 0x08))
-                    {
-                        GH3X2X_SetSoftEvent(GH3X2X_SOFT_EVENT_NEED_TRY_READ_FIFO);
-                    }
-                }
-
-                else
-                {
-                    if (GH3X2X_RET_READ_FIFO_CONTINUE == GH3X2X_ReadFifodata(g_puchGh3x2xReadRawdataBuffer, &g_usGh3x2xReadRawdataLen, usFifoByteNum))
-                    {
-                        GH3X2X_SetSoftEvent(GH3X2X_SOFT_EVENT_NEED_TRY_READ_FIFO);
-                    }
-                }
-            #endif
-            #if ((__SUPPORT_PROTOCOL_ANALYZE__)||(__SUPPORT_ALGO_INPUT_OUTPUT_DATA_HOOK_CONFIG__))
-            #if (__SUPPORT_ELECTRODE_WEAR_STATUS_DUMP__)
-                GH3X2X_ReadElectrodeWearDumpData();
-            #endif
-                GH3X2X_RecordDumpData();
-            #endif
-                GH3X2X_RecordTiaGainInfo();
-            }
-        }
-
-    #if (__FUNC_TYPE_ECG_ENABLE__)
-        /* extra step: ECG Gain calibration*/
-        #if !(__GH3X2X_CASCADE_EN__)
-        GH3X2X_CalibrateECGGain(g_puchGh3x2xReadRawdataBuffer,g_usGh3x2xReadRawdataLen);
-        #else
-        if (GH3X2X_CascadeGetEcgEnFlag())
-        {
-            GH3X2X_CascadeCalibrateECGGain(g_puchGh3x2xReadRawdataBuffer,g_usGh3x2xReadRawdataLen);
-        }
-        else
-        {
-            GH3X2X_CalibrateECGGain(g_puchGh3x2xReadRawdataBuffer,g_usGh3x2xReadRawdataLen);
-        }
-        #endif
-
-        /* Step 4: if ECG enabled, do soft lead off process */
-        #if (__GH3X2X_CASCADE_EN__)
-        if (GH3X2X_CascadeGetEcgEnFlag())
-        {
-            usGotEvent = GH3X2X_CascadeLeadOnEventPreDeal(usGotEvent, usGotSlaverEvent,&uchEventEx);
-        }
-        #endif
-        stLeadResult = GH3X2X_LeadHandle(usGotEvent, g_puchGh3x2xReadRawdataBuffer, &g_usGh3x2xReadRawdataLen);
-        usGotEvent = stLeadResult.usEvent;
-
-        if(stLeadResult.uchNeedForceReadFifo)
-        {
-            GH3X2X_SetSoftEvent(GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO);
-        }
-        GH3X2X_EcgRsHandle(g_puchGh3x2xReadRawdataBuffer, &g_usGh3x2xReadRawdataLen);
-    #endif
-
-        /* Step 5: do soft agc process*/
-        Gh3x2x_UserHandleCurrentInfo();
-    #if (__SUPPORT_ENGINEERING_MODE__)
-        if(0 == g_uchEngineeringModeStatus)  //in engineering mode,  disable soft agc function
-    #endif
-            {
-            if(0 != (usGotEvent & (GH3X2X_IRQ_MSK_TUNNING_FAIL_BIT | GH3X2X_IRQ_MSK_TUNNING_DONE_BIT)))
-            {
-//                GH3X2X_SoftLedADJAutoADJInt();
-            }
-        #if (__SUPPORT_SAMPLE_DEBUG_MODE__)
-            if((g_usDumpMode & 0x3) != 0)
-            {
-                GH3X2X_LedAgcProcessExDump(g_puchGh3x2xReadRawdataBuffer);
-            }
-            else
-        #endif
-            {    
-                GH3X2X_LedAgcProcess(g_puchGh3x2xReadRawdataBuffer, g_usGh3x2xReadRawdataLen);
-            }
+            Gh3x2xDemoIntFifoRead(usGotEvent, (GH3X2X_GetSoftEvent() & GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO) ? 1 : 0);
         }
 
-        /* Extern Step: send fifo*/
-    #if (__FIFO_PACKAGE_SEND_ENABLE__)
-        if (GH3X2X_GetFifoPackageMode())
-        {
-            GH3X2X_SendRawdataFifoPackage(g_puchGh3x2xReadRawdataBuffer, g_usGh3x2xReadRawdataLen);
-        }
-    #endif
+        /* Step 4/5: ecg gain calibration, soft lead off, soft agc and fifo package send */
+        usGotEvent = Gh3x2xDemoIntRawdataHandle(usGotEvent, usGotSlaverEvent, &uchEventEx);
 
         /* Step 6: chip reset event process*/
         if(0 != (usGotEvent & GH3X2X_IRQ_MSK_CHIP_RESET_BIT))
         {
+            GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_CHIP_RESET);
             if(0 == GH3x2x_GetChipResetRecoveringFlag())  //do nothing in recover period
             {
                 EXAMPLE_LOG("Got chip reset event !!! ActiveChipResetFlag = %d, g_unDemoFuncMode = %d, recovering flag = %d\r\n",(int)GH3x2x_GetActiveChipResetFlag(), (int)g_unDemoFuncMode, (int)GH3x2x_GetChipResetRecoveringFlag());
                 if((GH3x2x_GetActiveChipResetFlag())||(0 == g_unDemoFuncMode))
                 {
                     Gh3x2xDemoSamplingControl(0xFFFFFFFF, UPROTOCOL_CMD_STOP);
-                    GH3X2X_Init(g_stGh3x2xCfgListArr+g_uchGh3x2xRegCfgArrIndex); 
+                    Gh3x2xDemoLoadRegCfg(g_stGh3x2xCfgListArr+g_uchGh3x2xRegCfgArrIndex, "chip reset"); 
                 }
                 else
                 {
+                #if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+                    Gh3x2xDemoChipResetRecoveryStart();
+                #else
                     //need recovery for chip reset
                     GU8 uchTryCnt = 5;   //retry max count
                     GS8 schret = GH3X2X_RET_GENERIC_ERROR;
@@ -2081,7 +3888,7 @@ void Gh3x2xDemoInterruptProcess(void)
                                 
                                 Gh3x2xDemoStopSampling(g_unDemoFuncMode);
                                 
-                                schret = GH3X2X_Init(g_stGh3x2xCfgListArr+g_uchGh3x2xRegCfgArrIndex);
+                                schret = Gh3x2xDemoLoadRegCfg(g_stGh3x2xCfgListArr+g_uchGh3x2xRegCfgArrIndex, "reset recovery");
                                 
                                 if (GH3X2X_RET_OK == schret)
                                 {
@@ -2092,172 +3899,67 @@ void Gh3x2xDemoInterruptProcess(void)
                                     //g_uchGh3x2xRegCfgArrIndex = DRV_LIB_REG_CFG_EMPTY;
                                     EXAMPLE_LOG("Gh3x2xDemoInterruptProcess:recovery init fail, error code: %d\r\n", schret);
                                 }
-                                uchTryCnt --;
-                        }while((GH3X2X_RET_OK != schret)&&(0 < uchTryCnt));
-
-                    GH3X2X_EnterLowPowerMode();
-                #if __GH3X2X_CASCADE_EN__
-                    GH3X2X_CascadeOperationSlaverChip();
-                    GH3X2X_EnterLowPowerMode();
-                    GH3X2X_CascadeOperationMasterChip();
-                #endif
-
-                #if (__SUPPORT_ENGINEERING_MODE__)
-                    if(1 == g_uchEngineeringModeStatus)
-                    {
-                        Gh3x2xDemoStartSamplingForEngineeringMode(unDemoFuncModeBeforeChipReset, g_uchGh3x2xRegCfgArrIndex, g_pstSampleParaGroup, g_uchEngineeringModeSampleParaGroupNum);
-                    }
-                    else
-                #endif
-                    {
-                        Gh3x2xDemoStartSampling(unDemoFuncModeBeforeChipReset);
-                    }
-                    GH3x2x_SetChipResetRecoveringFlag(0);
-                }
-            }
-        }
-
-    #if !(__GH3X2X_CASCADE_EN__)
-        GH3X2X_EnterLowPowerMode();
-        #else
-        if (GH3X2X_CascadeGetEcgEnFlag())
-        {
-            GH3X2X_EnterLowPowerMode();
-            GH3X2X_CascadeOperationSlaverChip();
-            GH3X2X_EnterLowPowerMode();
-            GH3X2X_CascadeOperationMasterChip();
-        }
-        else
-        {
-            GH3X2X_EnterLowPowerMode();
-        }
-    #endif
-
-        /* Step 7: report event */
-    #if (__SUPPORT_PROTOCOL_ANALYZE__)
-    #if (__SUPPORT_SAMPLE_DEBUG_MODE__)
-        if (GH3X2X_ElectrodeWearRevertDebugModeIsEnabled())
-        {
-            if (usGotEvent & GH3X2X_IRQ_MSK_WEAR_ON_BIT)
-            {
-                GH3X2X_AddElectrodeWearRevCnt();
-            }
-            usGotEvent &= ~(GH3X2X_IRQ_MSK_WEAR_ON_BIT | GH3X2X_IRQ_MSK_WEAR_OFF_BIT);
-        }
-    #endif
-        Gh3x2xDemoReportEvent(usGotEvent,uchEventEx);
-        if(uchEventEx&GH3X2X_EVENT_EX_BIT_CHIP0_LEAD_ON)
-        {
-            EXAMPLE_LOG("chip0 lead on\r\n");
-            //while(1);
-        }
-        if(uchEventEx&GH3X2X_EVENT_EX_BIT_CHIP1_LEAD_ON)
-        {
-            EXAMPLE_LOG("chip1 lead on\r\n");
-            //while(1);
-        }
-    #endif
-
-        if ((usGotEvent & (GH3X2X_IRQ_MSK_FIFO_WATERMARK_BIT | GH3X2X_IRQ_MSK_FIFO_FULL_BIT)) \
-            || (GH3X2X_GetSoftEvent() & GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO))
-        {
-        #if __GS_NONSYNC_READ_EN__
-            GU16 usGsensorNeedPointNum;
-            GS16 sGsensorHeadPosi;
-        #endif
-            if (GH3X2X_GetGsensorEnableFlag())
-            {
-            #if (0 == __GS_TIMESTAMP_READ_EN__)
-            #if (__FUNC_TYPE_SOFT_ADT_ENABLE__)
-                if (g_uchVirtualAdtTimerCtrlStatus == 0)
-            #endif
-                {
-                    hal_gsensor_drv_get_fifo_data(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__, &gsensor_soft_fifo_buffer_index);        
-                    Gh3x2x_NormalizeGsensorSensitivity(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__ ,gsensor_soft_fifo_buffer_index);
-                }
-            #endif
-            }
-            /*extra step: get cap and temp data from other sensor*/
-            #if __CAP_ENABLE__
-            if (GH3X2X_GetCapEnableFlag())
-            {
-                hal_cap_drv_get_fifo_data(cap_soft_fifo_buffer, &cap_soft_fifo_buffer_index);
-            }
-            #endif
-            #if __TEMP_ENABLE__
-            if (GH3X2X_GetTempEnableFlag())
-            {
-                hal_temp_drv_get_fifo_data(temp_soft_fifo_buffer, &temp_soft_fifo_buffer_index);
-            }
-            #endif
-            /* Step 8: algorithm process*/
-            #if __GH3X2X_MEM_POOL_CHECK_EN__
-            Gh3x2xCheckMemPollBeforeAlgoCal();
-            #endif
-
-        #ifdef GOODIX_DEMO_PLANFORM
-            if (((GH3X2X_DEMO_WORK_MODE_MCU_ONLINE == g_uchDemoWorkMode) ||\
-                        (GH3X2X_DEMO_WORK_MODE_PASS_THROUGH == g_uchDemoWorkMode) ||\
-                        (GH3X2X_DEMO_WORK_MODE_APP == g_uchDemoWorkMode) ||\
-                        (GH3X2X_DEMO_WORK_MODE_EVK == g_uchDemoWorkMode)) &&\
-                        ((g_usDumpMode & 0x3) == 0))
-        #endif
-            {
-            #if __GS_NONSYNC_READ_EN__
-                usGsensorNeedPointNum = Gh3x2xGetGsensorNeedPointNum(gsensor_soft_fifo_buffer_index, g_puchGh3x2xReadRawdataBuffer, g_usGh3x2xReadRawdataLen);
-                sGsensorHeadPosi = Gh3x2xGetGsensorHeadPos(gsensor_soft_fifo_buffer_index,usGsensorNeedPointNum);    
-                Gh3x2xDemoFunctionProcess(g_puchGh3x2xReadRawdataBuffer,g_usGh3x2xReadRawdataLen, gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__ + sGsensorHeadPosi, usGsensorNeedPointNum,
-                                                cap_soft_fifo_buffer,cap_soft_fifo_buffer_index,temp_soft_fifo_buffer,temp_soft_fifo_buffer_index);
+                                uchTryCnt --;
+                        }while((GH3X2X_RET_OK != schret)&&(0 < uchTryCnt));
 
+                    GH3X2X_EnterLowPowerMode();
+                #if __GH3X2X_CASCADE_EN__
+                    GH3X2X_CascadeOperationSlaverChip();
+                    GH3X2X_EnterLowPowerMode();
+                    GH3X2X_CascadeOperationMasterChip();
+                #endif
 
-                for(GU16 usPointCnt = 0; usPointCnt < usGsensorNeedPointNum; usPointCnt++)
-                {
-                    STGsensorRawdata * temp_gsensor = gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__ + sGsensorHeadPosi;
-                    EXAMPLE_LOG("[Gsensor show]x = %d,y = %d, z = %d\r\n",temp_gsensor[usPointCnt].sXAxisVal,temp_gsensor[usPointCnt].sYAxisVal,temp_gsensor[usPointCnt].sZAxisVal);
+                #if (__SUPPORT_ENGINEERING_MODE__)
+                    if(1 == g_uchEngineeringModeStatus)
+                    {
+                        Gh3x2xDemoStartSamplingForEngineeringMode(unDemoFuncModeBeforeChipReset, g_uchGh3x2xRegCfgArrIndex, g_pstSampleParaGroup, g_uchEngineeringModeSampleParaGroupNum);
+                    }
+                    else
+                #endif
+                    {
+                        Gh3x2xDemoStartSampling(unDemoFuncModeBeforeChipReset);
+                    }
+                    GH3x2x_SetChipResetRecoveringFlag(0);
+                #endif
                 }
-
-                
-                Gh3x2xNonSyncGsenosrPostProcess(gsensor_soft_fifo_buffer_index, usGsensorNeedPointNum, sGsensorHeadPosi); 
-            #else
-                Gh3x2xDemoFunctionProcess(g_puchGh3x2xReadRawdataBuffer,g_usGh3x2xReadRawdataLen, gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__, gsensor_soft_fifo_buffer_index,
-                                                cap_soft_fifo_buffer,cap_soft_fifo_buffer_index,temp_soft_fifo_buffer,temp_soft_fifo_buffer_index);
-            #endif
             }
-            #if __GH3X2X_MEM_POOL_CHECK_EN__
-            Gh3x2xUpdataMemPollChkSumAfterAlgoCal();
-            #endif
         }
 
-        ///* Step 9: event hook */
-    #if (__FUNC_TYPE_ECG_ENABLE__)
-        if (usGotEvent & GH3X2X_IRQ_MSK_LEAD_ON_DET_BIT)
-        {
-            Gh3x2x_LeadOnEventHook();
-            EXAMPLE_LOG("Lead on!!!\r\n");
-        }
-        if (usGotEvent & GH3X2X_IRQ_MSK_LEAD_OFF_DET_BIT)
-        {
-            Gh3x2x_LeadOffEventHook();
-            EXAMPLE_LOG("Lead off!!!\r\n");
-        }
-    #endif
+        Gh3x2xDemoIntEnterLowPower();
+
+        /* Step 7: report event */
+        usGotEvent = Gh3x2xDemoIntEventReport(usGotEvent, uchEventEx);
 
-    #if (__SUPPORT_HARD_ADT_CONFIG__)
-        if ((usGotEvent & GH3X2X_IRQ_MSK_WEAR_ON_BIT) || (usGotEvent & GH3X2X_IRQ_MSK_WEAR_OFF_BIT))
+        if ((usGotEvent & (GH3X2X_IRQ_MSK_FIFO_WATERMARK_BIT | GH3X2X_IRQ_MSK_FIFO_FULL_BIT)) \
+            || (GH3X2X_GetSoftEvent() & GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO))
         {
-        #if (__GH3X2X_CASCADE_EN__)
-            Gh3x2x_WearEventCascadeEcgHandle(usGotEvent);
-        #endif
-            Gh3x2x_WearEventHook(usGotEvent, uchEventEx);
+            Gh3x2xDemoIntFifoBlockDispatch();
         }
-    #endif
+
+        /* Step 9: event hook */
+        Gh3x2xDemoIntEventHook(usGotEvent, uchEventEx);
+        GH3X2X_STAGE_PROF_END(GH3X2X_STAGE_INT_PASS);
+        GH3X2X_STAGE_PROF_DONE(GH3X2X_STAGE_INT_MASK);
 
         if (GH3X2X_GetSoftEvent())  //have new soft event
         {
+        #if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+            if (GH3X2X_CHIP_RESET_RECOVERY_IDLE != g_emGh3x2xChipResetRecoveryState)
+            {
+                g_uchGh3x2xChipResetRecoveryIntPending = 1;     //soft event is processed after recovery
+                break;
+            }
+        #endif
+        #if (__GH3X2X_SOFT_EVENT_DISPATCH_EN__)
+            hal_gh3x2x_soft_event_post();   //next pass runs in dispatch work, not by repeating
+            break;
+        #else
             uchRet = GH3X2X_INT_PROCESS_REPEAT;
             EXAMPLE_LOG("InterruptProcess: process need repeat.\r\n");
+        #endif
         }
 
+    #if (0 == __GH3X2X_SOFT_EVENT_DISPATCH_EN__)
         if (uchIntRepeatNum > 20)
         {
             EXAMPLE_LOG("InterruptProcess: 0 Warning!!!!GetEvent Error!!!0x%x\r\n", usGotEvent);
@@ -2270,9 +3972,241 @@ void Gh3x2xDemoInterruptProcess(void)
         {
             uchIntRepeatNum++;
         }
+    #endif
     }while(GH3X2X_INT_PROCESS_REPEAT == uchRet);
+    GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_OTHER);
+    g_uchGh3x2xInterruptProNotFinishFlag = 0;
+}
+
+/**
+ * @fn     void Gh3x2xDemoInterruptProcess(void)
+ *
+ * @brief  Interrupt process of GH3x2x.
+ *
+ * @attention   drv lib lock is held, so sampling control of other threads never runs in the middle of it
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoInterruptProcess(void)
+{
+    GH3X2X_DRV_LOCK();
+    Gh3x2xDemoIntProcess();
+    GH3X2X_DRV_UNLOCK();
+}
+
+#if (__GH3X2X_SOFT_EVENT_DISPATCH_EN__)
+/**
+ * @fn     static void Gh3x2xDemoSoftEventFifoRead(GU8 uchIsForceRead)
+ *
+ * @brief  read and process fifo data for force/try read fifo soft event, irq status is not read
+ *
+ * @attention   drv lib lock is held by caller, force/try read fifo soft events are cleared by fifo read
+ *
+ * @param[in]   uchIsForceRead  1: read even if fifo data is less than water line
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoSoftEventFifoRead(GU8 uchIsForceRead)
+{
+    GU16 usGotEvent = 0;
+    GU8 uchEventEx = 0;
+
+#if (__MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    if (g_uchGh3x2xIntMode == __POLLING_INT_PROCESS_MODE__)
+    {
+        usGotEvent |= GH3X2X_IRQ_MSK_FIFO_WATERMARK_BIT;
+    }
+#endif
+    Gh3x2xDemoIntFifoRead(usGotEvent, uchIsForceRead);
+    usGotEvent = Gh3x2xDemoIntRawdataHandle(usGotEvent, 0, &uchEventEx);
+    Gh3x2xDemoIntEnterLowPower();
+    usGotEvent = Gh3x2xDemoIntEventReport(usGotEvent, uchEventEx);
+    if ((usGotEvent & (GH3X2X_IRQ_MSK_FIFO_WATERMARK_BIT | GH3X2X_IRQ_MSK_FIFO_FULL_BIT)) \
+        || (GH3X2X_GetSoftEvent() & GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO))
+    {
+        Gh3x2xDemoIntFifoBlockDispatch();
+    }
+    Gh3x2xDemoIntEventHook(usGotEvent, uchEventEx);
+}
+
+/**
+ * @fn     static void Gh3x2xDemoSoftEventForceReadFifo(void)
+ *
+ * @brief  handler of force read fifo soft event
+ *
+ * @attention   drv lib lock is held by caller
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoSoftEventForceReadFifo(void)
+{
+    Gh3x2xDemoSoftEventFifoRead(1);
+}
+
+/**
+ * @fn     static void Gh3x2xDemoSoftEventTryReadFifo(void)
+ *
+ * @brief  handler of try read fifo soft event, fifo is read only if data reaches water line
+ *
+ * @attention   drv lib lock is held by caller
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoSoftEventTryReadFifo(void)
+{
+    Gh3x2xDemoSoftEventFifoRead(0);
+}
+
+#if (__SUPPORT_HARD_ADT_CONFIG__)
+/**
+ * @fn     static void Gh3x2xDemoSoftEventWear(GU16 usWearEvent)
+ *
+ * @brief  wear event process of soft wear on/off event, same as hard wear event of int process
+ *
+ * @attention   drv lib lock is held by caller
+ *
+ * @param[in]   usWearEvent     GH3X2X_IRQ_MSK_WEAR_ON_BIT or GH3X2X_IRQ_MSK_WEAR_OFF_BIT
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoSoftEventWear(GU16 usWearEvent)
+{
+    GU16 usGotEvent = usWearEvent;
+    GU8 uchEventEx = 0x1;   //soft wear event is living/nonliving object
+
+    Gh3x2xDemoWearEventProcess(&usGotEvent, WEAR_DETECT_DONT_FORCE_SWITCH);
+#if __FUNC_TYPE_SOFT_ADT_ENABLE__
+    Gh3x2xDemoSoftAdtStatusSwtich(&usGotEvent, &uchEventEx);
+#endif
+    Gh3x2xDemoIntEnterLowPower();
+    usGotEvent = Gh3x2xDemoIntEventReport(usGotEvent, uchEventEx);
+    Gh3x2xDemoIntEventHook(usGotEvent, uchEventEx);
+}
+#endif
+
+/**
+ * @fn     static void Gh3x2xDemoSoftEventWearOff(void)
+ *
+ * @brief  handler of soft wear off event
+ *
+ * @attention   drv lib lock is held by caller, event is dropped if hard adt is not supported
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoSoftEventWearOff(void)
+{
+    GH3X2X_ClearSoftEvent(GH3X2X_SOFT_EVENT_WEAR_OFF);
+#if (__SUPPORT_HARD_ADT_CONFIG__)
+    EXAMPLE_LOG("Got soft wear off !!! \r\n");
+    Gh3x2xDemoSoftEventWear(GH3X2X_IRQ_MSK_WEAR_OFF_BIT);
+#endif
+}
+
+/**
+ * @fn     static void Gh3x2xDemoSoftEventWearOn(void)
+ *
+ * @brief  handler of soft wear on event
+ *
+ * @attention   drv lib lock is held by caller, event is dropped if hard adt is not supported
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xDemoSoftEventWearOn(void)
+{
+    GH3X2X_ClearSoftEvent(GH3X2X_SOFT_EVENT_WEAR_ON);
+#if (__SUPPORT_HARD_ADT_CONFIG__)
+    EXAMPLE_LOG("Got soft wear on !!! \r\n");
+    Gh3x2xDemoSoftEventWear(GH3X2X_IRQ_MSK_WEAR_ON_BIT);
+#endif
+}
+
+/**
+ * @fn     void Gh3x2xDemoSoftEventDispatch(void)
+ *
+ * @brief  dispatch soft events of drv lib, each event bit is cleared and handled once by its own handler
+ *
+ * @attention   only called by soft event dispatch work with drv lib lock held, irq status is not read here,
+ *              soft events set by the handlers are posted again and handled by next dispatch work
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoSoftEventDispatch(void)
+{
+    GU32 unSoftEvent = 0;
+
+    if ((0 == g_uchGh3x2xInitFlag) || (GH3X2X_DEMO_WORK_MODE_MPT == g_uchDemoWorkMode))
+    {
+        return;
+    }
+#if __USER_DYNAMIC_DRV_BUF_EN__
+    if(0 == Gh3x2xDemoMemCheckValid())    //dynamic mem is not valid
+    {
+        return;
+    }
+#endif
+#if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+    if (GH3X2X_CHIP_RESET_RECOVERY_IDLE != g_emGh3x2xChipResetRecoveryState)
+    {
+        g_uchGh3x2xChipResetRecoveryIntPending = 1;     //soft event is processed after recovery
+        return;
+    }
+#endif
+
+    g_uchGh3x2xInterruptProNotFinishFlag = 1;
+    unSoftEvent = GH3X2X_GetSoftEvent();
+    if (unSoftEvent & GH3X2X_SOFT_EVENT_WEAR_OFF)
+    {
+        Gh3x2xDemoSoftEventWearOff();
+    }
+    if (unSoftEvent & GH3X2X_SOFT_EVENT_WEAR_ON)
+    {
+        Gh3x2xDemoSoftEventWearOn();
+    }
+    if (unSoftEvent & GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO)
+    {
+        Gh3x2xDemoSoftEventForceReadFifo();     //it covers try read too
+    }
+    else if (unSoftEvent & GH3X2X_SOFT_EVENT_NEED_TRY_READ_FIFO)
+    {
+        Gh3x2xDemoSoftEventTryReadFifo();
+    }
+    GH3X2X_STAGE_PROF_DONE(GH3X2X_STAGE_INT_MASK);
+    GH3X2X_BUS_STAT_PHASE(GH3X2X_BUS_PHASE_OTHER);
     g_uchGh3x2xInterruptProNotFinishFlag = 0;
+
+    if (GH3X2X_GetSoftEvent())  //set by handlers, e.g. fifo read continue
+    {
+    #if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+        if (GH3X2X_CHIP_RESET_RECOVERY_IDLE != g_emGh3x2xChipResetRecoveryState)
+        {
+            g_uchGh3x2xChipResetRecoveryIntPending = 1;
+            return;
+        }
+    #endif
+        hal_gh3x2x_soft_event_post();
+    }
 }
+#endif
 
 #if __GH3X2X_CASCADE_EN__
 GU8 Gh3x2xCheckCfgValidForCascade(GU8 uchCfgIndex)
@@ -2364,6 +4298,11 @@ GS8 GH3x2xDemoSearchCfgListByFunc(GU8* puchCfgIndex, GU32 unFuncMode, GU32 unFun
 GS8 Gh3x2xDemoArrayCfgSwitch(GU8 uchArrayCfgIndex)
 {
     GS8  chRet = GH3X2X_RET_OK;
+    GH3X2X_DRV_LOCK();
+#if (__GH3X2X_REG_SHADOW_EN__)
+    STGh3x2xRegShadowStat stRegShadowStat;
+    Gh3x2xRegShadowGetStat(&stRegShadowStat);
+#endif
 
     if(g_uchGh3x2xRegCfgArrIndex == uchArrayCfgIndex)
     {
@@ -2384,7 +4323,7 @@ GS8 Gh3x2xDemoArrayCfgSwitch(GU8 uchArrayCfgIndex)
         #endif
 
         g_uchGh3x2xRegCfgArrIndex = uchArrayCfgIndex;
-        if (GH3X2X_RET_OK == GH3X2X_Init(g_stGh3x2xCfgListArr + uchArrayCfgIndex))
+        if (GH3X2X_RET_OK == Gh3x2xDemoLoadRegCfg(g_stGh3x2xCfgListArr + uchArrayCfgIndex, "cfg switch"))
         {
             EXAMPLE_LOG("cfg%d switch success !!!.\r\n",(int)uchArrayCfgIndex);
         }
@@ -2400,6 +4339,9 @@ GS8 Gh3x2xDemoArrayCfgSwitch(GU8 uchArrayCfgIndex)
         GH3X2X_EnterLowPowerMode();
         GH3X2X_CascadeOperationMasterChip();
         #endif
+        #if (__GH3X2X_REG_SHADOW_EN__)
+        Gh3x2xRegShadowStatLog("cfg switch", &stRegShadowStat);
+        #endif
         
     }
     else
@@ -2407,6 +4349,7 @@ GS8 Gh3x2xDemoArrayCfgSwitch(GU8 uchArrayCfgIndex)
         EXAMPLE_LOG("Error! uchArrayCfgIndex(%d) is invalid !!!\r\n",(int)uchArrayCfgIndex);
         chRet = GH3X2X_RET_RESOURCE_ERROR;
     }
+    GH3X2X_DRV_UNLOCK();
     return chRet;
 }
 
@@ -2657,6 +4600,37 @@ void GH3x2xMaserControlFunctionLog(GU32 unFuncMode, EMUprotocolParseCmdType emCm
     }
 }
 
+#if (__GS_ZEPHYR_SENSOR_EN__)
+/**
+ * @fn     static GU16 Gh3x2xDemoGsensorRateGet(GU32 unFuncMode)
+ *
+ * @brief  gsensor sample rate for functions, max frame rate of them(one gsensor point per frame)
+ *
+ * @attention   __GS_SAMPLE_RATE_HZ__ with non-sync read, it is resampled to frame rate
+ *
+ * @param[in]   unFuncMode      opened functions
+ * @param[out]  None
+ *
+ * @return  sample rate(Hz), __GS_SAMPLE_RATE_HZ__ when no function has frame rate
+ */
+static GU16 Gh3x2xDemoGsensorRateGet(GU32 unFuncMode)
+{
+    GU16 usSampleRateMax = 0;
+
+#if (0 == __GS_NONSYNC_READ_EN__)
+    for (GU8 uchFunCnt = 0; uchFunCnt < GH3X2X_FUNC_OFFSET_MAX; uchFunCnt ++)
+    {
+        if (g_pstGh3x2xFrameInfo[uchFunCnt] && (unFuncMode & (((GU32)1) << uchFunCnt))
+            && (usSampleRateMax < g_pstGh3x2xFrameInfo[uchFunCnt]->pstFunctionInfo->usSampleRate))
+        {
+            usSampleRateMax = g_pstGh3x2xFrameInfo[uchFunCnt]->pstFunctionInfo->usSampleRate;
+        }
+    }
+#endif
+    return usSampleRateMax ? usSampleRateMax : __GS_SAMPLE_RATE_HZ__;
+}
+#endif
+
 
 
 
@@ -2676,6 +4650,14 @@ void GH3x2xMaserControlFunctionLog(GU32 unFuncMode, EMUprotocolParseCmdType emCm
 void Gh3x2xDemoSamplingControl(GU32 unFuncMode, EMUprotocolParseCmdType emSwitch)
 {
 
+    GH3X2X_DRV_LOCK();
+#if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+    if (Gh3x2xDemoChipResetRecoveryLatch(unFuncMode, emSwitch, 0))
+    {
+        GH3X2X_DRV_UNLOCK();
+        return;
+    }
+#endif
     if ((GH3X2X_GetConfigFuncMode() & unFuncMode) != unFuncMode)
     {
         EXAMPLE_LOG("[%s]:config has no target function!!!config function = 0x%08x,unFuncMode = 0x%08x\r\n", __FUNCTION__, GH3X2X_GetConfigFuncMode(),unFuncMode);
@@ -2683,11 +4665,16 @@ void Gh3x2xDemoSamplingControl(GU32 unFuncMode, EMUprotocolParseCmdType emSwitch
     }
     if(unFuncMode == 0)
     {
+        GH3X2X_DRV_UNLOCK();
         return;
     }
     #if (__FUNC_TYPE_ECG_ENABLE__)
     GU8 uchEcgCtrlFlag = 0;
     #endif
+    #if (__GH3X2X_REG_SHADOW_EN__)
+    STGh3x2xRegShadowStat stRegShadowStat;
+    Gh3x2xRegShadowGetStat(&stRegShadowStat);
+    #endif
     #if __GS_NONSYNC_READ_EN__
     GU16 usTempFunction;
     #endif
@@ -2792,6 +4779,9 @@ void Gh3x2xDemoSamplingControl(GU32 unFuncMode, EMUprotocolParseCmdType emSwitch
 #endif
         if (GH3X2X_GetGsensorEnableFlag() && (GH3X2X_NO_FUNCTION == g_unDemoFuncMode))
         {
+#if (__GS_ZEPHYR_SENSOR_EN__)
+            hal_gsensor_rate_update(Gh3x2xDemoGsensorRateGet(unFuncMode));
+#endif
             hal_gsensor_start_cache_data();
         }
 #if (__CAP_ENABLE__)
@@ -2877,6 +4867,25 @@ void Gh3x2xDemoSamplingControl(GU32 unFuncMode, EMUprotocolParseCmdType emSwitch
     }
     GH3X2X_SetSoftEvent(GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO);  //need force read fifo after setting watermark
 #endif
+#if (__GH3X2X_FIFO_WM_ADAPTIVE_EN__)
+    Gh3x2xDemoFifoWmAdaptiveApply();
+    GH3X2X_SetSoftEvent(GH3X2X_SOFT_EVENT_NEED_FORCE_READ_FIFO);  //need force read fifo after setting watermark
+#endif
+#if (__POLLING_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    Gh3x2xDemoPollingUpdate();
+#endif
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+    Gh3x2xDemoTimeStampUpdate();
+#endif
+#if (__GH3X2X_FIFO_DEMUX_EN__)
+    Gh3x2xDemoFifoDemuxRouteUpdate();
+#endif
+#if (__GS_ZEPHYR_SENSOR_EN__)
+    if (GH3X2X_GetGsensorEnableFlag() && (GH3X2X_NO_FUNCTION != g_unDemoFuncMode))
+    {
+        hal_gsensor_rate_update(Gh3x2xDemoGsensorRateGet(g_unDemoFuncMode));
+    }
+#endif
 
 
 
@@ -2924,10 +4933,50 @@ void Gh3x2xDemoSamplingControl(GU32 unFuncMode, EMUprotocolParseCmdType emSwitch
     }
 #endif
 
+#if (__GH3X2X_REG_SHADOW_EN__)
+    Gh3x2xRegShadowStatLog((UPROTOCOL_CMD_START == emSwitch) ? "sampling start" : "sampling stop", &stRegShadowStat);
+#endif
+#if (__GH3X2X_BUS_STAT_EN__)
+    if (UPROTOCOL_CMD_STOP == emSwitch)
+    {
+        Gh3x2xBusStatDump();
+    }
+#endif
+#if (__GH3X2X_STAGE_PROF_EN__)
+    if (UPROTOCOL_CMD_STOP == emSwitch)
+    {
+        Gh3x2xStageProfDump();
+    }
+#endif
+#if (__GH3X2X_INT_PIPELINE_EN__)
+    if (UPROTOCOL_CMD_STOP == emSwitch)
+    {
+        STGh3x2xPipelineStat stPipelineStat;
+
+        Gh3x2xDemoPipelineDropQueued();
+        Gh3x2xDemoPipelineGetStat(&stPipelineStat);
+        EXAMPLE_LOG("[Pipeline]push = %d, pop = %d, overrun = %d, stale = %d, depth = %d, max depth = %d\r\n",
+                    (int)stPipelineStat.unPushCnt, (int)stPipelineStat.unPopCnt, (int)stPipelineStat.unOverrunCnt,
+                    (int)stPipelineStat.unStaleCnt, (int)stPipelineStat.usDepth, (int)stPipelineStat.usMaxDepth);
+    }
+#endif
+
+#if (__GH3X2X_FIFO_DECODE_EN__)
+    if (UPROTOCOL_CMD_STOP == emSwitch)
+    {
+        Gh3x2xFifoDecodeStatLog();
+    }
+#endif
+
     if(GH3X2X_GetSoftEvent()&&(0 == g_uchGh3x2xInterruptProNotFinishFlag))   //avoid nesting
     {
+    #if (__GH3X2X_SOFT_EVENT_DISPATCH_EN__)
+        hal_gh3x2x_soft_event_post();   //int process runs in int work queue, not in caller thread
+    #else
         Gh3x2xDemoInterruptProcess();
+    #endif
     }
+    GH3X2X_DRV_UNLOCK();
 }
 
 #if (__SUPPORT_HARD_ADT_CONFIG__)
@@ -3253,8 +5302,17 @@ void Gh3x2xDemoStartAlgoInner(GU32 unFuncMode)
  */
 void Gh3x2xDemoStartSampling(GU32 unFuncMode)
 {
+    GH3X2X_DRV_LOCK();
+#if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+    if (Gh3x2xDemoChipResetRecoveryLatch(unFuncMode, UPROTOCOL_CMD_START, 1))
+    {
+        GH3X2X_DRV_UNLOCK();
+        return;
+    }
+#endif
     Gh3x2xDemoStartSamplingInner(unFuncMode, 0);
     Gh3x2xDemoStartAlgoInner(unFuncMode);
+    GH3X2X_DRV_UNLOCK();
 }
 
 /**
@@ -3273,12 +5331,14 @@ void Gh3x2xDemoStartSampling(GU32 unFuncMode)
  */
 void Gh3x2xDemoStartSamplingWithCfgSwitch(GU32 unFuncMode, GU8 uchArrayCfgIndex)
 {
+    GH3X2X_DRV_LOCK();
     if (uchArrayCfgIndex == DRV_LIB_REG_CFG_EMPTY)
     {
         EXAMPLE_LOG("[%s]:Array None!!!\r\n", __FUNCTION__);
     }
     Gh3x2xDemoArrayCfgSwitch(uchArrayCfgIndex);
     Gh3x2xDemoStartSamplingInner(unFuncMode, 1);
+    GH3X2X_DRV_UNLOCK();
 }
 
 
@@ -3302,11 +5362,13 @@ void Gh3x2xDemoStartSamplingWithCfgSwitch(GU32 unFuncMode, GU8 uchArrayCfgIndex)
  */
 void Gh3x2xDemoStartSamplingForEngineeringMode(GU32 unFuncMode, GU8 uchArrayCfgIndex, STGh3x2xEngineeringModeSampleParam *pstSampleParaGroup , GU8 uchSampleParaGroupNum)
 {
+    GH3X2X_DRV_LOCK();
     Gh3x2xDemoArrayCfgSwitch(uchArrayCfgIndex);
     g_pstSampleParaGroup = pstSampleParaGroup;
     g_uchEngineeringModeSampleParaGroupNum = uchSampleParaGroupNum;
     g_uchEngineeringModeStatus = 1;
     Gh3x2xDemoStartSamplingInner(unFuncMode, 1);
+    GH3X2X_DRV_UNLOCK();
 }
 #else
 void Gh3x2xDemoStartSamplingForEngineeringMode(GU32 unFuncMode, GU8 uchArrayCfgIndex, STGh3x2xEngineeringModeSampleParam *pstSampleParaGroup , GU8 uchSampleParaGroupNum){}
@@ -3362,8 +5424,17 @@ void Gh3x2xDemoStopAlgoInner(GU32 unFuncMode)
 
 void Gh3x2xDemoStopSampling(GU32 unFuncMode)
 {
+    GH3X2X_DRV_LOCK();
+#if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+    if (Gh3x2xDemoChipResetRecoveryLatch(unFuncMode, UPROTOCOL_CMD_STOP, 1))
+    {
+        GH3X2X_DRV_UNLOCK();
+        return;
+    }
+#endif
     Gh3x2xDemoStopSamplingInner(unFuncMode);
     Gh3x2xDemoStopAlgoInner(unFuncMode);
+    GH3X2X_DRV_UNLOCK();
 }
 
 
@@ -3407,6 +5478,7 @@ void GH3X2X_RedetectWearOn(void)
  */
 void Gh3x2xDemoStopSamplingForEngineeringMode(void)
 {
+    GH3X2X_DRV_LOCK();
     Gh3x2xDemoStopSamplingInner(g_unDemoFuncMode);
 
     Gh3x2xDemoSamplingControl(0xFFFFFFFF, UPROTOCOL_CMD_STOP);
@@ -3438,6 +5510,7 @@ void Gh3x2xDemoStopSamplingForEngineeringMode(void)
     Gh3x2xFunctionCtrlModuleInit();
 
     g_uchEngineeringModeStatus = 0;
+    GH3X2X_DRV_UNLOCK();
 }
 #endif
 
@@ -3465,7 +5538,9 @@ void Gh3x2xDemoMoveDetectTimerHandler(void)
     GH3X2X_MoveDetectByCapData(cap_soft_fifo_buffer, cap_soft_fifo_buffer_index);
     //check GS
     hal_gsensor_drv_get_fifo_data(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__, &gsensor_soft_fifo_buffer_index);
+    #if !(__GS_INGEST_BY_HAL__)
     Gh3x2x_NormalizeGsensorSensitivity(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__,gsensor_soft_fifo_buffer_index);
+    #endif
     GH3X2X_MoveDetectByGsData((GS16*)(gsensor_soft_fifo_buffer + __GS_EXTRA_BUF_LEN__), gsensor_soft_fifo_buffer_index);
     if (GH3X2X_GetSoftWearOffDetEn())
     {
@@ -3492,18 +5567,21 @@ void Gh3x2xDemoSetFuncionFrequency(GU8 uchFunctionID, GU16 usFrequencyValue)
 {
     GU32 unFuncModeTemp = 0;
     
+    GH3X2X_DRV_LOCK();
     GH3X2X_DecodeRegCfgArr(&unFuncModeTemp, (g_stGh3x2xCfgListArr + g_uchGh3x2xRegCfgArrIndex)->pstRegConfigArr, \
                             (g_stGh3x2xCfgListArr + g_uchGh3x2xRegCfgArrIndex)->usConfigArrLen);
     
     if (((1 << uchFunctionID) & unFuncModeTemp) == 0)
     {
         EXAMPLE_LOG("[%s]:Current cfg cannot support !!! cfgfunc = 0x%x, selectfuncs = 0x%x\r\n", __FUNCTION__, (int)unFuncModeTemp, (1 << uchFunctionID));
+        GH3X2X_DRV_UNLOCK();
         return;
     }
 
     if (usFrequencyValue % 25 || usFrequencyValue > 1000)
     {
         EXAMPLE_LOG("[%s]:The SR is not a multiple of 25!!!srvalue = %d\r\n", __FUNCTION__, usFrequencyValue);
+        GH3X2X_DRV_UNLOCK();
         return;
     }
     
@@ -3525,6 +5603,7 @@ void Gh3x2xDemoSetFuncionFrequency(GU8 uchFunctionID, GU16 usFrequencyValue)
         Gh3x2xDemoStartSampling(unDemoFuncModeBeforeChipReset);
         EXAMPLE_LOG("[%s]:Restart.\r\n", __FUNCTION__);
     }
+    GH3X2X_DRV_UNLOCK();
 }
 
 /**
@@ -3545,17 +5624,20 @@ void Gh3x2xDemoSetFuncionLedCurrent(GU8 uchFunctionID, GU16 usLedDrv0Current, GU
 {
     GU32 unFuncModeTemp = 0;
     
+    GH3X2X_DRV_LOCK();
     GH3X2X_DecodeRegCfgArr(&unFuncModeTemp, (g_stGh3x2xCfgListArr + g_uchGh3x2xRegCfgArrIndex)->pstRegConfigArr, \
                             (g_stGh3x2xCfgListArr + g_uchGh3x2xRegCfgArrIndex)->usConfigArrLen);
 
     if (((1 << uchFunctionID) & unFuncModeTemp) == 0)
     {
         EXAMPLE_LOG("[%s]:Current cfg cannot support !!! cfgfunc = 0x%x, selectfuncs = 0x%x\r\n", __FUNCTION__, (int)unFuncModeTemp, (1 << uchFunctionID));
+        GH3X2X_DRV_UNLOCK();
         return;
     }
 
     GH3X2X_ModifyFunctionLedCurrent(uchFunctionID, usLedDrv0Current, usLedDrv1Current);
     EXAMPLE_LOG("[%s]:Change led current !!! func = 0x%x, drv0 current = %d, drv1 current = %d\r\n",  __FUNCTION__, (1 << uchFunctionID), (int)usLedDrv0Current, (int)usLedDrv1Current);
+    GH3X2X_DRV_UNLOCK();
 }
 
 
@@ -0,0 +1,184 @@
+/**
+ * @copyright (c) 2003 - 2022, Goodix Co., Ltd. All rights reserved.
+ *
+ * @file    gh3x2x_demo_benchmark.c
+ *
+ * @brief   gh3x2x driver lib demo code for benchmark harness and shell cmd gh3x2x_bench
+ *
+ * @author  Gooidx Iot Team
+ *
+ */
+#include "stdint.h"
+#include "string.h"
+#include "gh3x2x_demo_inner.h"
+
+#if (__GH3X2X_BENCHMARK_EN__)
+
+#include <zephyr/kernel.h>
+#if defined(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+/**
+ * @fn     GU32 Gh3x2xBenchmarkRun(const GCHAR *pchName, void (*pCaseFunc)(void *pvArg), void *pvArg,
+ *                                 GU16 usLoopNum, GU32 unUnitNum, const GCHAR *pchUnit)
+ *
+ * @brief  run one benchmark case usLoopNum times, log cycles per loop and per unit and stack high-water
+ *
+ * @attention   stack high-water is lifetime min of unused stack of current thread(need CONFIG_THREAD_STACK_INFO
+ *              and CONFIG_INIT_STACKS), so run case with less stack first
+ *
+ * @param[in]   pchName         case name
+ * @param[in]   pCaseFunc       case function, called usLoopNum times
+ * @param[in]   pvArg           arg of case function
+ * @param[in]   usLoopNum       run times, case is not run when 0
+ * @param[in]   unUnitNum       units(word, point, byte...) handled in one run
+ * @param[in]   pchUnit         unit name
+ * @param[out]  None
+ *
+ * @return  cycles per loop, 0 when usLoopNum is 0
+ */
+GU32 Gh3x2xBenchmarkRun(const GCHAR *pchName, void (*pCaseFunc)(void *pvArg), void *pvArg,
+                        GU16 usLoopNum, GU32 unUnitNum, const GCHAR *pchUnit)
+{
+    GU32 unCycle = 0;
+    GU32 unCentiCyclePerUnit = 0;
+    size_t unStackUnused = 0;
+
+    if (0 == usLoopNum)
+    {
+        EXAMPLE_LOG("[Bench]%s: loop num is 0, not run\r\n", pchName);
+        return 0;
+    }
+    Gh3x2xCycleCntInit();
+    unCycle = Gh3x2xCycleCntGet();
+    for (GU16 usLoopCnt = 0; usLoopCnt < usLoopNum; usLoopCnt++)
+    {
+        pCaseFunc(pvArg);
+    }
+    unCycle = Gh3x2xCycleCntGet() - unCycle;
+    unCentiCyclePerUnit = (GU32)(((uint64_t)unCycle * 100) / ((uint64_t)usLoopNum * (unUnitNum ? unUnitNum : 1)));
+    unCycle /= usLoopNum;
+#if defined(CONFIG_THREAD_STACK_INFO)
+    k_thread_stack_space_get(k_current_get(), &unStackUnused);
+#endif
+    EXAMPLE_LOG("[Bench]%s: %u cycles(%u us)/loop, %u.%02u cycles/%s, stack unused %u\r\n", pchName,
+                (unsigned int)unCycle, (unsigned int)Gh3x2xCycleToUs(unCycle),
+                (unsigned int)(unCentiCyclePerUnit / 100), (unsigned int)(unCentiCyclePerUnit % 100), pchUnit,
+                (unsigned int)unStackUnused);
+    return unCycle;
+}
+
+/**
+ * @fn     void Gh3x2xBenchmarkFill(void *pvData, GU32 unByteNum)
+ *
+ * @brief  fill benchmark input with xorshift32 sequence, same data every call
+ *
+ * @attention   None
+ *
+ * @param[in]   unByteNum       byte num
+ * @param[out]  pvData          data to fill
+ *
+ * @return  None
+ */
+void Gh3x2xBenchmarkFill(void *pvData, GU32 unByteNum)
+{
+    GU8 *puchData = (GU8 *)pvData;
+    GU32 unSeed = 0x2545F491;
+
+    for (GU32 unByteCnt = 0; unByteCnt < unByteNum; unByteCnt++)
+    {
+        unSeed ^= unSeed << 13;
+        unSeed ^= unSeed >> 17;
+        unSeed ^= unSeed << 5;
+        puchData[unByteCnt] = (GU8)unSeed;
+    }
+}
+
+/**
+ * @fn     GU8 Gh3x2xBenchmarkCheck(const GCHAR *pchName, const void *pvRef, const void *pvKernel, GU32 unByteNum)
+ *
+ * @brief  log whether kernel output is bit-for-bit same as c reference
+ *
+ * @attention   None
+ *
+ * @param[in]   pchName         benchmark name
+ * @param[in]   pvRef           output of c reference
+ * @param[in]   pvKernel        output of kernel
+ * @param[in]   unByteNum       byte num of output
+ * @param[out]  None
+ *
+ * @return  1: match  0: not match
+ */
+GU8 Gh3x2xBenchmarkCheck(const GCHAR *pchName, const void *pvRef, const void *pvKernel, GU32 unByteNum)
+{
+    GU8 uchMatch = (0 == memcmp(pvRef, pvKernel, unByteNum));
+
+    EXAMPLE_LOG("[Bench]%s kernel output %s c reference\r\n", pchName, uchMatch ? "matches" : "DOES NOT match");
+    return uchMatch;
+}
+
+#if defined(CONFIG_SHELL)
+
+/* subcmd of every benchmark is empty when it is not built, #if is not allowed in macro args */
+#if (__GH3X2X_SPI_BENCHMARK_EN__)
+static int Gh3x2xBenchmarkShellSpi(const struct shell *pstShell, size_t unArgc, char **ppchArgv)
+{
+    Gh3x2xSpiFifoReadBenchmark();
+    return 0;
+}
+#define GH3X2X_BENCHMARK_SHELL_CMD_SPI \
+    SHELL_CMD(spi, NULL, "fifo read, zero-copy vs stack+copy(chip should be inited)", Gh3x2xBenchmarkShellSpi),
+#else
+#define GH3X2X_BENCHMARK_SHELL_CMD_SPI
+#endif
+
+#if (__GH3X2X_FIFO_DECODE_BENCHMARK_EN__)
+static int Gh3x2xBenchmarkShellDecode(const struct shell *pstShell, size_t unArgc, char **ppchArgv)
+{
+    Gh3x2xFifoDecodeBenchmark();
+    return 0;
+}
+#define GH3X2X_BENCHMARK_SHELL_CMD_DECODE \
+    SHELL_CMD(decode, NULL, "fifo word decode, kernel vs c reference", Gh3x2xBenchmarkShellDecode),
+#else
+#define GH3X2X_BENCHMARK_SHELL_CMD_DECODE
+#endif
+
+#if (__GH3X2X_GS_INGEST_BENCHMARK_EN__)
+static int Gh3x2xBenchmarkShellIngest(const struct shell *pstShell, size_t unArgc, char **ppchArgv)
+{
+    Gh3x2xGsensorIngestBenchmark();
+    return 0;
+}
+#define GH3X2X_BENCHMARK_SHELL_CMD_INGEST \
+    SHELL_CMD(ingest, NULL, "gsensor ingest of 300 points, two pass vs kernel vs c reference", Gh3x2xBenchmarkShellIngest),
+#else
+#define GH3X2X_BENCHMARK_SHELL_CMD_INGEST
+#endif
+
+#if (__GH3X2X_MOVE_DETECT_BENCHMARK_EN__) && (__SUPPORT_HARD_ADT_CONFIG__)
+static int Gh3x2xBenchmarkShellMove(const struct shell *pstShell, size_t unArgc, char **ppchArgv)
+{
+    Gh3x2xGsMoveDetectBenchmark();
+    return 0;
+}
+#define GH3X2X_BENCHMARK_SHELL_CMD_MOVE \
+    SHELL_CMD(move, NULL, "soft adt move detect of 25/50/100Hz blocks, kernel vs c reference", Gh3x2xBenchmarkShellMove),
+#else
+#define GH3X2X_BENCHMARK_SHELL_CMD_MOVE
+#endif
+
+SHELL_STATIC_SUBCMD_SET_CREATE(g_stGh3x2xBenchmarkShellCmd,
+    GH3X2X_BENCHMARK_SHELL_CMD_SPI
+    GH3X2X_BENCHMARK_SHELL_CMD_DECODE
+    GH3X2X_BENCHMARK_SHELL_CMD_INGEST
+    GH3X2X_BENCHMARK_SHELL_CMD_MOVE
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(gh3x2x_bench, &g_stGh3x2xBenchmarkShellCmd, "gh3x2x benchmarks, result is logged", NULL);
+
+#endif
+
+#endif
@@ -0,0 +1,361 @@
+/**
+ * @copyright (c) 2003 - 2022, Goodix Co., Ltd. All rights reserved.
+ *
+ * @file    gh3x2x_demo_bus_stat.c
+ *
+ * @brief   gh3x2x driver lib demo code for bus transfer statistics
+ *
+ * @author  Gooidx Iot Team
+ *
+ */
+#include "stdint.h"
+#include "string.h"
+#include "gh3x2x_demo_inner.h"
+
+#if (__GH3X2X_BUS_STAT_EN__)
+
+#include <zephyr/kernel.h>
+#include <soc.h>
+#if defined(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+#define GH3X2X_BUS_STAT_REG_RANGE_NUM       (8)         /**< 0x00xx ~ 0x07xx, one range per addr high byte */
+#define GH3X2X_BUS_STAT_RANGE_FIFO          (GH3X2X_BUS_STAT_REG_RANGE_NUM)
+#define GH3X2X_BUS_STAT_RANGE_OTHER         (GH3X2X_BUS_STAT_REG_RANGE_NUM + 1)
+#define GH3X2X_BUS_STAT_RANGE_CMD           (GH3X2X_BUS_STAT_REG_RANGE_NUM + 2)
+#define GH3X2X_BUS_STAT_RANGE_NUM           (GH3X2X_BUS_STAT_REG_RANGE_NUM + 3)
+#define GH3X2X_BUS_STAT_FIFO_ADDR           (0xAAAA)    /**< fifo data addr */
+#define GH3X2X_BUS_STAT_HOT_REG_NUM         (48)        /**< regs tracked one by one */
+#define GH3X2X_BUS_STAT_HOT_REG_DUMP_NUM    (10)        /**< hottest regs in dump */
+
+/// counter of transfers
+typedef struct
+{
+    GU32 unXferCnt;
+    GU32 unByteCnt;
+    uint64_t ullCycleCnt;
+} STGh3x2xBusStatCnt;
+
+/// counter of one reg
+typedef struct
+{
+    GU16 usRegAddr;
+    GU8 uchIsCmd;
+    STGh3x2xBusStatCnt stCnt;
+} STGh3x2xBusStatReg;
+
+static const GCHAR *const g_pszGh3x2xBusPhaseName[GH3X2X_BUS_PHASE_NUM] =
+{
+    "other", "irq_status", "wear", "fifo_cnt", "fifo_read", "process",
+    "agc", "chip_reset", "low_power", "cfg_load", "prefetch",
+};
+
+static const GCHAR *const g_pszGh3x2xBusRangeName[GH3X2X_BUS_STAT_RANGE_NUM] =
+{
+    "0x00xx", "0x01xx", "0x02xx", "0x03xx", "0x04xx", "0x05xx", "0x06xx", "0x07xx",
+    "fifo", "other", "cmd",
+};
+
+/// phase that following transfers are counted to
+static volatile EMGh3x2xBusPhase g_emGh3x2xBusPhase = GH3X2X_BUS_PHASE_OTHER;
+
+/// counter of every phase and addr range
+static STGh3x2xBusStatCnt g_stGh3x2xBusStatCnt[GH3X2X_BUS_PHASE_NUM][GH3X2X_BUS_STAT_RANGE_NUM];
+
+/// counter of every reg, first come first tracked
+static STGh3x2xBusStatReg g_stGh3x2xBusStatReg[GH3X2X_BUS_STAT_HOT_REG_NUM];
+static GU8 g_uchGh3x2xBusStatRegNum = 0;
+
+/// transfers not tracked by reg because reg table is full
+static GU32 g_unGh3x2xBusStatRegMissCnt = 0;
+
+/**
+ * @fn     static void Gh3x2xBusStatCntAdd(STGh3x2xBusStatCnt *pstCnt, GU16 usByteNum, GU32 unCycle)
+ *
+ * @brief  add one transfer to counter
+ *
+ * @attention   None
+ *
+ * @param[in]   pstCnt      counter
+ * @param[in]   usByteNum   bytes on bus
+ * @param[in]   unCycle     cpu cycles of transfer
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xBusStatCntAdd(STGh3x2xBusStatCnt *pstCnt, GU16 usByteNum, GU32 unCycle)
+{
+    pstCnt->unXferCnt++;
+    pstCnt->unByteCnt += usByteNum;
+    pstCnt->ullCycleCnt += unCycle;
+}
+
+/**
+ * @fn     static GU8 Gh3x2xBusStatRangeGet(GU16 usRegAddr, GU8 uchIsCmd)
+ *
+ * @brief  get addr range index of reg
+ *
+ * @attention   None
+ *
+ * @param[in]   usRegAddr   reg addr
+ * @param[in]   uchIsCmd    1: usRegAddr is cmd
+ * @param[out]  None
+ *
+ * @return  range index
+ */
+static GU8 Gh3x2xBusStatRangeGet(GU16 usRegAddr, GU8 uchIsCmd)
+{
+    if (uchIsCmd)
+    {
+        return GH3X2X_BUS_STAT_RANGE_CMD;
+    }
+    if (GH3X2X_BUS_STAT_FIFO_ADDR == usRegAddr)
+    {
+        return GH3X2X_BUS_STAT_RANGE_FIFO;
+    }
+    if ((usRegAddr >> 8) < GH3X2X_BUS_STAT_REG_RANGE_NUM)
+    {
+        return (GU8)(usRegAddr >> 8);
+    }
+    return GH3X2X_BUS_STAT_RANGE_OTHER;
+}
+
+/**
+ * @fn     EMGh3x2xBusPhase Gh3x2xBusStatPhaseSet(EMGh3x2xBusPhase emPhase)
+ *
+ * @brief  set phase that following bus transfers are counted to
+ *
+ * @attention   None
+ *
+ * @param[in]   emPhase     new phase
+ * @param[out]  None
+ *
+ * @return  phase before
+ */
+EMGh3x2xBusPhase Gh3x2xBusStatPhaseSet(EMGh3x2xBusPhase emPhase)
+{
+    EMGh3x2xBusPhase emPhaseBak = g_emGh3x2xBusPhase;
+
+    g_emGh3x2xBusPhase = emPhase;
+    return emPhaseBak;
+}
+
+/**
+ * @fn     EMGh3x2xBusPhase Gh3x2xBusStatPhaseGet(void)
+ *
+ * @brief  get phase that bus transfers are counted to
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  current phase
+ */
+EMGh3x2xBusPhase Gh3x2xBusStatPhaseGet(void)
+{
+    return g_emGh3x2xBusPhase;
+}
+
+/**
+ * @fn     void Gh3x2xBusStatRecord(EMGh3x2xBusPhase emPhase, GU16 usRegAddr, GU8 uchIsCmd, GU16 usByteNum, GU32 unCycle)
+ *
+ * @brief  count one bus transfer, called by hal
+ *
+ * @attention   hal may be called by int process and fifo prefetch thread, counters are updated with irq locked
+ *
+ * @param[in]   emPhase     phase of transfer
+ * @param[in]   usRegAddr   reg addr of transfer, or cmd if uchIsCmd
+ * @param[in]   uchIsCmd    1: transfer is cmd without reg addr
+ * @param[in]   usByteNum   bytes on bus
+ * @param[in]   unCycle     cpu cycles from start to end of transfer
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xBusStatRecord(EMGh3x2xBusPhase emPhase, GU16 usRegAddr, GU8 uchIsCmd, GU16 usByteNum, GU32 unCycle)
+{
+    unsigned int unIrqKey = irq_lock();
+    GU8 uchRegCnt = 0;
+
+    if (emPhase >= GH3X2X_BUS_PHASE_NUM)
+    {
+        emPhase = GH3X2X_BUS_PHASE_OTHER;
+    }
+    Gh3x2xBusStatCntAdd(&g_stGh3x2xBusStatCnt[emPhase][Gh3x2xBusStatRangeGet(usRegAddr, uchIsCmd)],
+                        usByteNum, unCycle);
+
+    for (uchRegCnt = 0; uchRegCnt < g_uchGh3x2xBusStatRegNum; uchRegCnt++)
+    {
+        if ((g_stGh3x2xBusStatReg[uchRegCnt].usRegAddr == usRegAddr)
+            && (g_stGh3x2xBusStatReg[uchRegCnt].uchIsCmd == uchIsCmd))
+        {
+            break;
+        }
+    }
+    if (uchRegCnt == g_uchGh3x2xBusStatRegNum)
+    {
+        if (g_uchGh3x2xBusStatRegNum < GH3X2X_BUS_STAT_HOT_REG_NUM)
+        {
+            g_stGh3x2xBusStatReg[uchRegCnt].usRegAddr = usRegAddr;
+            g_stGh3x2xBusStatReg[uchRegCnt].uchIsCmd = uchIsCmd;
+            g_uchGh3x2xBusStatRegNum++;
+        }
+        else
+        {
+            g_unGh3x2xBusStatRegMissCnt++;
+            irq_unlock(unIrqKey);
+            return;
+        }
+    }
+    Gh3x2xBusStatCntAdd(&g_stGh3x2xBusStatReg[uchRegCnt].stCnt, usByteNum, unCycle);
+    irq_unlock(unIrqKey);
+}
+
+/**
+ * @fn     void Gh3x2xBusStatReset(void)
+ *
+ * @brief  clear bus statistics
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xBusStatReset(void)
+{
+    unsigned int unIrqKey = irq_lock();
+
+    memset(g_stGh3x2xBusStatCnt, 0, sizeof(g_stGh3x2xBusStatCnt));
+    memset(g_stGh3x2xBusStatReg, 0, sizeof(g_stGh3x2xBusStatReg));
+    g_uchGh3x2xBusStatRegNum = 0;
+    g_unGh3x2xBusStatRegMissCnt = 0;
+    irq_unlock(unIrqKey);
+}
+
+/**
+ * @fn     static GU32 Gh3x2xBusStatCycleToUs(uint64_t ullCycle)
+ *
+ * @brief  convert accumulated cpu cycles to us
+ *
+ * @attention   None
+ *
+ * @param[in]   ullCycle    cpu cycles
+ * @param[out]  None
+ *
+ * @return  us
+ */
+static GU32 Gh3x2xBusStatCycleToUs(uint64_t ullCycle)
+{
+    return (GU32)(ullCycle / (SystemCoreClock / 1000000));
+}
+
+/**
+ * @fn     void Gh3x2xBusStatDump(void)
+ *
+ * @brief  log bus statistics per phase, per reg addr range and hottest regs
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xBusStatDump(void)
+{
+    static STGh3x2xBusStatCnt stPhaseCnt[GH3X2X_BUS_PHASE_NUM][GH3X2X_BUS_STAT_RANGE_NUM];
+    static STGh3x2xBusStatReg stRegCnt[GH3X2X_BUS_STAT_HOT_REG_NUM];
+    GU8 uchRegNum = 0;
+    GU32 unRegMissCnt = 0;
+    unsigned int unIrqKey = irq_lock();
+
+    /* log from a copy, counters go on while logging */
+    memcpy(stPhaseCnt, g_stGh3x2xBusStatCnt, sizeof(stPhaseCnt));
+    memcpy(stRegCnt, g_stGh3x2xBusStatReg, sizeof(stRegCnt));
+    uchRegNum = g_uchGh3x2xBusStatRegNum;
+    unRegMissCnt = g_unGh3x2xBusStatRegMissCnt;
+    irq_unlock(unIrqKey);
+
+    EXAMPLE_LOG("[BusStat]phase/range: xfer, bytes, us\r\n");
+    for (GU8 uchPhase = 0; uchPhase < GH3X2X_BUS_PHASE_NUM; uchPhase++)
+    {
+        STGh3x2xBusStatCnt stTotal = {0};
+
+        for (GU8 uchRange = 0; uchRange < GH3X2X_BUS_STAT_RANGE_NUM; uchRange++)
+        {
+            stTotal.unXferCnt += stPhaseCnt[uchPhase][uchRange].unXferCnt;
+            stTotal.unByteCnt += stPhaseCnt[uchPhase][uchRange].unByteCnt;
+            stTotal.ullCycleCnt += stPhaseCnt[uchPhase][uchRange].ullCycleCnt;
+        }
+        if (0 == stTotal.unXferCnt)
+        {
+            continue;
+        }
+        EXAMPLE_LOG("[BusStat]%s: %u, %u, %u\r\n", g_pszGh3x2xBusPhaseName[uchPhase], (unsigned int)stTotal.unXferCnt,
+                    (unsigned int)stTotal.unByteCnt, (unsigned int)Gh3x2xBusStatCycleToUs(stTotal.ullCycleCnt));
+        for (GU8 uchRange = 0; uchRange < GH3X2X_BUS_STAT_RANGE_NUM; uchRange++)
+        {
+            STGh3x2xBusStatCnt *pstCnt = &stPhaseCnt[uchPhase][uchRange];
+
+            if (pstCnt->unXferCnt)
+            {
+                EXAMPLE_LOG("[BusStat]  %s: %u, %u, %u\r\n", g_pszGh3x2xBusRangeName[uchRange],
+                            (unsigned int)pstCnt->unXferCnt, (unsigned int)pstCnt->unByteCnt,
+                            (unsigned int)Gh3x2xBusStatCycleToUs(pstCnt->ullCycleCnt));
+            }
+        }
+    }
+
+    /* hottest regs by transfer count, selection over the copy */
+    EXAMPLE_LOG("[BusStat]hot reg: xfer, bytes, us (untracked xfer %u)\r\n", (unsigned int)unRegMissCnt);
+    for (GU8 uchDumpCnt = 0; (uchDumpCnt < GH3X2X_BUS_STAT_HOT_REG_DUMP_NUM) && (uchDumpCnt < uchRegNum); uchDumpCnt++)
+    {
+        GU8 uchMaxIndex = uchDumpCnt;
+        STGh3x2xBusStatReg stTemp;
+
+        for (GU8 uchRegCnt = uchDumpCnt + 1; uchRegCnt < uchRegNum; uchRegCnt++)
+        {
+            if (stRegCnt[uchRegCnt].stCnt.unXferCnt > stRegCnt[uchMaxIndex].stCnt.unXferCnt)
+            {
+                uchMaxIndex = uchRegCnt;
+            }
+        }
+        stTemp = stRegCnt[uchMaxIndex];
+        stRegCnt[uchMaxIndex] = stRegCnt[uchDumpCnt];
+        stRegCnt[uchDumpCnt] = stTemp;
+        EXAMPLE_LOG("[BusStat]  %s0x%04X: %u, %u, %u\r\n", stTemp.uchIsCmd ? "cmd " : "", stTemp.usRegAddr,
+                    (unsigned int)stTemp.stCnt.unXferCnt, (unsigned int)stTemp.stCnt.unByteCnt,
+                    (unsigned int)Gh3x2xBusStatCycleToUs(stTemp.stCnt.ullCycleCnt));
+    }
+}
+
+#if defined(CONFIG_SHELL)
+
+static int Gh3x2xBusStatShellDump(const struct shell *pstShell, size_t unArgc, char **ppchArgv)
+{
+    Gh3x2xBusStatDump();
+    return 0;
+}
+
+static int Gh3x2xBusStatShellReset(const struct shell *pstShell, size_t unArgc, char **ppchArgv)
+{
+    Gh3x2xBusStatReset();
+    shell_print(pstShell, "gh3x2x bus stat cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(g_stGh3x2xBusStatShellCmd,
+    SHELL_CMD(dump, NULL, "log bus statistics", Gh3x2xBusStatShellDump),
+    SHELL_CMD(reset, NULL, "clear bus statistics", Gh3x2xBusStatShellReset),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(gh3x2x_bus, &g_stGh3x2xBusStatShellCmd, "gh3x2x bus transfer statistics", NULL);
+
+#endif
+
+#endif
@@ -0,0 +1,259 @@
+/**
+ * @copyright (c) 2003 - 2022, Goodix Co., Ltd. All rights reserved.
+ *
+ * @file    gh3x2x_demo_fifo_decode.c
+ *
+ * @brief   gh3x2x driver lib demo code for fifo word decode
+ *
+ * @author  Gooidx Iot Team
+ *
+ */
+#include "stdint.h"
+#include "string.h"
+#include "gh3x2x_demo_inner.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include <soc.h>
+#define GH3X2X_FIFO_DECODE_DSP_EN           (1)         /**< cortex-m4 dsp extension kernel */
+#else
+#define GH3X2X_FIFO_DECODE_DSP_EN           (0)
+#endif
+
+#define GH3X2X_FIFO_DECODE_ADC_CODE_MASK    (0x00FFFFFF)    /**< bit23~0: adc code */
+
+/**
+ * @fn     void Gh3x2xFifoDecodeRef(const GU8 *puchFifo, GU16 usWordNum, const STGh3x2xFifoDecodeSoa *pstOut)
+ *
+ * @brief  decode big endian fifo words to structure of arrays, portable c reference
+ *
+ * @attention   None
+ *
+ * @param[in]   puchFifo        fifo data
+ * @param[in]   usWordNum       fifo word num
+ * @param[out]  pstOut          decoded arrays, usWordNum entries each
+ *
+ * @return  None
+ */
+void Gh3x2xFifoDecodeRef(const GU8 *puchFifo, GU16 usWordNum, const STGh3x2xFifoDecodeSoa *pstOut)
+{
+    for (GU16 usWordCnt = 0; usWordCnt < usWordNum; usWordCnt++)
+    {
+        const GU8 *puchWord = &puchFifo[usWordCnt * 4];
+        GU32 unWord = ((GU32)puchWord[0] << 24) | ((GU32)puchWord[1] << 16) | ((GU32)puchWord[2] << 8) | puchWord[3];
+
+        pstOut->punAdcCode[usWordCnt] = unWord & GH3X2X_FIFO_DECODE_ADC_CODE_MASK;
+        pstOut->puchSlot[usWordCnt] = (GU8)((unWord >> 29) & 0x07);
+        pstOut->puchAdc[usWordCnt] = (GU8)((unWord >> 27) & 0x03);
+        pstOut->puchFlag[usWordCnt] = (GU8)((unWord >> 25) & 0x03);
+    }
+}
+
+/**
+ * @fn     void Gh3x2xFifoDecode(const GU8 *puchFifo, GU16 usWordNum, const STGh3x2xFifoDecodeSoa *pstOut)
+ *
+ * @brief  decode big endian fifo words to structure of arrays, four words per loop with dsp extension
+ *
+ * @attention   tag byte(slot, adc and flags) is byte 0 of every word. Tag bytes of four words are packed into
+ *              one register by PKHBT/UXTB16 and split with one shift and mask per field; adc code is REV and
+ *              mask. Same output as Gh3x2xFifoDecodeRef, which is used without dsp extension
+ *
+ * @param[in]   puchFifo        fifo data
+ * @param[in]   usWordNum       fifo word num
+ * @param[out]  pstOut          decoded arrays, usWordNum entries each
+ *
+ * @return  None
+ */
+void Gh3x2xFifoDecode(const GU8 *puchFifo, GU16 usWordNum, const STGh3x2xFifoDecodeSoa *pstOut)
+{
+#if (GH3X2X_FIFO_DECODE_DSP_EN)
+    GU16 usWordCnt = 0;
+
+    for (; (usWordCnt + 4) <= usWordNum; usWordCnt += 4)
+    {
+        const GU8 *puchWord = &puchFifo[usWordCnt * 4];
+        GU32 unWord0 = __UNALIGNED_UINT32_READ(&puchWord[0]);
+        GU32 unWord1 = __UNALIGNED_UINT32_READ(&puchWord[4]);
+        GU32 unWord2 = __UNALIGNED_UINT32_READ(&puchWord[8]);
+        GU32 unWord3 = __UNALIGNED_UINT32_READ(&puchWord[12]);
+        /* byte 0 of every word: [w0, w1, w2, w3] */
+        GU32 unTag = __UXTB16(__PKHBT(unWord0, unWord2, 16)) | (__UXTB16(__PKHBT(unWord1, unWord3, 16)) << 8);
+
+        pstOut->punAdcCode[usWordCnt + 0] = __REV(unWord0) & GH3X2X_FIFO_DECODE_ADC_CODE_MASK;
+        pstOut->punAdcCode[usWordCnt + 1] = __REV(unWord1) & GH3X2X_FIFO_DECODE_ADC_CODE_MASK;
+        pstOut->punAdcCode[usWordCnt + 2] = __REV(unWord2) & GH3X2X_FIFO_DECODE_ADC_CODE_MASK;
+        pstOut->punAdcCode[usWordCnt + 3] = __REV(unWord3) & GH3X2X_FIFO_DECODE_ADC_CODE_MASK;
+        __UNALIGNED_UINT32_WRITE(&pstOut->puchSlot[usWordCnt], (unTag >> 5) & 0x07070707);
+        __UNALIGNED_UINT32_WRITE(&pstOut->puchAdc[usWordCnt], (unTag >> 3) & 0x03030303);
+        __UNALIGNED_UINT32_WRITE(&pstOut->puchFlag[usWordCnt], (unTag >> 1) & 0x03030303);
+    }
+    if (usWordCnt < usWordNum)
+    {
+        STGh3x2xFifoDecodeSoa stTail =
+        {
+            &pstOut->punAdcCode[usWordCnt], &pstOut->puchSlot[usWordCnt], &pstOut->puchAdc[usWordCnt], &pstOut->puchFlag[usWordCnt],
+        };
+
+        Gh3x2xFifoDecodeRef(&puchFifo[usWordCnt * 4], usWordNum - usWordCnt, &stTail);
+    }
+#else
+    Gh3x2xFifoDecodeRef(puchFifo, usWordNum, pstOut);
+#endif
+}
+
+#if (__GH3X2X_FIFO_DECODE_EN__)
+
+#define GH3X2X_FIFO_DECODE_BLOCK_WORD_NUM   (__GH3X2X_RAWDATA_BUFFER_SIZE__ / 4)
+
+/// decoded arrays of current fifo block, only valid inside gh3x2x_fifo_decode_hook_func
+static GU32 g_unGh3x2xFifoDecodeAdcCode[GH3X2X_FIFO_DECODE_BLOCK_WORD_NUM];
+static GU8 g_uchGh3x2xFifoDecodeSlot[GH3X2X_FIFO_DECODE_BLOCK_WORD_NUM];
+static GU8 g_uchGh3x2xFifoDecodeAdc[GH3X2X_FIFO_DECODE_BLOCK_WORD_NUM];
+static GU8 g_uchGh3x2xFifoDecodeFlag[GH3X2X_FIFO_DECODE_BLOCK_WORD_NUM];
+
+/// decode cycles and words of fifo blocks since last Gh3x2xFifoDecodeStatLog
+static uint64_t g_ullGh3x2xFifoDecodeCycleSum = 0;
+static GU32 g_unGh3x2xFifoDecodeWordSum = 0;
+
+/**
+ * @fn     void Gh3x2xFifoDecodeBlock(const GU8 *puchFifo, GU16 usLength)
+ *
+ * @brief  decode fifo block of rawdata hook and deliver it by gh3x2x_fifo_decode_hook_func
+ *
+ * @attention   decode cycles are added to statistics logged by Gh3x2xFifoDecodeStatLog
+ *
+ * @param[in]   puchFifo        fifo data
+ * @param[in]   usLength        fifo data length in byte
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xFifoDecodeBlock(const GU8 *puchFifo, GU16 usLength)
+{
+    const STGh3x2xFifoDecodeSoa stFifoDecode =
+    {
+        g_unGh3x2xFifoDecodeAdcCode, g_uchGh3x2xFifoDecodeSlot, g_uchGh3x2xFifoDecodeAdc, g_uchGh3x2xFifoDecodeFlag,
+    };
+    GU16 usWordNum = usLength / 4;
+    GU32 unCycle;
+
+    if (usWordNum > GH3X2X_FIFO_DECODE_BLOCK_WORD_NUM)
+    {
+        usWordNum = GH3X2X_FIFO_DECODE_BLOCK_WORD_NUM;      //fifo block is never bigger than rawdata buffer
+    }
+    unCycle = Gh3x2xCycleCntGet();
+    Gh3x2xFifoDecode(puchFifo, usWordNum, &stFifoDecode);
+    unCycle = Gh3x2xCycleCntGet() - unCycle;
+    g_ullGh3x2xFifoDecodeCycleSum += unCycle;
+    g_unGh3x2xFifoDecodeWordSum += usWordNum;
+
+    gh3x2x_fifo_decode_hook_func(&stFifoDecode, usWordNum);
+}
+
+/**
+ * @fn     void Gh3x2xFifoDecodeStatLog(void)
+ *
+ * @brief  log decode cycles/word of fifo blocks since last log, and clear statistics
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xFifoDecodeStatLog(void)
+{
+    if (0 != g_unGh3x2xFifoDecodeWordSum)
+    {
+        GU32 unCyclePerWordX100 = (GU32)(g_ullGh3x2xFifoDecodeCycleSum * 100 / g_unGh3x2xFifoDecodeWordSum);
+
+        EXAMPLE_LOG("[FifoDecode]%s, word = %d, cycles/word = %d.%02d\r\n",
+                    (GH3X2X_FIFO_DECODE_DSP_EN) ? "dsp kernel" : "c reference", (int)g_unGh3x2xFifoDecodeWordSum,
+                    (int)(unCyclePerWordX100 / 100), (int)(unCyclePerWordX100 % 100));
+    }
+    g_ullGh3x2xFifoDecodeCycleSum = 0;
+    g_unGh3x2xFifoDecodeWordSum = 0;
+}
+
+#endif
+
+#if (__GH3X2X_FIFO_DECODE_BENCHMARK_EN__)
+
+#define GH3X2X_FIFO_DECODE_BENCH_WORD_NUM   (__GH3X2X_RAWDATA_BUFFER_SIZE__ / 4)
+#define GH3X2X_FIFO_DECODE_BENCH_LOOP_NUM   (100)       /**< decode times of every benchmark case */
+
+/// decoded arrays of one benchmark case
+typedef struct
+{
+    GU32 unAdcCode[GH3X2X_FIFO_DECODE_BENCH_WORD_NUM];
+    GU8 uchSlot[GH3X2X_FIFO_DECODE_BENCH_WORD_NUM];
+    GU8 uchAdc[GH3X2X_FIFO_DECODE_BENCH_WORD_NUM];
+    GU8 uchFlag[GH3X2X_FIFO_DECODE_BENCH_WORD_NUM];
+} STGh3x2xFifoDecodeBenchOut;
+
+/// args of one decode benchmark case
+typedef struct
+{
+    void (*pDecodeFunc)(const GU8 *puchFifo, GU16 usWordNum, const STGh3x2xFifoDecodeSoa *pstOut);
+    const GU8 *puchFifo;
+    STGh3x2xFifoDecodeSoa stOut;
+} STGh3x2xFifoDecodeBenchArg;
+
+/**
+ * @fn     static void Gh3x2xFifoDecodeBenchmarkCase(void *pvArg)
+ *
+ * @brief  one decode of benchmark case
+ *
+ * @attention   None
+ *
+ * @param[in]   pvArg           pointer to STGh3x2xFifoDecodeBenchArg
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xFifoDecodeBenchmarkCase(void *pvArg)
+{
+    const STGh3x2xFifoDecodeBenchArg *pstArg = (const STGh3x2xFifoDecodeBenchArg *)pvArg;
+
+    pstArg->pDecodeFunc(pstArg->puchFifo, GH3X2X_FIFO_DECODE_BENCH_WORD_NUM, &pstArg->stOut);
+}
+
+/**
+ * @fn     void Gh3x2xFifoDecodeBenchmark(void)
+ *
+ * @brief  benchmark of fifo word decode, kernel vs c reference, and bit-for-bit check of their output
+ *
+ * @attention   result is printed by EXAMPLE_LOG, run by shell cmd gh3x2x_bench decode
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xFifoDecodeBenchmark(void)
+{
+    static GU8 puchBenchFifo[GH3X2X_FIFO_DECODE_BENCH_WORD_NUM * 4 + 1];
+    static STGh3x2xFifoDecodeBenchOut stRefOut;
+    static STGh3x2xFifoDecodeBenchOut stKernelOut;
+    /* fifo data of drv lib is byte aligned, run from an odd address as worst case */
+    STGh3x2xFifoDecodeBenchArg stArg =
+    {
+        Gh3x2xFifoDecodeRef, &puchBenchFifo[1],
+        {stRefOut.unAdcCode, stRefOut.uchSlot, stRefOut.uchAdc, stRefOut.uchFlag},
+    };
+
+    Gh3x2xBenchmarkFill(puchBenchFifo, sizeof(puchBenchFifo));     //every tag and flag value is covered
+    memset(&stRefOut, 0, sizeof(stRefOut));
+    memset(&stKernelOut, 0xFF, sizeof(stKernelOut));
+
+    Gh3x2xBenchmarkRun("fifo decode c reference", Gh3x2xFifoDecodeBenchmarkCase, &stArg,
+                       GH3X2X_FIFO_DECODE_BENCH_LOOP_NUM, GH3X2X_FIFO_DECODE_BENCH_WORD_NUM, "word");
+    stArg.pDecodeFunc = Gh3x2xFifoDecode;
+    stArg.stOut = (STGh3x2xFifoDecodeSoa){stKernelOut.unAdcCode, stKernelOut.uchSlot, stKernelOut.uchAdc, stKernelOut.uchFlag};
+    Gh3x2xBenchmarkRun((GH3X2X_FIFO_DECODE_DSP_EN) ? "fifo decode dsp kernel" : "fifo decode kernel(c reference)",
+                       Gh3x2xFifoDecodeBenchmarkCase, &stArg,
+                       GH3X2X_FIFO_DECODE_BENCH_LOOP_NUM, GH3X2X_FIFO_DECODE_BENCH_WORD_NUM, "word");
+    Gh3x2xBenchmarkCheck("fifo decode", &stRefOut, &stKernelOut, sizeof(stRefOut));
+}
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @copyright (c) 2003 - 2022, Goodix Co., Ltd. All rights reserved.
+ *
+ * @file    gh3x2x_demo_frame_batch.c
+ *
+ * @brief   gh3x2x driver lib demo code for batched frame delivery
+ *
+ * @author  Gooidx Iot Team
+ *
+ */
+#include "stdint.h"
+#include "string.h"
+#include "gh3x2x_demo.h"
+#include "gh3x2x_demo_inner.h"
+
+#if (__GH3X2X_FRAME_BATCH_EN__)
+
+#if (__GS_GYRO_ENABLE__)
+#define GH3X2X_FRAME_BATCH_GS_AXIS_NUM      (6)
+#else
+#define GH3X2X_FRAME_BATCH_GS_AXIS_NUM      (3)
+#endif
+
+static GU32 g_unGh3x2xFrameBatchRawdata[GH3X2X_FUNC_CHNL_NUM_MAX * __GH3X2X_FRAME_BATCH_MAX_NUM__];
+static GU32 g_unGh3x2xFrameBatchAgcInfo[GH3X2X_FUNC_CHNL_NUM_MAX * __GH3X2X_FRAME_BATCH_MAX_NUM__];
+static GS16 g_sGh3x2xFrameBatchGsensorData[GH3X2X_FRAME_BATCH_GS_AXIS_NUM * __GH3X2X_FRAME_BATCH_MAX_NUM__];
+static GU32 g_unGh3x2xFrameBatchFlag[GH3X2X_FRAME_FLAG_NUM * __GH3X2X_FRAME_BATCH_MAX_NUM__];
+static GU32 g_unGh3x2xFrameBatchFrameCnt[__GH3X2X_FRAME_BATCH_MAX_NUM__];
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+static GS64 g_llGh3x2xFrameBatchTimeStampUs[__GH3X2X_FRAME_BATCH_MAX_NUM__];
+#endif
+
+/// batch being collected, frames of one function arrive together in one drv lib function process
+static STGh3x2xFrameBatch g_stGh3x2xFrameBatch =
+{
+    .uchGsensorAxisNum = GH3X2X_FRAME_BATCH_GS_AXIS_NUM,
+    .usFrameStride = __GH3X2X_FRAME_BATCH_MAX_NUM__,
+    .punRawdata = g_unGh3x2xFrameBatchRawdata,
+    .punAgcInfo = g_unGh3x2xFrameBatchAgcInfo,
+    .psGsensorData = g_sGh3x2xFrameBatchGsensorData,
+    .punFlag = g_unGh3x2xFrameBatchFlag,
+    .punFrameCnt = g_unGh3x2xFrameBatchFrameCnt,
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+    .pllTimeStampUs = g_llGh3x2xFrameBatchTimeStampUs,
+#endif
+};
+
+/**
+ * @fn     void Gh3x2xDemoFrameBatchFlush(void)
+ *
+ * @brief  deliver collected frames by gh3x2x_frame_batch_hook_func
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoFrameBatchFlush(void)
+{
+    if (0 == g_stGh3x2xFrameBatch.usFrameNum)
+    {
+        return;
+    }
+    gh3x2x_frame_batch_hook_func(&g_stGh3x2xFrameBatch);
+    g_stGh3x2xFrameBatch.usFrameNum = 0;
+}
+
+/**
+ * @fn     void Gh3x2xDemoFrameBatchPush(const STGh3x2xFrameInfo * const pstFrameInfo)
+ *
+ * @brief  add one frame to batch
+ *
+ * @attention   batch is delivered first if frame is of another function, and after it if batch is full
+ *
+ * @param[in]   pstFrameInfo    decoded frame
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xDemoFrameBatchPush(const STGh3x2xFrameInfo * const pstFrameInfo)
+{
+    STGh3x2xFrameBatch *pstBatch = &g_stGh3x2xFrameBatch;
+    GU8 uchChnlNum = pstFrameInfo->pstFunctionInfo->uchChnlNum;
+    GU16 usFrameIndex;
+
+    if (uchChnlNum > GH3X2X_FUNC_CHNL_NUM_MAX)
+    {
+        uchChnlNum = GH3X2X_FUNC_CHNL_NUM_MAX;
+    }
+    if ((pstBatch->usFrameNum != 0)
+        && ((pstBatch->unFunctionID != pstFrameInfo->unFunctionID) || (pstBatch->uchChnlNum != uchChnlNum)))
+    {
+        Gh3x2xDemoFrameBatchFlush();
+    }
+    if (0 == pstBatch->usFrameNum)
+    {
+        pstBatch->unFunctionID = pstFrameInfo->unFunctionID;
+        pstBatch->usSampleRate = pstFrameInfo->pstFunctionInfo->usSampleRate;
+        pstBatch->uchChnlNum = uchChnlNum;
+        pstBatch->pchChnlMap = pstFrameInfo->pchChnlMap;
+    }
+
+    usFrameIndex = pstBatch->usFrameNum;
+    for (GU8 uchChnlCnt = 0; uchChnlCnt < uchChnlNum; uchChnlCnt++)
+    {
+        pstBatch->punRawdata[uchChnlCnt * __GH3X2X_FRAME_BATCH_MAX_NUM__ + usFrameIndex] = pstFrameInfo->punFrameRawdata[uchChnlCnt];
+        pstBatch->punAgcInfo[uchChnlCnt * __GH3X2X_FRAME_BATCH_MAX_NUM__ + usFrameIndex] = pstFrameInfo->punFrameAgcInfo[uchChnlCnt];
+    }
+    for (GU8 uchAxisCnt = 0; uchAxisCnt < GH3X2X_FRAME_BATCH_GS_AXIS_NUM; uchAxisCnt++)
+    {
+        pstBatch->psGsensorData[uchAxisCnt * __GH3X2X_FRAME_BATCH_MAX_NUM__ + usFrameIndex] = pstFrameInfo->pusFrameGsensordata[uchAxisCnt];
+    }
+    for (GU8 uchFlagCnt = 0; uchFlagCnt < GH3X2X_FRAME_FLAG_NUM; uchFlagCnt++)
+    {
+        pstBatch->punFlag[uchFlagCnt * __GH3X2X_FRAME_BATCH_MAX_NUM__ + usFrameIndex] = pstFrameInfo->punFrameFlag[uchFlagCnt];
+    }
+    pstBatch->punFrameCnt[usFrameIndex] = pstFrameInfo->punFrameCnt[0];
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+    pstBatch->pllTimeStampUs[usFrameIndex] = Gh3x2xDemoFrameTimeStampGet(pstFrameInfo->unFunctionID);
+#endif
+    pstBatch->usFrameNum++;
+
+    if (pstBatch->usFrameNum >= __GH3X2X_FRAME_BATCH_MAX_NUM__)
+    {
+        Gh3x2xDemoFrameBatchFlush();
+    }
+}
+
+#endif
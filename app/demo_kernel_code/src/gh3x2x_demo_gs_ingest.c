@@ -0,0 +1,336 @@
+/**
+ * @copyright (c) 2003 - 2022, Goodix Co., Ltd. All rights reserved.
+ *
+ * @file    gh3x2x_demo_gs_ingest.c
+ *
+ * @brief   gh3x2x driver lib demo code for gsensor data ingest
+ *
+ * @author  Gooidx Iot Team
+ *
+ */
+#include "stdint.h"
+#include "string.h"
+#include "gh3x2x_demo_inner.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include <soc.h>
+#define GH3X2X_GS_INGEST_DSP_EN             (1)         /**< cortex-m4 dsp extension kernel */
+#else
+#define GH3X2X_GS_INGEST_DSP_EN             (0)
+#endif
+
+#define GH3X2X_GS_INGEST_SHIFT              (__GS_SENSITIVITY_CONFIG__)     /**< right shift of accel to 512 counts/g */
+#define GH3X2X_GS_INGEST_AXIS_NUM           (3)
+
+/// source axis of output axis k(0: x, 1: y, 2: z), GH3X2X_GS_AXIS_XXX
+#define GH3X2X_GS_INGEST_REMAP(k)           (((k) == 0) ? (__GS_AXIS_REMAP_X__) : \
+                                             (((k) == 1) ? (__GS_AXIS_REMAP_Y__) : (__GS_AXIS_REMAP_Z__)))
+
+/**
+ * @fn     static GS16 Gh3x2xGsIngestNeg(GS16 sVal)
+ *
+ * @brief  saturating negation, same as QSUB16 of dsp kernel
+ *
+ * @attention   None
+ *
+ * @param[in]   sVal        value
+ * @param[out]  None
+ *
+ * @return  -sVal, INT16_MAX for INT16_MIN
+ */
+static GS16 Gh3x2xGsIngestNeg(GS16 sVal)
+{
+    return (INT16_MIN == sVal) ? INT16_MAX : (GS16)(-sVal);
+}
+
+/**
+ * @fn     static void Gh3x2xGsIngestRemapRef(GS16 *psOut, const GS16 *psIn)
+ *
+ * @brief  remap one group of x/y/z axes
+ *
+ * @attention   None
+ *
+ * @param[in]   psIn        x/y/z
+ * @param[out]  psOut       remapped x/y/z
+ *
+ * @return  None
+ */
+static void Gh3x2xGsIngestRemapRef(GS16 *psOut, const GS16 *psIn)
+{
+    for (GU8 uchAxis = 0; uchAxis < GH3X2X_GS_INGEST_AXIS_NUM; uchAxis++)
+    {
+        GS16 sVal = psIn[GH3X2X_GS_INGEST_REMAP(uchAxis) & GH3X2X_GS_AXIS_MASK];
+
+        psOut[uchAxis] = (GH3X2X_GS_INGEST_REMAP(uchAxis) & GH3X2X_GS_AXIS_NEG) ? Gh3x2xGsIngestNeg(sVal) : sVal;
+    }
+}
+
+/**
+ * @fn     void Gh3x2xGsensorIngestRef(STGsensorRawdata *pstDst, const STGsensorRawdata *pstSrc, GU16 usPointNum)
+ *
+ * @brief  copy gsensor points with sensitivity shift and axis remap, portable c reference
+ *
+ * @attention   pstDst may be pstSrc
+ *
+ * @param[in]   pstSrc          gsensor points of driver
+ * @param[in]   usPointNum      point num
+ * @param[out]  pstDst          normalized points
+ *
+ * @return  None
+ */
+void Gh3x2xGsensorIngestRef(STGsensorRawdata *pstDst, const STGsensorRawdata *pstSrc, GU16 usPointNum)
+{
+    for (GU16 usPointCnt = 0; usPointCnt < usPointNum; usPointCnt++)
+    {
+        GS16 sAccel[GH3X2X_GS_INGEST_AXIS_NUM] =
+        {
+            (GS16)(pstSrc[usPointCnt].sXAxisVal >> GH3X2X_GS_INGEST_SHIFT),
+            (GS16)(pstSrc[usPointCnt].sYAxisVal >> GH3X2X_GS_INGEST_SHIFT),
+            (GS16)(pstSrc[usPointCnt].sZAxisVal >> GH3X2X_GS_INGEST_SHIFT),
+        };
+        GS16 sOut[GH3X2X_GS_INGEST_AXIS_NUM];
+    #if __GS_GYRO_ENABLE__
+        GS16 sGyro[GH3X2X_GS_INGEST_AXIS_NUM] =
+        {
+            pstSrc[usPointCnt].sXGyroVal, pstSrc[usPointCnt].sYGyroVal, pstSrc[usPointCnt].sZGyroVal,
+        };
+
+        Gh3x2xGsIngestRemapRef(sOut, sGyro);
+        pstDst[usPointCnt].sXGyroVal = sOut[0];
+        pstDst[usPointCnt].sYGyroVal = sOut[1];
+        pstDst[usPointCnt].sZGyroVal = sOut[2];
+    #endif
+        Gh3x2xGsIngestRemapRef(sOut, sAccel);
+        pstDst[usPointCnt].sXAxisVal = sOut[0];
+        pstDst[usPointCnt].sYAxisVal = sOut[1];
+        pstDst[usPointCnt].sZAxisVal = sOut[2];
+    }
+}
+
+#if (GH3X2X_GS_INGEST_DSP_EN)
+
+/* three words hold two groups of x/y/z halfwords: two points, or accel and gyro of one point */
+#if __GS_GYRO_ENABLE__
+#define GH3X2X_GS_INGEST_POINT_PER_LOOP     (1)
+#else
+#define GH3X2X_GS_INGEST_POINT_PER_LOOP     (2)
+#endif
+
+/// source halfword(0~5) of output halfword h, remap is inside its group
+#define GH3X2X_GS_INGEST_SRC_HW(h)          (((h) / 3) * 3 + (GH3X2X_GS_INGEST_REMAP((h) % 3) & GH3X2X_GS_AXIS_MASK))
+#define GH3X2X_GS_INGEST_NEG_HW(h)          ((GH3X2X_GS_INGEST_REMAP((h) % 3) & GH3X2X_GS_AXIS_NEG) ? 1 : 0)
+
+/**
+ * @fn     static inline GU32 Gh3x2xGsIngestShift(GU32 unWord)
+ *
+ * @brief  arithmetic right shift of both halfwords, one SHADD16 with 0 per bit
+ *
+ * @attention   None
+ *
+ * @param[in]   unWord      two halfwords
+ * @param[out]  None
+ *
+ * @return  shifted halfwords
+ */
+static inline GU32 Gh3x2xGsIngestShift(GU32 unWord)
+{
+    for (GU8 uchShiftCnt = 0; uchShiftCnt < GH3X2X_GS_INGEST_SHIFT; uchShiftCnt++)
+    {
+        unWord = __SHADD16(unWord, 0);
+    }
+    return unWord;
+}
+
+/**
+ * @fn     static inline GU32 Gh3x2xGsIngestPack(const GU32 *punIn, GU8 uchLoHw, GU8 uchHiHw, GU8 uchLoNeg, GU8 uchHiNeg)
+ *
+ * @brief  build one output word from two halfwords of input words, with saturating negation
+ *
+ * @attention   halfword index and negation are constants, every branch is folded
+ *
+ * @param[in]   punIn       three input words
+ * @param[in]   uchLoHw     input halfword of low halfword
+ * @param[in]   uchHiHw     input halfword of high halfword
+ * @param[in]   uchLoNeg    negate low halfword
+ * @param[in]   uchHiNeg    negate high halfword
+ * @param[out]  None
+ *
+ * @return  output word
+ */
+static inline GU32 Gh3x2xGsIngestPack(const GU32 *punIn, GU8 uchLoHw, GU8 uchHiHw, GU8 uchLoNeg, GU8 uchHiNeg)
+{
+    GU32 unLo = (uchLoHw & 1) ? (punIn[uchLoHw >> 1] >> 16) : punIn[uchLoHw >> 1];
+    GU32 unHi = (uchHiHw & 1) ? punIn[uchHiHw >> 1] : (punIn[uchHiHw >> 1] << 16);
+    GU32 unWord = __PKHBT(unLo, unHi, 0);
+    GU32 unNeg;
+
+    if (!uchLoNeg && !uchHiNeg)
+    {
+        return unWord;
+    }
+    unNeg = __QSUB16(0, unWord);
+    if (uchLoNeg && uchHiNeg)
+    {
+        return unNeg;
+    }
+    return uchLoNeg ? __PKHBT(unNeg, unWord, 0) : __PKHBT(unWord, unNeg, 0);
+}
+
+#endif
+
+/**
+ * @fn     void Gh3x2xGsensorIngest(STGsensorRawdata *pstDst, const STGsensorRawdata *pstSrc, GU16 usPointNum)
+ *
+ * @brief  copy gsensor points with sensitivity shift and axis remap in one pass, packed halfword kernel with dsp extension
+ *
+ * @attention   Three words(two points, or one point with gyro) per loop: SHADD16 with 0 shifts both halfwords of
+ *              a word by one bit, remap is PKHBT of constant halfwords and QSUB16 for negation. Same output as
+ *              Gh3x2xGsensorIngestRef, which is used without dsp extension. pstDst may be pstSrc
+ *
+ * @param[in]   pstSrc          gsensor points of driver
+ * @param[in]   usPointNum      point num
+ * @param[out]  pstDst          normalized points
+ *
+ * @return  None
+ */
+void Gh3x2xGsensorIngest(STGsensorRawdata *pstDst, const STGsensorRawdata *pstSrc, GU16 usPointNum)
+{
+#if (GH3X2X_GS_INGEST_DSP_EN)
+    GU16 usPointCnt = 0;
+
+    for (; (usPointCnt + GH3X2X_GS_INGEST_POINT_PER_LOOP) <= usPointNum; usPointCnt += GH3X2X_GS_INGEST_POINT_PER_LOOP)
+    {
+        const GU8 *puchIn = (const GU8 *)&pstSrc[usPointCnt];
+        GU8 *puchOut = (GU8 *)&pstDst[usPointCnt];
+        GU32 unIn[3] =
+        {
+            __UNALIGNED_UINT32_READ(&puchIn[0]), __UNALIGNED_UINT32_READ(&puchIn[4]), __UNALIGNED_UINT32_READ(&puchIn[8]),
+        };
+
+    #if __GS_GYRO_ENABLE__
+        /* accel x/y, accel z and gyro x, gyro y/z: gyro is not shifted */
+        unIn[0] = Gh3x2xGsIngestShift(unIn[0]);
+        unIn[1] = __PKHBT(Gh3x2xGsIngestShift(unIn[1]), unIn[1], 0);
+    #else
+        unIn[0] = Gh3x2xGsIngestShift(unIn[0]);
+        unIn[1] = Gh3x2xGsIngestShift(unIn[1]);
+        unIn[2] = Gh3x2xGsIngestShift(unIn[2]);
+    #endif
+    #if __GS_AXIS_REMAP_EN__
+        __UNALIGNED_UINT32_WRITE(&puchOut[0], Gh3x2xGsIngestPack(unIn, GH3X2X_GS_INGEST_SRC_HW(0), GH3X2X_GS_INGEST_SRC_HW(1),
+                                                                 GH3X2X_GS_INGEST_NEG_HW(0), GH3X2X_GS_INGEST_NEG_HW(1)));
+        __UNALIGNED_UINT32_WRITE(&puchOut[4], Gh3x2xGsIngestPack(unIn, GH3X2X_GS_INGEST_SRC_HW(2), GH3X2X_GS_INGEST_SRC_HW(3),
+                                                                 GH3X2X_GS_INGEST_NEG_HW(2), GH3X2X_GS_INGEST_NEG_HW(3)));
+        __UNALIGNED_UINT32_WRITE(&puchOut[8], Gh3x2xGsIngestPack(unIn, GH3X2X_GS_INGEST_SRC_HW(4), GH3X2X_GS_INGEST_SRC_HW(5),
+                                                                 GH3X2X_GS_INGEST_NEG_HW(4), GH3X2X_GS_INGEST_NEG_HW(5)));
+    #else
+        __UNALIGNED_UINT32_WRITE(&puchOut[0], unIn[0]);
+        __UNALIGNED_UINT32_WRITE(&puchOut[4], unIn[1]);
+        __UNALIGNED_UINT32_WRITE(&puchOut[8], unIn[2]);
+    #endif
+    }
+    if (usPointCnt < usPointNum)
+    {
+        Gh3x2xGsensorIngestRef(&pstDst[usPointCnt], &pstSrc[usPointCnt], usPointNum - usPointCnt);
+    }
+#else
+    Gh3x2xGsensorIngestRef(pstDst, pstSrc, usPointNum);
+#endif
+}
+
+#if (__GH3X2X_GS_INGEST_BENCHMARK_EN__)
+
+#define GH3X2X_GS_INGEST_BENCH_POINT_NUM    (300)       /**< points of one block */
+#define GH3X2X_GS_INGEST_BENCH_LOOP_NUM     (100)       /**< ingest times of every benchmark case */
+
+/**
+ * @fn     static void Gh3x2xGsIngestTwoPass(STGsensorRawdata *pstDst, const STGsensorRawdata *pstSrc, GU16 usPointNum)
+ *
+ * @brief  copy and then normalize in place, as a driver copy followed by a second pass
+ *
+ * @attention   None
+ *
+ * @param[in]   pstSrc          gsensor points of driver
+ * @param[in]   usPointNum      point num
+ * @param[out]  pstDst          normalized points
+ *
+ * @return  None
+ */
+static void Gh3x2xGsIngestTwoPass(STGsensorRawdata *pstDst, const STGsensorRawdata *pstSrc, GU16 usPointNum)
+{
+    memcpy(pstDst, pstSrc, usPointNum * sizeof(STGsensorRawdata));
+    Gh3x2xGsensorIngestRef(pstDst, pstDst, usPointNum);
+}
+
+/// args of one ingest benchmark case
+typedef struct
+{
+    void (*pIngestFunc)(STGsensorRawdata *pstDst, const STGsensorRawdata *pstSrc, GU16 usPointNum);
+    const STGsensorRawdata *pstSrc;
+    STGsensorRawdata *pstDst;
+} STGh3x2xGsIngestBenchArg;
+
+/**
+ * @fn     static void Gh3x2xGsIngestBenchmarkCase(void *pvArg)
+ *
+ * @brief  one ingest of benchmark case
+ *
+ * @attention   None
+ *
+ * @param[in]   pvArg           pointer to STGh3x2xGsIngestBenchArg
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xGsIngestBenchmarkCase(void *pvArg)
+{
+    const STGh3x2xGsIngestBenchArg *pstArg = (const STGh3x2xGsIngestBenchArg *)pvArg;
+
+    pstArg->pIngestFunc(pstArg->pstDst, pstArg->pstSrc, GH3X2X_GS_INGEST_BENCH_POINT_NUM);
+}
+
+/**
+ * @fn     void Gh3x2xGsensorIngestBenchmark(void)
+ *
+ * @brief  benchmark of gsensor ingest of one 300 point block, two pass vs c reference vs kernel,
+ *         and bit-for-bit check of their output
+ *
+ * @attention   result is printed by EXAMPLE_LOG, run by shell cmd gh3x2x_bench ingest
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xGsensorIngestBenchmark(void)
+{
+    static STGsensorRawdata stBenchSrc[GH3X2X_GS_INGEST_BENCH_POINT_NUM];
+    static STGsensorRawdata stTwoPassOut[GH3X2X_GS_INGEST_BENCH_POINT_NUM];
+    static STGsensorRawdata stRefOut[GH3X2X_GS_INGEST_BENCH_POINT_NUM];
+    static STGsensorRawdata stKernelOut[GH3X2X_GS_INGEST_BENCH_POINT_NUM];
+    GS16 *psSrc = (GS16 *)stBenchSrc;
+    STGh3x2xGsIngestBenchArg stArg = {Gh3x2xGsIngestTwoPass, stBenchSrc, stTwoPassOut};
+
+    Gh3x2xBenchmarkFill(stBenchSrc, sizeof(stBenchSrc));
+    for (GU16 usValCnt = 0; usValCnt < (GH3X2X_GS_INGEST_BENCH_POINT_NUM * sizeof(STGsensorRawdata) / sizeof(GS16)); usValCnt += 61)
+    {
+        psSrc[usValCnt] = INT16_MIN;    //negation saturates
+    }
+    memset(stRefOut, 0, sizeof(stRefOut));
+    memset(stKernelOut, 0xFF, sizeof(stKernelOut));
+
+    Gh3x2xBenchmarkRun("gs ingest copy + second pass", Gh3x2xGsIngestBenchmarkCase, &stArg,
+                       GH3X2X_GS_INGEST_BENCH_LOOP_NUM, GH3X2X_GS_INGEST_BENCH_POINT_NUM, "point");
+    stArg.pIngestFunc = Gh3x2xGsensorIngestRef;
+    stArg.pstDst = stRefOut;
+    Gh3x2xBenchmarkRun("gs ingest c reference", Gh3x2xGsIngestBenchmarkCase, &stArg,
+                       GH3X2X_GS_INGEST_BENCH_LOOP_NUM, GH3X2X_GS_INGEST_BENCH_POINT_NUM, "point");
+    stArg.pIngestFunc = Gh3x2xGsensorIngest;
+    stArg.pstDst = stKernelOut;
+    Gh3x2xBenchmarkRun((GH3X2X_GS_INGEST_DSP_EN) ? "gs ingest dsp kernel" : "gs ingest kernel(c reference)",
+                       Gh3x2xGsIngestBenchmarkCase, &stArg,
+                       GH3X2X_GS_INGEST_BENCH_LOOP_NUM, GH3X2X_GS_INGEST_BENCH_POINT_NUM, "point");
+    Gh3x2xBenchmarkCheck("gs ingest", stRefOut, stKernelOut, sizeof(stRefOut));
+}
+
+#endif
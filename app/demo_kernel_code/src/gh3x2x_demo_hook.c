@@ -17,6 +17,8 @@
 #include "gh3x2x_demo_algo_call.h"
 #endif
 
+#include "gh3x2x_sensor.h"
+
 /* hook functions */
 
 /**
@@ -110,33 +112,48 @@ void gh3x2x_sampling_stop_hook_func(void)
     GU8  ubFlagLedAdjAgcUp;            //adj down flag of ppg data   0: down  1:up
 }StFifoDataInformation;
 void gh3x2x_get_rawdata_hook_func(GU8 *read_buffer_ptr, GU16 length)
+{
+    /* code implement by user */
+#if (__GH3X2X_FIFO_DECODE_EN__)
+    /* big endian to little endian, pick rawdata and flag of every word, result goes to gh3x2x_fifo_decode_hook_func */
+    Gh3x2xFifoDecodeBlock(read_buffer_ptr, length);
+#endif
+}
+
+#if (__GH3X2X_FIFO_DECODE_EN__)
+/**
+ * @fn      void gh3x2x_fifo_decode_hook_func(const STGh3x2xFifoDecodeSoa * const pstFifoDecode, GU16 usWordNum)
+ * 
+ * @brief  fifo words of one block decoded as structure of arrays
+ *
+ * @attention   called by rawdata hook for every fifo block, arrays are only valid inside hook
+ *
+ * @param[in]   pstFifoDecode       decoded arrays
+ * @param[in]   usWordNum           word num of every array
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void gh3x2x_fifo_decode_hook_func(const STGh3x2xFifoDecodeSoa * const pstFifoDecode, GU16 usWordNum)
 {
     /* code implement by user */
     /****************** FOLLOWING CODE IS EXAMPLE **********************************/
 #if 0
     StFifoDataInformation stTempFifoInfo = {0};
-    if (length/4 > 0)
+
+    for (GU16 i = 0; i < usWordNum; i++)
     {
-            for (int i = 0; i < length; i += 4)
-            {
-                GU32 temp = 0;
-                // big endian to little endian
-                temp =  ((GU32)read_buffer_ptr[i+ 0]) << 24;
-                temp += ((GU32)read_buffer_ptr[i+ 1])<< 16;
-                temp += ((GU32)read_buffer_ptr[i+ 2]) << 8;
-                temp += ((GU32)read_buffer_ptr[i+ 3]);    
-                // pick rawdata and flag
-                stTempFifoInfo.uiAdcCode = ((temp >> 0) & 0x00FFFFFF);
-                stTempFifoInfo.ubSlotNo =  ((temp >> 29) & 0x00000007);
-                stTempFifoInfo.ubAdcNo = ((temp >> 27) & 0x00000003);
-                stTempFifoInfo.ubFlagLedAdjIsAgc_EcgRecover = ((temp >> 26) & 0x00000001);
-                stTempFifoInfo.ubFlagLedAdjAgcUp = ((temp >> 25) & 0x00000001);
-                EXAMPLE_LOG("Received rawdata:slot%d,adc%d,AdcCode = %d\r\n", stTempFifoInfo.ubSlotNo, stTempFifoInfo.ubAdcNo, \
-                                                                    stTempFifoInfo.uiAdcCode);
-            }
+        stTempFifoInfo.uiAdcCode = pstFifoDecode->punAdcCode[i];
+        stTempFifoInfo.ubSlotNo = pstFifoDecode->puchSlot[i];
+        stTempFifoInfo.ubAdcNo = pstFifoDecode->puchAdc[i];
+        stTempFifoInfo.ubFlagLedAdjIsAgc_EcgRecover = (pstFifoDecode->puchFlag[i] >> 1) & 0x01;
+        stTempFifoInfo.ubFlagLedAdjAgcUp = pstFifoDecode->puchFlag[i] & 0x01;
+        EXAMPLE_LOG("Received rawdata:slot%d,adc%d,AdcCode = %d\r\n", stTempFifoInfo.ubSlotNo, stTempFifoInfo.ubAdcNo, \
+                                                            stTempFifoInfo.uiAdcCode);
     }
 #endif
 }
+#endif
 
 /**
  * @fn      void gh3x2x_algorithm_get_io_data_hook_func(const STGh3x2xFrameInfo * const pstFrameInfo)
@@ -180,15 +197,87 @@ void gh3x2x_algorithm_get_io_data_hook_func(const STGh3x2xFrameInfo * const pstF
     }
 #endif
 #endif
+
+#if (__GH3X2X_FRAME_BATCH_EN__)
+    /* frame only goes to batch, consumers get it by gh3x2x_frame_batch_hook_func instead of per frame callback */
+    Gh3x2xDemoFrameBatchPush(pstFrameInfo);
+#else
+    /* frame to stream callback of zephyr sensor driver, after algo result is updated */
+    gh3x2xSensorFramePush(pstFrameInfo);
+#endif
+}
+
+#if (__GH3X2X_FRAME_BATCH_EN__)
+/**
+ * @fn      void gh3x2x_frame_batch_hook_func(const STGh3x2xFrameBatch * const pstFrameBatch)
+ * 
+ * @brief  frames of one function in channel-major arrays
+ *
+ * @attention   called when function of frames changes, batch is full and at fifo block done. Arrays are
+ *              only valid inside hook
+ *
+ * @param[in]   pstFrameBatch
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void gh3x2x_frame_batch_hook_func(const STGh3x2xFrameBatch * const pstFrameBatch)
+{
+    /****************** FOLLOWING CODE IS EXAMPLE **********************************/
+#if 0
+    EXAMPLE_LOG("[BATCH]Function ID: 0x%X, channel num = %d, frame num = %d\r\n",(int)(pstFrameBatch->unFunctionID),
+                (int)(pstFrameBatch->uchChnlNum),(int)(pstFrameBatch->usFrameNum));
+    for(GU8 uchChnlCnt = 0; uchChnlCnt < pstFrameBatch->uchChnlNum; uchChnlCnt ++)
+    {
+        const GU32 *punChnlRawdata = &pstFrameBatch->punRawdata[uchChnlCnt * pstFrameBatch->usFrameStride];
+        GU32 unSum = 0;
+
+        for(GU16 usFrameCnt = 0; usFrameCnt < pstFrameBatch->usFrameNum; usFrameCnt ++)
+        {
+            unSum += punChnlRawdata[usFrameCnt];
+        }
+        EXAMPLE_LOG("[BATCH]Ch%d rawdata mean = %d\r\n",(int)(uchChnlCnt),(int)(unSum / pstFrameBatch->usFrameNum));
+    }
+#endif
+
+    /* batch to batch stream callback of zephyr sensor driver */
+    gh3x2xSensorBatchPush(pstFrameBatch);
+}
+#endif
+
+/**
+ * @fn      void gh3x2x_fifo_block_done_hook_func(void)
+ * 
+ * @brief  all frames of one fifo read are delivered
+ *
+ * @attention   None        
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void gh3x2x_fifo_block_done_hook_func(void)
+{
+#if (__GH3X2X_FRAME_BATCH_EN__)
+    Gh3x2xDemoFrameBatchFlush();
+#endif
+    gh3x2xSensorBlockDone();
 }
 
 void gh3x2x_frame_data_hook_func(const STGh3x2xFrameInfo * const pstFrameInfo)
 {
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+    Gh3x2xDemoFrameTimeStampNext(pstFrameInfo);
+#endif
 #if (__DRIVER_LIB_MODE__ == __DRV_LIB_WITH_ALGO__)
     if (GH3X2X_TimestampSyncGetFrameDataFlag() == 0 && GH3X2X_GetGsensorEnableFlag())
     {
         /* user set time stamp code here */
         GU32 unTimeStamp = 0;
+    #if (__GH3X2X_HW_TIMESTAMP_EN__)
+        unTimeStamp = (GU32)(Gh3x2xDemoFrameTimeStampGet(pstFrameInfo->unFunctionID) / 1000);  //sync buffer is in ms
+    #endif
         //GU8 uchFuncOffsetID = 0;
         //for(GU8 uchFunCnt = 0; uchFunCnt < __SYNC_FUNC_MAX__; uchFunCnt ++)
         //{
@@ -225,6 +314,9 @@ void gh3x2x_config_set_start_hook(void)
 
 void gh3x2x_config_set_stop_hook(void)
 {
+#if (__GH3X2X_ROUTE_TABLE_EN__)
+    Gh3x2xDemoRouteTableInvalidate();   //reg config array load selects its table again after this
+#endif
     Gh3x2xPollingModePro();
     GH3x2xSlotTimeInfo();
 #if (__DRIVER_LIB_MODE__ == __DRV_LIB_WITH_ALGO__)
@@ -11,6 +11,7 @@
 
 
 #include <stdio.h>
+#include <stdint.h>
 #include <math.h>
 #include <string.h>
 #include <stdlib.h>
@@ -19,6 +20,13 @@
 #include "gh3x2x_drv.h"
 #include "gh3x2x_demo_soft_adt.h"
 
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include <soc.h>
+#define GH3X2X_GS_MOVE_DSP_EN               (1)         /**< cortex-m4 dsp extension kernel */
+#else
+#define GH3X2X_GS_MOVE_DSP_EN               (0)
+#endif
+
 /**********佩戴检测全局变量**********/
 GS32 ghbinfo[12] = { 0 };
 GS32 glCapValue[2] = { 0 };
@@ -135,13 +143,153 @@ void GH3X2X_MoveDetectByCapData(STCapRawdata* pusCapData, GU16 usCapDataCnt)
 }
 #endif
 #endif
+#if __GS_GYRO_ENABLE__
+#define GH3X2X_GS_MOVE_STRIDE               (6)         /**< halfwords of one gsensor point */
+#else
+#define GH3X2X_GS_MOVE_STRIDE               (3)
+#endif
+#define GH3X2X_GS_MOVE_CHUNK_NUM            (16)        /**< points of one kernel call, checked before next chunk */
+
+/**
+ * @fn     static void Gh3x2xGsMoveEnergyRef(const GS16 *psGsData, GU16 usPointNum, STGsAccRawdata *pstLast, GU32 punSumOfSquare[])
+ *
+ * @brief  sum of square of x/y/z difference to previous point, portable c reference
+ *
+ * @attention   difference of every axis is wrapped to 16 bits
+ *
+ * @param[in]   psGsData        gsensor points, GH3X2X_GS_MOVE_STRIDE halfwords each
+ * @param[in]   usPointNum      point num
+ * @param[in]   pstLast         point before psGsData, updated to last point
+ * @param[out]  punSumOfSquare  sum of square of every point
+ *
+ * @return  None
+ */
+static void Gh3x2xGsMoveEnergyRef(const GS16 *psGsData, GU16 usPointNum, STGsAccRawdata *pstLast, GU32 punSumOfSquare[])
+{
+    for (GU16 usPointCnt = 0; usPointCnt < usPointNum; usPointCnt++)
+    {
+        const GS16 *psPoint = &psGsData[usPointCnt * GH3X2X_GS_MOVE_STRIDE];
+        GS16 sXAxisVal = psPoint[0] - pstLast->sXAxisVal;
+        GS16 sYAxisVal = psPoint[1] - pstLast->sYAxisVal;
+        GS16 sZAxisVal = psPoint[2] - pstLast->sZAxisVal;
+
+        pstLast->sXAxisVal = psPoint[0];
+        pstLast->sYAxisVal = psPoint[1];
+        pstLast->sZAxisVal = psPoint[2];
+        punSumOfSquare[usPointCnt] = (GU32)((GS32)sXAxisVal * sXAxisVal) + (GU32)((GS32)sYAxisVal * sYAxisVal)
+                                     + (GU32)((GS32)sZAxisVal * sZAxisVal);
+    }
+}
+
+/**
+ * @fn     static void Gh3x2xGsMoveEnergy(const GS16 *psGsData, GU16 usPointNum, STGsAccRawdata *pstLast, GU32 punSumOfSquare[])
+ *
+ * @brief  sum of square of x/y/z difference to previous point, dsp extension kernel
+ *
+ * @attention   SSUB16 gives x/y differences in one word and z differences of two points in one word, SMUAD
+ *              squares and adds x/y, SMLAD adds square of z. Sum of three squares is below 2^32, so the wrapped
+ *              result is the same as Gh3x2xGsMoveEnergyRef, which is used without dsp extension
+ *
+ * @param[in]   psGsData        gsensor points, GH3X2X_GS_MOVE_STRIDE halfwords each
+ * @param[in]   usPointNum      point num
+ * @param[in]   pstLast         point before psGsData, updated to last point
+ * @param[out]  punSumOfSquare  sum of square of every point
+ *
+ * @return  None
+ */
+static void Gh3x2xGsMoveEnergy(const GS16 *psGsData, GU16 usPointNum, STGsAccRawdata *pstLast, GU32 punSumOfSquare[])
+{
+#if (GH3X2X_GS_MOVE_DSP_EN)
+    GU32 unPrevXy = __PKHBT((GU16)pstLast->sXAxisVal, (GU16)pstLast->sYAxisVal, 16);
+    GU32 unPrevZ = (GU16)pstLast->sZAxisVal;
+    GU16 usPointCnt = 0;
+
+#if __GS_GYRO_ENABLE__
+    for (; usPointCnt < usPointNum; usPointCnt++)
+    {
+        /* x/y, z/gyro x of one point */
+        const GS16 *psPoint = &psGsData[usPointCnt * GH3X2X_GS_MOVE_STRIDE];
+        GU32 unXy = __UNALIGNED_UINT32_READ(&psPoint[0]);
+        GU32 unZ = (GU16)psPoint[2];
+        GU32 unDxy = __SSUB16(unXy, unPrevXy);
+        GU32 unDz = __SSUB16(unZ, unPrevZ) & 0xFFFF;
+
+        punSumOfSquare[usPointCnt] = __SMLAD(unDz, unDz, __SMUAD(unDxy, unDxy));
+        unPrevXy = unXy;
+        unPrevZ = unZ;
+    }
+#else
+    for (; (usPointCnt + 2) <= usPointNum; usPointCnt += 2)
+    {
+        /* x0/y0, z0/x1, y1/z1 of two points */
+        const GS16 *psPoint = &psGsData[usPointCnt * GH3X2X_GS_MOVE_STRIDE];
+        GU32 unWord0 = __UNALIGNED_UINT32_READ(&psPoint[0]);
+        GU32 unWord1 = __UNALIGNED_UINT32_READ(&psPoint[2]);
+        GU32 unWord2 = __UNALIGNED_UINT32_READ(&psPoint[4]);
+        GU32 unXy1 = __PKHBT(unWord1 >> 16, unWord2, 16);
+        GU32 unZ = __PKHTB(unWord2, unWord1, 0);
+        GU32 unDxy0 = __SSUB16(unWord0, unPrevXy);
+        GU32 unDxy1 = __SSUB16(unXy1, unWord0);
+        GU32 unDz = __SSUB16(unZ, __PKHBT(unPrevZ, unZ, 16));
+
+        punSumOfSquare[usPointCnt] = __SMLAD(unDz & 0xFFFF, unDz, __SMUAD(unDxy0, unDxy0));
+        punSumOfSquare[usPointCnt + 1] = __SMLAD(unDz >> 16, unDz >> 16, __SMUAD(unDxy1, unDxy1));
+        unPrevXy = unXy1;
+        unPrevZ = unZ >> 16;
+    }
+#endif
+    pstLast->sXAxisVal = (GS16)unPrevXy;
+    pstLast->sYAxisVal = (GS16)(unPrevXy >> 16);
+    pstLast->sZAxisVal = (GS16)unPrevZ;
+    if (usPointCnt < usPointNum)
+    {
+        Gh3x2xGsMoveEnergyRef(&psGsData[usPointCnt * GH3X2X_GS_MOVE_STRIDE], usPointNum - usPointCnt, pstLast,
+                              &punSumOfSquare[usPointCnt]);
+    }
+#else
+    Gh3x2xGsMoveEnergyRef(psGsData, usPointNum, pstLast, punSumOfSquare);
+#endif
+}
+
+/**
+ * @fn     static void Gh3x2xGsMoveEffect(void)
+ *
+ * @brief  movement is confirmed, start hard adt or redetect wear on
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xGsMoveEffect(void)
+{
+    GH3X2X_DEMO_LOG_PARAM_ADT("over g_unGsMoveCntThreshold!!! \r\n");
+    g_uchDecByCapResult = 0;
+    g_uchGsensorStatus = GH3X2X_SENSOR_IS_MOVING;
+    GH3X2X_DEMO_LOG_PARAM_ADT("Move detect effect!!! \r\n");
+    if (((GH3X2X_GetFuncStartedBitmap()) & (GH3X2X_FUNCTION_ADT)) != (GH3X2X_FUNCTION_ADT))
+    {
+        GH3X2X_DEMO_LOG_PARAM_ADT("start hard adt!!! \r\n");
+        GH3X2X_StartHardAdtAndResetGsDetect();
+    }
+    else  //adt sample is open
+    {
+        GH3X2X_RedetectWearOn();  //it can trigle a wear on event(INT) when it is detecting wear off
+    }
+    GH3X2X_EnterLowPowerMode();
+}
+
 /**
  * @fn      void GH3X2X_MoveDetectByGsData(STGsensorRawdata* stGsData, GU16 usGsDataCnt, GU8 uchCheckWindowSize)
  
  *
  * @brief  Move detection by software.
  *
- * @attention   None
+ * @attention   Sum of square of every point is calculated by chunks of GH3X2X_GS_MOVE_CHUNK_NUM points. Once
+ *              movement is confirmed, points after it are not checked and the last point of block is kept for
+ *              next block.
  *
  * @param[in]   stGsData        gsensor data buffer
  * @param[in]   usGsDataCnt        gsensor data count
@@ -153,12 +301,9 @@ void GH3X2X_MoveDetectByCapData(STCapRawdata* pusCapData, GU16 usCapDataCnt)
 //extern void SlaverLog(const char * lpsbLog, ...);
 void GH3X2X_MoveDetectByGsData(GS16* pusGsData, GU16 usGsDataCnt)
 {
-    GS16 sXAxisVal = 0;
-    GS16 sYAxisVal = 0;
-    GS16 sZAxisVal = 0;
-    GU8  uchGyroEnable = g_uchGyroEnable;
-    GU32 unSumOfSquare = 0;    
+    GU32 unSumOfSquare[GH3X2X_GS_MOVE_CHUNK_NUM];
     GU16  usGsDataIndex = 0;
+    GU8 uchMoveEffect = 0;
     if ((GH3X2X_PTR_NULL == pusGsData) || (0 == usGsDataCnt))
     {
         return;
@@ -173,64 +318,198 @@ void GH3X2X_MoveDetectByGsData(GS16* pusGsData, GU16 usGsDataCnt)
             g_LastPointAdtGsenorRawdata.sZAxisVal = pusGsData[0+2];
             g_uchGsMoveDetectFirstTime = 0;
         }
-        //calculate average of x, y, z
-        for (usGsDataIndex = 0; usGsDataIndex < usGsDataCnt; usGsDataIndex++)
+        while ((usGsDataIndex < usGsDataCnt) && (0 == uchMoveEffect))
         {
-            sXAxisVal = pusGsData[usGsDataIndex*(3+3*uchGyroEnable)] - g_LastPointAdtGsenorRawdata.sXAxisVal;
-            sYAxisVal = pusGsData[usGsDataIndex*(3+3*uchGyroEnable) + 1] - g_LastPointAdtGsenorRawdata.sYAxisVal;
-            sZAxisVal = pusGsData[usGsDataIndex*(3+3*uchGyroEnable) + 2] - g_LastPointAdtGsenorRawdata.sZAxisVal;
-
-            g_LastPointAdtGsenorRawdata.sXAxisVal = pusGsData[usGsDataIndex*(3+3*uchGyroEnable)];
-            g_LastPointAdtGsenorRawdata.sYAxisVal = pusGsData[usGsDataIndex*(3+3*uchGyroEnable) + 1];
-            g_LastPointAdtGsenorRawdata.sZAxisVal = pusGsData[usGsDataIndex*(3+3*uchGyroEnable) + 2];
+            GU16 usChunkNum = NADT_MIN(GH3X2X_GS_MOVE_CHUNK_NUM, usGsDataCnt - usGsDataIndex);
 
-
-            unSumOfSquare = (GU32)((GS32)sXAxisVal * sXAxisVal) + (GU32)((GS32)sYAxisVal * sYAxisVal) + (GU32)((GS32)sZAxisVal * sZAxisVal);
-
-            if(unSumOfSquare > g_unGsMoveThreshold)
+            Gh3x2xGsMoveEnergy(&pusGsData[usGsDataIndex * GH3X2X_GS_MOVE_STRIDE], usChunkNum,
+                               &g_LastPointAdtGsenorRawdata, unSumOfSquare);
+            for (GU16 usChunkCnt = 0; usChunkCnt < usChunkNum; usChunkCnt++)
             {
-                g_usGsMoveDetectCnt ++;
-                GH3X2X_DEMO_LOG_PARAM_ADT("g_usGsMoveDetectCnt = %d \r\n", g_usGsMoveDetectCnt);
-                g_usGsNotMoveDetectCnt = 0;
-                if (g_usGsMoveDetectCnt > g_unGsMoveCntThreshold && g_uchDecByCapResult == 1)
+                if(unSumOfSquare[usChunkCnt] > g_unGsMoveThreshold)
                 {
-                    GH3X2X_DEMO_LOG_PARAM_ADT("over g_unGsMoveCntThreshold!!! \r\n");
-                    g_uchDecByCapResult = 0;
-                    g_uchGsensorStatus = GH3X2X_SENSOR_IS_MOVING;
-                    GH3X2X_DEMO_LOG_PARAM_ADT("Move detect effect!!! \r\n");
-                    if (((GH3X2X_GetFuncStartedBitmap()) & (GH3X2X_FUNCTION_ADT)) != (GH3X2X_FUNCTION_ADT))
-                    {
-                        GH3X2X_DEMO_LOG_PARAM_ADT("start hard adt!!! \r\n");
-                        GH3X2X_StartHardAdtAndResetGsDetect();
-                    }
-                    else  //adt sample is open
+                    g_usGsMoveDetectCnt ++;
+                    g_usGsNotMoveDetectCnt = 0;
+                    if (g_usGsMoveDetectCnt > g_unGsMoveCntThreshold && g_uchDecByCapResult == 1)
                     {
-                        GH3X2X_RedetectWearOn();  //it can trigle a wear on event(INT) when it is detecting wear off
+                        uchMoveEffect = 1;
+                        break;
                     }
-                    GH3X2X_EnterLowPowerMode();
-                    
                 }
-            }
-            else
-            {
-                if (g_usGsMoveDetectCnt != 0)
+                else
                 {
-                    g_usGsNotMoveDetectCnt ++;
-                    GH3X2X_DEMO_LOG_PARAM_ADT("g_usGsNotMoveDetectCnt = %d \r\n", g_usGsNotMoveDetectCnt);
-                    
-                    if (g_usGsNotMoveDetectCnt >= g_unGsNotMoveCntThreshold)
+                    if (g_usGsMoveDetectCnt != 0)
                     {
-                        g_usGsMoveDetectCnt = 0;
-                        g_uchGsensorStatus = GH3X2X_SENSOR_IS_NOT_MOVING;
-                        GH3X2X_DEMO_LOG_PARAM_ADT("Move detect is not effect!!! \r\n");
+                        g_usGsNotMoveDetectCnt ++;
+                        if (g_usGsNotMoveDetectCnt >= g_unGsNotMoveCntThreshold)
+                        {
+                            g_usGsMoveDetectCnt = 0;
+                            g_uchGsensorStatus = GH3X2X_SENSOR_IS_NOT_MOVING;
+                            GH3X2X_DEMO_LOG_PARAM_ADT("Move detect is not effect!!! \r\n");
+                        }
                     }
                 }
             }
+            usGsDataIndex += usChunkNum;
+        }
+        GH3X2X_DEMO_LOG_PARAM_ADT("g_usGsMoveDetectCnt = %d, g_usGsNotMoveDetectCnt = %d \r\n",
+                                  g_usGsMoveDetectCnt, g_usGsNotMoveDetectCnt);
+        if (uchMoveEffect)
+        {
+            const GS16 *psLastPoint = &pusGsData[(usGsDataCnt - 1) * GH3X2X_GS_MOVE_STRIDE];
+
+            g_LastPointAdtGsenorRawdata.sXAxisVal = psLastPoint[0];
+            g_LastPointAdtGsenorRawdata.sYAxisVal = psLastPoint[1];
+            g_LastPointAdtGsenorRawdata.sZAxisVal = psLastPoint[2];
+            Gh3x2xGsMoveEffect();
         }
         g_uchDecByCapResult = 0;
     }
 }
 
+#if (__GH3X2X_MOVE_DETECT_BENCHMARK_EN__)
+
+#define GH3X2X_GS_MOVE_BENCH_LOOP_NUM       (100)       /**< run times of every benchmark case */
+#define GH3X2X_GS_MOVE_BENCH_POINT_MAX      (100)       /**< points of 1s block at 100Hz */
+#if (GH3X2X_GS_MOVE_DSP_EN)
+#define GH3X2X_GS_MOVE_BENCH_KERNEL_NAME    "dsp kernel"
+#else
+#define GH3X2X_GS_MOVE_BENCH_KERNEL_NAME    "kernel(c reference)"
+#endif
+
+/// sum of square and last point of one benchmark case
+typedef struct
+{
+    GU32 unSumOfSquare[GH3X2X_GS_MOVE_BENCH_POINT_MAX];
+    STGsAccRawdata stLast;
+} STGh3x2xGsMoveBenchOut;
+
+/// args of one move detect benchmark case
+typedef struct
+{
+    void (*pEnergyFunc)(const GS16 *psGsData, GU16 usPointNum, STGsAccRawdata *pstLast, GU32 punSumOfSquare[]);
+    GS16 *psGsData;
+    GU16 usPointNum;
+    STGh3x2xGsMoveBenchOut *pstOut;
+} STGh3x2xGsMoveBenchArg;
+
+/**
+ * @fn     static void Gh3x2xGsMoveEnergyBenchmarkCase(void *pvArg)
+ *
+ * @brief  one sum of square of benchmark case
+ *
+ * @attention   None
+ *
+ * @param[in]   pvArg           pointer to STGh3x2xGsMoveBenchArg
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xGsMoveEnergyBenchmarkCase(void *pvArg)
+{
+    const STGh3x2xGsMoveBenchArg *pstArg = (const STGh3x2xGsMoveBenchArg *)pvArg;
+
+    pstArg->pEnergyFunc(pstArg->psGsData, pstArg->usPointNum, &pstArg->pstOut->stLast, pstArg->pstOut->unSumOfSquare);
+}
+
+/**
+ * @fn     static void Gh3x2xGsMoveDetectBenchmarkCase(void *pvArg)
+ *
+ * @brief  one GH3X2X_MoveDetectByGsData of benchmark case
+ *
+ * @attention   None
+ *
+ * @param[in]   pvArg           pointer to STGh3x2xGsMoveBenchArg
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xGsMoveDetectBenchmarkCase(void *pvArg)
+{
+    const STGh3x2xGsMoveBenchArg *pstArg = (const STGh3x2xGsMoveBenchArg *)pvArg;
+
+    GH3X2X_MoveDetectByGsData(pstArg->psGsData, pstArg->usPointNum);
+}
+
+/**
+ * @fn     void Gh3x2xGsMoveDetectBenchmark(void)
+ *
+ * @brief  benchmark of gsensor move detect with 1s blocks of 25/50/100Hz, kernel vs c reference of sum of
+ *         square and whole GH3X2X_MoveDetectByGsData, and bit-for-bit check of sum of square
+ *
+ * @attention   result is printed by EXAMPLE_LOG, run by shell cmd gh3x2x_bench move. Movement is never
+ *              confirmed while running, detect state is restored after
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xGsMoveDetectBenchmark(void)
+{
+    static const struct
+    {
+        GU16 usPointNum;
+        const GCHAR *pchRefName;
+        const GCHAR *pchKernelName;
+        const GCHAR *pchDetectName;
+        const GCHAR *pchCheckName;
+    } stBenchRate[] =
+    {
+        {25, "move energy c reference 25Hz", "move energy " GH3X2X_GS_MOVE_BENCH_KERNEL_NAME " 25Hz", "move detect 25Hz", "move energy 25Hz"},
+        {50, "move energy c reference 50Hz", "move energy " GH3X2X_GS_MOVE_BENCH_KERNEL_NAME " 50Hz", "move detect 50Hz", "move energy 50Hz"},
+        {100, "move energy c reference 100Hz", "move energy " GH3X2X_GS_MOVE_BENCH_KERNEL_NAME " 100Hz", "move detect 100Hz", "move energy 100Hz"},
+    };
+    static GS16 sBenchData[GH3X2X_GS_MOVE_BENCH_POINT_MAX * GH3X2X_GS_MOVE_STRIDE];
+    static STGh3x2xGsMoveBenchOut stRefOut;
+    static STGh3x2xGsMoveBenchOut stKernelOut;
+    STGsAccRawdata stLastSave = g_LastPointAdtGsenorRawdata;
+    GU32 unThresholdSave = g_unGsMoveThreshold;
+    GU16 usMoveCntSave = g_usGsMoveDetectCnt;
+    GU16 usNotMoveCntSave = g_usGsNotMoveDetectCnt;
+    GU8 uchStatusSave = g_uchGsensorStatus;
+    GU8 uchConfirmEnableSave = g_uchAdtWithConfirmEnable;
+    GU8 uchFirstTimeSave = g_uchGsMoveDetectFirstTime;
+    GU8 uchCapResultSave = g_uchDecByCapResult;
+
+    Gh3x2xBenchmarkFill(sBenchData, sizeof(sBenchData));     //full range to cover wrapped difference
+    g_unGsMoveThreshold = 0xFFFFFFFF;
+    g_uchAdtWithConfirmEnable = 1;
+    g_uchDecByCapResult = 0;
+
+    for (GU8 uchRateCnt = 0; uchRateCnt < (sizeof(stBenchRate) / sizeof(stBenchRate[0])); uchRateCnt++)
+    {
+        GU16 usPointNum = stBenchRate[uchRateCnt].usPointNum;
+        STGh3x2xGsMoveBenchArg stArg = {Gh3x2xGsMoveEnergyRef, sBenchData, usPointNum, &stRefOut};
+
+        memset(&stRefOut, 0, sizeof(stRefOut));
+        memset(&stKernelOut, 0, sizeof(stKernelOut));
+        stRefOut.stLast = (STGsAccRawdata){INT16_MIN, INT16_MAX, 0};
+        stKernelOut.stLast = stRefOut.stLast;
+
+        Gh3x2xBenchmarkRun(stBenchRate[uchRateCnt].pchRefName, Gh3x2xGsMoveEnergyBenchmarkCase, &stArg,
+                           GH3X2X_GS_MOVE_BENCH_LOOP_NUM, usPointNum, "point");
+        stArg.pEnergyFunc = Gh3x2xGsMoveEnergy;
+        stArg.pstOut = &stKernelOut;
+        Gh3x2xBenchmarkRun(stBenchRate[uchRateCnt].pchKernelName, Gh3x2xGsMoveEnergyBenchmarkCase, &stArg,
+                           GH3X2X_GS_MOVE_BENCH_LOOP_NUM, usPointNum, "point");
+        Gh3x2xBenchmarkRun(stBenchRate[uchRateCnt].pchDetectName, Gh3x2xGsMoveDetectBenchmarkCase, &stArg,
+                           GH3X2X_GS_MOVE_BENCH_LOOP_NUM, usPointNum, "point");
+        Gh3x2xBenchmarkCheck(stBenchRate[uchRateCnt].pchCheckName, &stRefOut, &stKernelOut, sizeof(stRefOut));
+    }
+
+    g_LastPointAdtGsenorRawdata = stLastSave;
+    g_unGsMoveThreshold = unThresholdSave;
+    g_usGsMoveDetectCnt = usMoveCntSave;
+    g_usGsNotMoveDetectCnt = usNotMoveCntSave;
+    g_uchGsensorStatus = uchStatusSave;
+    g_uchAdtWithConfirmEnable = uchConfirmEnableSave;
+    g_uchGsMoveDetectFirstTime = uchFirstTimeSave;
+    g_uchDecByCapResult = uchCapResultSave;
+}
+
+#endif
+
 /**
  * @fn     void Gh3x2x_ResetMoveDetectByGsData(void)
  *
@@ -0,0 +1,245 @@
+/**
+ * @copyright (c) 2003 - 2022, Goodix Co., Ltd. All rights reserved.
+ *
+ * @file    gh3x2x_demo_stage_prof.c
+ *
+ * @brief   gh3x2x driver lib demo code for cpu cycle profiling of int process stages
+ *
+ * @author  Gooidx Iot Team
+ *
+ */
+#include "stdint.h"
+#include "string.h"
+#include "gh3x2x_demo_inner.h"
+
+#if (__GH3X2X_STAGE_PROF_EN__)
+
+#include <zephyr/kernel.h>
+#if defined(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+#define GH3X2X_STAGE_PROF_HIST_NUM          (32)        /**< bin n counts passes of [2^n, 2^(n+1)) cycles */
+
+/// statistics of one stage
+typedef struct
+{
+    GU32 unCnt;
+    GU32 unMin;
+    GU32 unMax;
+    uint64_t ullSum;
+    GU32 unHist[GH3X2X_STAGE_PROF_HIST_NUM];
+} STGh3x2xStageProfStat;
+
+/// name of stage in dump
+static const GCHAR *const g_pszGh3x2xStageName[GH3X2X_STAGE_NUM] =
+{
+    "int pass", "irq read", "fifo read", "ecg cali", "lead", "agc", "protocol", "low power", "gsensor", "func process",
+};
+
+static STGh3x2xStageProfStat g_stGh3x2xStageProfStat[GH3X2X_STAGE_NUM];
+
+/// cycle counter at start of stage
+static GU32 g_unGh3x2xStageProfStart[GH3X2X_STAGE_NUM];
+
+/// cycles of stage in current pass, bit of stage in g_unGh3x2xStageProfRunMask is set if it ran
+static GU32 g_unGh3x2xStageProfPass[GH3X2X_STAGE_NUM];
+static GU32 g_unGh3x2xStageProfRunMask = 0;
+
+/**
+ * @fn     static GU8 Gh3x2xStageProfLog2(GU32 unCycle)
+ *
+ * @brief  get histogram bin of cycles
+ *
+ * @attention   None
+ *
+ * @param[in]   unCycle     cpu cycles
+ * @param[out]  None
+ *
+ * @return  floor(log2(unCycle)), 0 for 0 cycle
+ */
+static GU8 Gh3x2xStageProfLog2(GU32 unCycle)
+{
+    return (0 == unCycle) ? 0 : (GU8)(31 - __builtin_clz(unCycle));
+}
+
+/**
+ * @fn     void Gh3x2xStageProfStart(EMGh3x2xStage emStage)
+ *
+ * @brief  mark start of stage
+ *
+ * @attention   a start without end is dropped at next start
+ *
+ * @param[in]   emStage     stage
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xStageProfStart(EMGh3x2xStage emStage)
+{
+    g_unGh3x2xStageProfStart[emStage] = Gh3x2xCycleCntGet();
+}
+
+/**
+ * @fn     void Gh3x2xStageProfEnd(EMGh3x2xStage emStage)
+ *
+ * @brief  mark end of stage, cycles from start are added to the pass
+ *
+ * @attention   stage may run several times in one pass, it is counted once per pass
+ *
+ * @param[in]   emStage     stage
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xStageProfEnd(EMGh3x2xStage emStage)
+{
+    GU32 unCycle = Gh3x2xCycleCntGet() - g_unGh3x2xStageProfStart[emStage];
+    unsigned int unIrqKey = irq_lock();     //run mask is shared by int process and processing thread
+
+    if (g_unGh3x2xStageProfRunMask & (((GU32)1) << emStage))
+    {
+        g_unGh3x2xStageProfPass[emStage] += unCycle;
+    }
+    else
+    {
+        g_unGh3x2xStageProfPass[emStage] = unCycle;
+        g_unGh3x2xStageProfRunMask |= (((GU32)1) << emStage);
+    }
+    irq_unlock(unIrqKey);
+}
+
+/**
+ * @fn     void Gh3x2xStageProfDone(GU32 unStageMask)
+ *
+ * @brief  pass is done, add cycles of stages run in it to statistics
+ *
+ * @attention   every stage is owned by the thread calling this with its mask
+ *
+ * @param[in]   unStageMask     GH3X2X_STAGE_INT_MASK or GH3X2X_STAGE_BLOCK_MASK
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xStageProfDone(GU32 unStageMask)
+{
+    unsigned int unIrqKey = irq_lock();
+    GU32 unRunMask = g_unGh3x2xStageProfRunMask & unStageMask;
+
+    g_unGh3x2xStageProfRunMask &= ~unRunMask;
+    for (GU8 uchStage = 0; uchStage < GH3X2X_STAGE_NUM; uchStage++)
+    {
+        STGh3x2xStageProfStat *pstStat = &g_stGh3x2xStageProfStat[uchStage];
+        GU32 unCycle = g_unGh3x2xStageProfPass[uchStage];
+
+        if (0 == (unRunMask & (((GU32)1) << uchStage)))
+        {
+            continue;
+        }
+        if ((0 == pstStat->unCnt) || (unCycle < pstStat->unMin))
+        {
+            pstStat->unMin = unCycle;
+        }
+        if (unCycle > pstStat->unMax)
+        {
+            pstStat->unMax = unCycle;
+        }
+        pstStat->ullSum += unCycle;
+        pstStat->unCnt++;
+        pstStat->unHist[Gh3x2xStageProfLog2(unCycle)]++;
+    }
+    irq_unlock(unIrqKey);
+}
+
+/**
+ * @fn     void Gh3x2xStageProfReset(void)
+ *
+ * @brief  clear stage statistics
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xStageProfReset(void)
+{
+    unsigned int unIrqKey = irq_lock();
+
+    memset(g_stGh3x2xStageProfStat, 0, sizeof(g_stGh3x2xStageProfStat));
+    irq_unlock(unIrqKey);
+}
+
+/**
+ * @fn     void Gh3x2xStageProfDump(void)
+ *
+ * @brief  log min/avg/max and log2 histogram of every stage
+ *
+ * @attention   histogram bin is logged as upper bound in us: count
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xStageProfDump(void)
+{
+    static STGh3x2xStageProfStat stStat[GH3X2X_STAGE_NUM];
+    unsigned int unIrqKey = irq_lock();
+
+    /* log from a copy, profiling goes on while logging */
+    memcpy(stStat, g_stGh3x2xStageProfStat, sizeof(stStat));
+    irq_unlock(unIrqKey);
+
+    EXAMPLE_LOG("[StageProf]stage: pass, min us, avg us, max us\r\n");
+    for (GU8 uchStage = 0; uchStage < GH3X2X_STAGE_NUM; uchStage++)
+    {
+        STGh3x2xStageProfStat *pstStat = &stStat[uchStage];
+
+        if (0 == pstStat->unCnt)
+        {
+            continue;
+        }
+        EXAMPLE_LOG("[StageProf]%s: %u, %u, %u, %u\r\n", g_pszGh3x2xStageName[uchStage], (unsigned int)pstStat->unCnt,
+                    (unsigned int)Gh3x2xCycleToUs(pstStat->unMin),
+                    (unsigned int)Gh3x2xCycleToUs((GU32)(pstStat->ullSum / pstStat->unCnt)),
+                    (unsigned int)Gh3x2xCycleToUs(pstStat->unMax));
+        for (GU8 uchBin = Gh3x2xStageProfLog2(pstStat->unMin); uchBin <= Gh3x2xStageProfLog2(pstStat->unMax); uchBin++)
+        {
+            if (pstStat->unHist[uchBin])
+            {
+                EXAMPLE_LOG("[StageProf]  < %u us: %u\r\n",
+                            (unsigned int)Gh3x2xCycleToUs((uchBin < 31) ? (((GU32)2) << uchBin) : 0xFFFFFFFF),
+                            (unsigned int)pstStat->unHist[uchBin]);
+            }
+        }
+    }
+}
+
+#if defined(CONFIG_SHELL)
+
+static int Gh3x2xStageProfShellDump(const struct shell *pstShell, size_t unArgc, char **ppchArgv)
+{
+    Gh3x2xStageProfDump();
+    return 0;
+}
+
+static int Gh3x2xStageProfShellReset(const struct shell *pstShell, size_t unArgc, char **ppchArgv)
+{
+    Gh3x2xStageProfReset();
+    shell_print(pstShell, "gh3x2x stage profile cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(g_stGh3x2xStageProfShellCmd,
+    SHELL_CMD(dump, NULL, "log stage profile", Gh3x2xStageProfShellDump),
+    SHELL_CMD(reset, NULL, "clear stage profile", Gh3x2xStageProfShellReset),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(gh3x2x_prof, &g_stGh3x2xStageProfShellCmd, "gh3x2x int process stage profile", NULL);
+
+#endif
+
+#endif
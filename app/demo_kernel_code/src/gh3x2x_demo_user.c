@@ -17,15 +17,24 @@
 #include "gh3x2x_demo_inner.h"
 #include "gh3x2x_demo.h"
 
-#include "nrf_drv_spi.h"
-#include "app_util_platform.h"
-#include "nrf_gpio.h"
-#include "nrf_delay.h"
-#include "boards.h"
-#include "app_error.h"
-#include "nrf_log.h"
-#include "nrf_log_ctrl.h"
-#include "nrf_log_default_backends.h"
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/gpio.h>
+#if ( __GH3X2X_INTERFACE__ == __GH3X2X_INTERFACE_SPI__ )
+#include <zephyr/pm/device.h>
+#endif
+#if (__GH3X2X_INT_EDGE_CAPTURE_EN__)
+#include <nrfx_gpiote.h>
+#include <nrfx_timer.h>
+#include <helpers/nrfx_gppi.h>
+#endif
+#if (__GH3X2X_CYCLE_CNT_EN__) && defined(CONFIG_CPU_CORTEX_M_HAS_DWT)
+#include <soc.h>
+#endif
+#if (__GS_ZEPHYR_SENSOR_EN__)
+#include <zephyr/drivers/sensor.h>
+#endif
 
 #if (__DRIVER_LIB_MODE__ == __DRV_LIB_WITH_ALGO__)
 #include "gh3x2x_demo_algo_call.h"
@@ -35,158 +44,2573 @@
 #include "gh3x2x_mp_common.h"
 #endif
 
-#define SPI_INSTANCE  2 /**< SPI instance index. */
-static const nrf_drv_spi_t spi2 = NRF_DRV_SPI_INSTANCE(SPI_INSTANCE);  /**< SPI instance. */
-static volatile bool spi2_xfer_done;  /**< Flag used to indicate that SPI instance completed the transfer. */
+#define GH3X2X_DT_NODE                  DT_NODELABEL(gh3x2x)    /**< gh3x2x node in devicetree */
 
-static uint8_t       m_tx_buf[10] ;           /**< TX buffer. */
-static uint8_t          m_rx_buf2=0;
+#if (__GH3X2X_CYCLE_CNT_EN__)
+#if defined(CONFIG_CPU_CORTEX_M_HAS_DWT)
+
+/**
+ * @fn     void Gh3x2xCycleCntInit(void)
+ * 
+ * @brief  enable cpu cycle counter(DWT CYCCNT)
+ *
+ * @attention   k_cycle_get_32 is 32768Hz rtc on nrf52, too coarse for one bus transfer
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xCycleCntInit(void)
+{
+    if (0 == (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
 
-static   uint8_t       m_rx_buf[13];    /**< RX buffer. */
+/**
+ * @fn     GU32 Gh3x2xCycleCntGet(void)
+ * 
+ * @brief  get cpu cycle counter(DWT CYCCNT)
+ *
+ * @attention   Gh3x2xCycleCntInit must be called before
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  cpu cycle counter
+ */
+GU32 Gh3x2xCycleCntGet(void)
+{
+    return DWT->CYCCNT;
+}
 
 /**
- * @brief SPI user event handler.
- * @param event
+ * @fn     GU32 Gh3x2xCycleToUs(GU32 unCycle)
+ * 
+ * @brief  convert cpu cycles to us
+ *
+ * @attention   None
+ *
+ * @param[in]   unCycle     cpu cycles
+ * @param[out]  None
+ *
+ * @return  us
  */
-void spi2_event_handler(nrf_drv_spi_evt_t const * p_event,
-                       void *                    p_context)
+GU32 Gh3x2xCycleToUs(GU32 unCycle)
+{
+    return unCycle / (SystemCoreClock / 1000000);
+}
+
+#else
+
+/* no DWT(native_sim): kernel hw cycle counter, it runs on host clock */
+void Gh3x2xCycleCntInit(void)
+{
+}
+
+GU32 Gh3x2xCycleCntGet(void)
 {
-    spi2_xfer_done = true;
-    NRF_LOG_INFO(" Received:");
-    NRF_LOG_HEXDUMP_INFO(m_rx_buf, sizeof(m_tx_buf));
+    return k_cycle_get_32();
 }
 
-void spi2_init(void)
+GU32 Gh3x2xCycleToUs(GU32 unCycle)
 {
-    nrf_drv_spi_config_t spi_config = NRF_DRV_SPI_DEFAULT_CONFIG;
-    spi_config.ss_pin   = SPI2_SS_PIN;
-    spi_config.miso_pin = SPI2_MISO_PIN;
-    spi_config.mosi_pin = SPI2_MOSI_PIN;
-    spi_config.sck_pin  = SPI2_SCK_PIN;
-    APP_ERROR_CHECK(nrf_drv_spi_init(&spi2, &spi_config, spi2_event_handler, NULL));
+    return k_cyc_to_us_floor32(unCycle);
+}
+
+#endif
+#endif
+
+#if ( __GH3X2X_INTERFACE__ == __GH3X2X_INTERFACE_SPI__ )
+
+#define GH3X2X_SPI_NODE                 GH3X2X_DT_NODE          /**< gh3x2x node on spi bus */
+#define GH3X2X_SPI_OPERATION            (SPI_OP_MODE_MASTER | SPI_TRANSFER_MSB | SPI_WORD_SET(8))
+#define GH3X2X_SPI_XFER_TIMEOUT_MS      (100)                   /**< max time of one spi transfer */
+#define GH3X2X_SPI_ABORT_TIMEOUT_MS     (10)                    /**< wait for late callback before abort */
 
-    NRF_LOG_INFO("SPI example started.");
+#define GH3X2X_SPI_CMD_WRITE                (0xF0)      /**< spi frame head of reg addr/reg write */
+#define GH3X2X_SPI_CMD_SOFT_RESET           (0xC2)      /**< soft reset cmd */
+#define GH3X2X_SPI_REG_ADDR_FRAME_LEN       (3)         /**< F0 + addr(2 bytes) */
+#define GH3X2X_SPI_REG_WRITE_HEADER_LEN     (5)         /**< F0 + addr(2 bytes) + byte len(2 bytes) */
+#define GH3X2X_SPI_FIFO_ADDR                (0xAAAA)    /**< fifo data addr */
+
+/// spi bus, cs pin and frequency of gh3x2x, all from devicetree
+static const struct spi_dt_spec g_stGh3x2xSpiSpec = SPI_DT_SPEC_GET(GH3X2X_SPI_NODE, GH3X2X_SPI_OPERATION, 0);
+
+/// give by spi driver when EasyDMA transfer done
+static K_SEM_DEFINE(g_stGh3x2xSpiXferDoneSem, 0, 1);
+
+/// result of last spi transfer
+static volatile int g_nGh3x2xSpiXferResult = 0;
+
+/**
+ * @fn     static void Gh3x2xSpiXferDoneCallback(const struct device *pstDev, int nResult, void *pData)
+ * 
+ * @brief  callback of spi async transfer, called in spim isr
+ *
+ * @attention   None
+ *
+ * @param[in]   pstDev      spi device
+ * @param[in]   nResult     transfer result, 0 is ok
+ * @param[in]   pData       user data, not used
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xSpiXferDoneCallback(const struct device *pstDev, int nResult, void *pData)
+{
+    g_nGh3x2xSpiXferResult = nResult;
+    k_sem_give(&g_stGh3x2xSpiXferDoneSem);
 }
 
-uint8_t Sensor2_IO_Write(void *handle, uint8_t *pBuffer, uint16_t nBytesToWrite){
-    uint16_t time = 0;
-    spi2_xfer_done = false;
-    nrf_drv_spi_transfer(&spi2, pBuffer, nBytesToWrite, NULL, 0);
-    while(spi2_xfer_done == false)
+#if (__GH3X2X_BUS_STAT_EN__)
+
+#define GH3X2X_SPI_CMD_READ                 (0xF1)      /**< spi frame head of data read */
+
+/// reg addr of last addr frame, F1 read is counted to it
+static GU16 g_usGh3x2xSpiBusStatReadAddr = 0;
+
+#if (__GH3X2X_INT_FIFO_PREFETCH_EN__)
+extern const k_tid_t g_stGh3x2xFifoPrefetchThread;
+#endif
+
+/**
+ * @fn     static GU16 Gh3x2xSpiBufSetLen(const struct spi_buf_set *pstSet)
+ * 
+ * @brief  get total len of spi buffer set
+ *
+ * @attention   None
+ *
+ * @param[in]   pstSet      buffer set, can be NULL
+ * @param[out]  None
+ *
+ * @return  total len
+ */
+static GU16 Gh3x2xSpiBufSetLen(const struct spi_buf_set *pstSet)
+{
+    GU16 usLen = 0;
+
+    if (NULL != pstSet)
     {
-        nrf_delay_ms(10);
-        time++;
-        if(time > 100)
+        for (size_t unBufCnt = 0; unBufCnt < pstSet->count; unBufCnt++)
         {
-            return 0;
+            usLen += (GU16)pstSet->buffers[unBufCnt].len;
+        }
+    }
+    return usLen;
+}
+
+/**
+ * @fn     static void Gh3x2xSpiBusStatRecord(const struct spi_buf_set *pstTxSet, const struct spi_buf_set *pstRxSet,
+ *                                            GU32 unCycle)
+ * 
+ * @brief  count one spi transfer to its reg addr, addr is parsed from frame head
+ *
+ * @attention   addr frame and reg write are counted to their addr, F1 read to addr of last addr frame,
+ *              single byte frame is cmd
+ *
+ * @param[in]   pstTxSet    tx buffer set
+ * @param[in]   pstRxSet    rx buffer set, can be NULL
+ * @param[in]   unCycle     cpu cycles of transfer
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xSpiBusStatRecord(const struct spi_buf_set *pstTxSet, const struct spi_buf_set *pstRxSet, GU32 unCycle)
+{
+    const GU8 *puchFrame = (const GU8 *)pstTxSet->buffers[0].buf;
+    GU16 usTxLen = Gh3x2xSpiBufSetLen(pstTxSet);
+    GU16 usRxLen = Gh3x2xSpiBufSetLen(pstRxSet);
+    GU16 usByteNum = (usTxLen > usRxLen) ? usTxLen : usRxLen;
+    EMGh3x2xBusPhase emPhase = Gh3x2xBusStatPhaseGet();
+
+#if (__GH3X2X_INT_FIFO_PREFETCH_EN__)
+    if (k_current_get() == g_stGh3x2xFifoPrefetchThread)
+    {
+        emPhase = GH3X2X_BUS_PHASE_PREFETCH;
+    }
+#endif
+    if ((GH3X2X_SPI_CMD_WRITE == puchFrame[0]) && (pstTxSet->buffers[0].len >= GH3X2X_SPI_REG_ADDR_FRAME_LEN))
+    {
+        g_usGh3x2xSpiBusStatReadAddr = ((GU16)puchFrame[1] << 8) | puchFrame[2];
+        Gh3x2xBusStatRecord(emPhase, g_usGh3x2xSpiBusStatReadAddr, 0, usByteNum, unCycle);
+    }
+    else if (GH3X2X_SPI_CMD_READ == puchFrame[0])
+    {
+        Gh3x2xBusStatRecord(emPhase, g_usGh3x2xSpiBusStatReadAddr, 0, usByteNum, unCycle);
+    }
+    else
+    {
+        Gh3x2xBusStatRecord(emPhase, puchFrame[0], 1, usByteNum, unCycle);
+    }
+}
+
+#endif
+
+/**
+ * @fn     static void Gh3x2xSpiAbort(void)
+ * 
+ * @brief  stop a hung spi transfer and free spi bus
+ *
+ * @attention   spi driver has no abort api. Suspend of spim uninits nrfx spim, which stops EasyDMA and
+ *              disables its irq, so buffers of caller are not touched after; resume and next transfer init it
+ *              again. Needs CONFIG_PM_DEVICE
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xSpiAbort(void)
+{
+    if ((pm_device_action_run(g_stGh3x2xSpiSpec.bus, PM_DEVICE_ACTION_SUSPEND) < 0)
+        || (pm_device_action_run(g_stGh3x2xSpiSpec.bus, PM_DEVICE_ACTION_RESUME) < 0))
+    {
+        EXAMPLE_LOG("[%s]spim %s is not reset\r\n", __FUNCTION__, g_stGh3x2xSpiSpec.bus->name);
+    }
+    spi_release(g_stGh3x2xSpiSpec.bus, &g_stGh3x2xSpiSpec.config);
+}
+
+/**
+ * @fn     static GU8 Gh3x2xSpiTransceive(const struct spi_buf_set *pstTxSet, const struct spi_buf_set *pstRxSet)
+ * 
+ * @brief  start async spi transfer and sleep until EasyDMA done
+ *
+ * @attention   must be called in thread context, cpu will not spin while transfer. A timed out transfer
+ *              is failed; when its callback is still missing after GH3X2X_SPI_ABORT_TIMEOUT_MS, spim is reset
+ *
+ * @param[in]   pstTxSet    tx buffer set
+ * @param[in]   pstRxSet    rx buffer set, can be NULL
+ * @param[out]  None
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+static GU8 Gh3x2xSpiTransceive(const struct spi_buf_set *pstTxSet, const struct spi_buf_set *pstRxSet)
+{
+    GU8 uchRet = 0;
+#if (__GH3X2X_BUS_STAT_EN__)
+    GU32 unCycleStart = Gh3x2xCycleCntGet();
+#endif
+
+    k_sem_reset(&g_stGh3x2xSpiXferDoneSem);
+    if (spi_transceive_cb(g_stGh3x2xSpiSpec.bus, &g_stGh3x2xSpiSpec.config, pstTxSet, pstRxSet,
+                          Gh3x2xSpiXferDoneCallback, NULL) == 0)
+    {
+        if (k_sem_take(&g_stGh3x2xSpiXferDoneSem, K_MSEC(GH3X2X_SPI_XFER_TIMEOUT_MS)) == 0)
+        {
+            uchRet = (g_nGh3x2xSpiXferResult == 0) ? 1 : 0;
+        }
+        else
+        {
+            /* EasyDMA still owns buffers of caller, they must not go out of scope before it is stopped */
+            EXAMPLE_LOG("[%s]spi transfer timeout\r\n", __FUNCTION__);
+            if (k_sem_take(&g_stGh3x2xSpiXferDoneSem, K_MSEC(GH3X2X_SPI_ABORT_TIMEOUT_MS)) != 0)
+            {
+                Gh3x2xSpiAbort();
+            }
+        }
+    }
+#if (__GH3X2X_BUS_STAT_EN__)
+    Gh3x2xSpiBusStatRecord(pstTxSet, pstRxSet, Gh3x2xCycleCntGet() - unCycleStart);
+#endif
+    return uchRet;
+}
+
+#if (__GH3X2X_INT_FIFO_PREFETCH_EN__)
+
+#define GH3X2X_FIFO_PREFETCH_THREAD_STACK_SIZE  (1024)
+#define GH3X2X_FIFO_PREFETCH_THREAD_PRIORITY    (K_PRIO_COOP(2))    /**< run before any preemptible thread */
+#define GH3X2X_FIFO_WORD_BYTES                  (4)                 /**< fifo count reg counts 4 bytes words */
+
+/// bus owner lock, held from reg addr frame to its F1 read so prefetch can't move chip reg pointer between them
+static K_MUTEX_DEFINE(g_stGh3x2xSpiBusMutex);
+
+/// addr frame sent and F1 read not done yet, bus mutex is held once more for it
+static GU8 g_uchGh3x2xSpiBusPairLocked = 0;
+
+/// reg addr of last addr frame, and it is valid for next F1 read or not
+static GU16 g_usGh3x2xSpiReadAddr = 0;
+static GU8 g_uchGh3x2xSpiReadAddrValid = 0;
+
+/// give in int isr, prefetch thread reads fifo then
+static K_SEM_DEFINE(g_stGh3x2xFifoPrefetchSem, 0, 1);
+
+/// fifo data read out of chip but not yet taken by drv lib
+#if (__GH3X2X_RAWDATA_BUFFER_NUM__ > 1)
+static GU8 *g_puchGh3x2xFifoPrefetchBuffer = NULL;     //idle buffer of rawdata ring, drv lib reads next block into it
+#else
+static GU8 g_puchGh3x2xFifoPrefetchArr[__GH3X2X_RAWDATA_BUFFER_SIZE__];
+static GU8 *g_puchGh3x2xFifoPrefetchBuffer = g_puchGh3x2xFifoPrefetchArr;
+#endif
+static GU16 g_usGh3x2xFifoPrefetchOffset = 0;
+static GU16 g_usGh3x2xFifoPrefetchLen = 0;
+
+#define GH3X2X_SPI_BUS_LOCK()       k_mutex_lock(&g_stGh3x2xSpiBusMutex, K_FOREVER)
+#define GH3X2X_SPI_BUS_UNLOCK()     k_mutex_unlock(&g_stGh3x2xSpiBusMutex)
+
+/**
+ * @fn     static void Gh3x2xSpiBusTrackWrite(GU8 write_buffer[], GU16 length)
+ * 
+ * @brief  track reg addr frame of next F1 read, keep bus locked until the F1 read is done
+ *
+ * @attention   must be called with bus locked
+ *
+ * @param[in]   write_buffer    write data buffer
+ * @param[in]   length          write data len
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xSpiBusTrackWrite(GU8 write_buffer[], GU16 length)
+{
+    g_uchGh3x2xSpiReadAddrValid = 0;
+    if ((GH3X2X_SPI_REG_ADDR_FRAME_LEN == length) && (GH3X2X_SPI_CMD_WRITE == write_buffer[0]))
+    {
+        g_usGh3x2xSpiReadAddr = ((GU16)write_buffer[1] << 8) | write_buffer[2];
+        g_uchGh3x2xSpiReadAddrValid = 1;
+        if (0 == g_uchGh3x2xSpiBusPairLocked)
+        {
+            GH3X2X_SPI_BUS_LOCK();
+            g_uchGh3x2xSpiBusPairLocked = 1;
+        }
+    }
+    else if (g_uchGh3x2xSpiBusPairLocked)
+    {
+        g_uchGh3x2xSpiBusPairLocked = 0;
+        GH3X2X_SPI_BUS_UNLOCK();
+    }
+}
+
+/**
+ * @fn     static void Gh3x2xSpiBusReleasePair(void)
+ * 
+ * @brief  F1 read is done, release bus lock taken by its addr frame
+ *
+ * @attention   must be called with bus locked
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xSpiBusReleasePair(void)
+{
+    g_uchGh3x2xSpiReadAddrValid = 0;
+    if (g_uchGh3x2xSpiBusPairLocked)
+    {
+        g_uchGh3x2xSpiBusPairLocked = 0;
+        GH3X2X_SPI_BUS_UNLOCK();
+    }
+}
+
+/**
+ * @fn     static GU8 Gh3x2xSpiRawRead(GU16 usRegAddr, GU8 *puchBuffer, GU16 usLen)
+ * 
+ * @brief  addr frame + F1 read straight on bus, not through reg shadow
+ *
+ * @attention   must be called with bus locked
+ *
+ * @param[in]   usRegAddr   reg addr or fifo addr
+ * @param[in]   usLen       read len
+ * @param[out]  puchBuffer  read data
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+static GU8 Gh3x2xSpiRawRead(GU16 usRegAddr, GU8 *puchBuffer, GU16 usLen)
+{
+    GU8 puchAddrFrame[GH3X2X_SPI_REG_ADDR_FRAME_LEN] = {GH3X2X_SPI_CMD_WRITE, (GU8)(usRegAddr >> 8), (GU8)usRegAddr};
+    GU8 uchCmdRead = 0xF1;
+    const struct spi_buf stAddrBuf = {.buf = puchAddrFrame, .len = GH3X2X_SPI_REG_ADDR_FRAME_LEN};
+    const struct spi_buf_set stAddrSet = {.buffers = &stAddrBuf, .count = 1};
+    const struct spi_buf stCmdBuf = {.buf = &uchCmdRead, .len = 1};
+    const struct spi_buf_set stCmdSet = {.buffers = &stCmdBuf, .count = 1};
+    const struct spi_buf pstRxBuf[2] =
+    {
+        {.buf = NULL, .len = 1},
+        {.buf = puchBuffer, .len = usLen},
+    };
+    const struct spi_buf_set stRxSet = {.buffers = pstRxBuf, .count = 2};
+
+    if (0 == Gh3x2xSpiTransceive(&stAddrSet, NULL))
+    {
+        return 0;
+    }
+    return Gh3x2xSpiTransceive(&stCmdSet, &stRxSet);
+}
+
+/**
+ * @fn     static void Gh3x2xFifoPrefetchDrop(void)
+ * 
+ * @brief  drop prefetched fifo data, chip fifo is cleared by reset
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xFifoPrefetchDrop(void)
+{
+    g_usGh3x2xFifoPrefetchOffset = 0;
+    g_usGh3x2xFifoPrefetchLen = 0;
+}
+
+/**
+ * @fn     static void Gh3x2xFifoPrefetch(void)
+ * 
+ * @brief  read fifo count and fifo data into prefetch buffer right after int edge
+ *
+ * @attention   fifo words in chip are read out only up to free space of prefetch buffer. With rawdata ring, the
+ *              prefetch buffer is the idle ring buffer, so the dma runs while int work processes current block
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xFifoPrefetch(void)
+{
+    GU8 puchFifoCnt[2] = {0};
+    GU16 usReadLen = 0;
+
+    GH3X2X_SPI_BUS_LOCK();
+    if (0 == g_usGh3x2xFifoPrefetchLen)
+    {
+        g_usGh3x2xFifoPrefetchOffset = 0;
+#if (__GH3X2X_RAWDATA_BUFFER_NUM__ > 1)
+        g_puchGh3x2xFifoPrefetchBuffer = Gh3x2xDemoGetIdleRawdataBuffer();
+#endif
+    }
+    if ((NULL != g_puchGh3x2xFifoPrefetchBuffer) &&
+        Gh3x2xSpiRawRead(GH3X2X_INT_FIFO_UR_REG_ADDR, puchFifoCnt, sizeof(puchFifoCnt)))
+    {
+        usReadLen = (((GU16)puchFifoCnt[0] << 8) | puchFifoCnt[1]) * GH3X2X_FIFO_WORD_BYTES;
+        if (usReadLen > (__GH3X2X_RAWDATA_BUFFER_SIZE__ - g_usGh3x2xFifoPrefetchOffset - g_usGh3x2xFifoPrefetchLen))
+        {
+            usReadLen = __GH3X2X_RAWDATA_BUFFER_SIZE__ - g_usGh3x2xFifoPrefetchOffset - g_usGh3x2xFifoPrefetchLen;
+            usReadLen -= usReadLen % GH3X2X_FIFO_WORD_BYTES;
         }
     }
-	return 1;
+    if ((usReadLen > 0) && Gh3x2xSpiRawRead(GH3X2X_SPI_FIFO_ADDR,
+        &g_puchGh3x2xFifoPrefetchBuffer[g_usGh3x2xFifoPrefetchOffset + g_usGh3x2xFifoPrefetchLen], usReadLen))
+    {
+        g_usGh3x2xFifoPrefetchLen += usReadLen;
+    }
+    GH3X2X_SPI_BUS_UNLOCK();
+#if (__GH3X2X_INT_LATENCY_MEASURE_EN__)
+    Gh3x2xIntLatencyFifoDataReady();
+#endif
+}
+
+/**
+ * @fn     static GU16 Gh3x2xFifoPrefetchServe(GU8 read_buffer[], GU16 length)
+ * 
+ * @brief  serve F1 read of fifo from prefetch buffer
+ *
+ * @attention   must be called with bus locked. Drv lib reads a block from start of its buffer, so when it is the
+ *              prefetch buffer, data is already in place or moves toward start
+ *
+ * @param[in]   length          read data len
+ * @param[out]  read_buffer     pointer to read buffer
+ *
+ * @return  len served from prefetch buffer
+ */
+static GU16 Gh3x2xFifoPrefetchServe(GU8 read_buffer[], GU16 length)
+{
+    GU16 usServeLen = (length < g_usGh3x2xFifoPrefetchLen) ? length : g_usGh3x2xFifoPrefetchLen;
+
+    if (read_buffer != &g_puchGh3x2xFifoPrefetchBuffer[g_usGh3x2xFifoPrefetchOffset])
+    {
+        memmove(read_buffer, &g_puchGh3x2xFifoPrefetchBuffer[g_usGh3x2xFifoPrefetchOffset], usServeLen);
+    }
+    g_usGh3x2xFifoPrefetchOffset += usServeLen;
+    g_usGh3x2xFifoPrefetchLen -= usServeLen;
+    if (0 == g_usGh3x2xFifoPrefetchLen)
+    {
+        g_usGh3x2xFifoPrefetchOffset = 0;
+    }
+    return usServeLen;
 }
 
-uint8_t Sensor2_IO_Read(void *handle, uint8_t wrbyte, uint8_t *pBuffer2, uint16_t nBytesToRead){
-        
-    uint8_t buff[nBytesToRead+1];
-    uint16_t time = 0;
-    spi2_xfer_done = false;       
-    nrf_drv_spi_transfer(&spi2,&wrbyte,1,buff,nBytesToRead+1);
-    while(spi2_xfer_done == false)
+/**
+ * @fn     static void Gh3x2xFifoPrefetchAdjustCnt(GU8 read_buffer[])
+ * 
+ * @brief  add prefetched words to fifo count read from chip, drv lib sees the count as if nothing read
+ *
+ * @attention   None
+ *
+ * @param[in]   read_buffer     fifo count read from chip, big endian
+ * @param[out]  read_buffer     fifo count with prefetched words
+ *
+ * @return  None
+ */
+static void Gh3x2xFifoPrefetchAdjustCnt(GU8 read_buffer[])
+{
+    GU16 usFifoCnt = (((GU16)read_buffer[0] << 8) | read_buffer[1]) + (g_usGh3x2xFifoPrefetchLen / GH3X2X_FIFO_WORD_BYTES);
+
+    read_buffer[0] = (GU8)(usFifoCnt >> 8);
+    read_buffer[1] = (GU8)usFifoCnt;
+}
+
+/**
+ * @fn     static void Gh3x2xFifoPrefetchThread(void *p1, void *p2, void *p3)
+ * 
+ * @brief  thread waked by int isr, read fifo before int process is scheduled
+ *
+ * @attention   None
+ *
+ * @param[in]   p1  not used
+ * @param[in]   p2  not used
+ * @param[in]   p3  not used
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xFifoPrefetchThread(void *p1, void *p2, void *p3)
+{
+    while (1)
+    {
+        k_sem_take(&g_stGh3x2xFifoPrefetchSem, K_FOREVER);
+        Gh3x2xFifoPrefetch();
+        hal_gh3x2x_int_handler_call_back();
+    }
+}
+
+K_THREAD_DEFINE(g_stGh3x2xFifoPrefetchThread, GH3X2X_FIFO_PREFETCH_THREAD_STACK_SIZE, Gh3x2xFifoPrefetchThread,
+                NULL, NULL, NULL, GH3X2X_FIFO_PREFETCH_THREAD_PRIORITY, 0, 0);
+
+#else
+
+#define GH3X2X_SPI_BUS_LOCK()
+#define GH3X2X_SPI_BUS_UNLOCK()
+
+#endif
+
+#endif
+
+#if (__GH3X2X_REG_SHADOW_EN__)
+
+/// reg addr range, [usStartAddr, usEndAddr]
+typedef struct
+{
+    GU16 usStartAddr;
+    GU16 usEndAddr;
+} STGh3x2xRegShadowRange;
+
+/// reg addr range that only changed by mcu, chip changes led drv and tia cfg only at tuning done/fail and reset
+static const STGh3x2xRegShadowRange g_stGh3x2xRegShadowRangeArr[] =
+{
+    {0x0000, 0x0000},   /* sample start ctrl, only drv lib and demo write it, cleared by chip only at reset */
+    {0x0100, 0x01FE},   /* slot cfg */
+    {0x0200, 0x02FE},   /* adc cfg */
+    {0x0400, 0x04FE},   /* led drv and tia cfg */
+};
+
+/// reg addr range changed by chip, never cached; checked first so no cached range can cover them
+static const STGh3x2xRegShadowRange g_stGh3x2xRegShadowVolatileArr[] =
+{
+    {0x0002, 0x007E},   /* rest of top ctrl, not all regs are known as static */
+    {GH3X2X_INT_FIFO_UR_REG_ADDR & 0xFF00, (GH3X2X_INT_FIFO_UR_REG_ADDR & 0xFF00) | 0x00FE},  /* irq status and fifo use cnt */
+    {0xAAAA, 0xAAAA},   /* fifo data */
+};
+
+#define GH3X2X_REG_SHADOW_SIZE              (1 + (0x0100 + 0x0100 + 0x0100) / 2)
+
+/// shadow value of every cacheable reg
+static GU16 g_pusGh3x2xRegShadowVal[GH3X2X_REG_SHADOW_SIZE];
+
+/// valid bit of every cacheable reg
+static GU8 g_puchGh3x2xRegShadowValid[(GH3X2X_REG_SHADOW_SIZE + 7) / 8];
+
+/// addr frame of reg read held until F1 read comes
+static GU8 g_puchGh3x2xRegShadowAddrFrame[GH3X2X_SPI_REG_ADDR_FRAME_LEN];
+static GU8 g_uchGh3x2xRegShadowAddrFrameHeld = 0;
+static GU8 g_uchGh3x2xRegShadowAddrFrameValid = 0;
+
+/// shadow statistics
+static STGh3x2xRegShadowStat g_stGh3x2xRegShadowStat = {0};
+
+/**
+ * @fn     static GS16 Gh3x2xRegShadowGetIndex(GU16 usRegAddr)
+ * 
+ * @brief  get shadow index of reg
+ *
+ * @attention   None
+ *
+ * @param[in]   usRegAddr       reg addr
+ * @param[out]  None
+ *
+ * @return  shadow index, -1 if reg is volatile or out of shadow range
+ */
+static GS16 Gh3x2xRegShadowGetIndex(GU16 usRegAddr)
+{
+    GS16 sIndexBase = 0;
+
+    if (usRegAddr & 0x0001)
+    {
+        return -1;
+    }
+    for (GU8 uchRangeCnt = 0; uchRangeCnt < sizeof(g_stGh3x2xRegShadowVolatileArr) / sizeof(g_stGh3x2xRegShadowVolatileArr[0]); uchRangeCnt++)
+    {
+        if ((usRegAddr >= g_stGh3x2xRegShadowVolatileArr[uchRangeCnt].usStartAddr)
+            && (usRegAddr <= g_stGh3x2xRegShadowVolatileArr[uchRangeCnt].usEndAddr))
+        {
+            return -1;
+        }
+    }
+    for (GU8 uchRangeCnt = 0; uchRangeCnt < sizeof(g_stGh3x2xRegShadowRangeArr) / sizeof(g_stGh3x2xRegShadowRangeArr[0]); uchRangeCnt++)
+    {
+        const STGh3x2xRegShadowRange *pstRange = &g_stGh3x2xRegShadowRangeArr[uchRangeCnt];
+        if ((usRegAddr >= pstRange->usStartAddr) && (usRegAddr <= pstRange->usEndAddr))
+        {
+            return sIndexBase + (GS16)((usRegAddr - pstRange->usStartAddr) / 2);
+        }
+        sIndexBase += (GS16)((pstRange->usEndAddr - pstRange->usStartAddr) / 2 + 1);
+    }
+    return -1;
+}
+
+/**
+ * @fn     void Gh3x2xRegShadowInvalidate(void)
+ * 
+ * @brief  drop all shadow value, next read of every reg goes to chip
+ *
+ * @attention   call it when chip regs are reset
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xRegShadowInvalidate(void)
+{
+    memset(g_puchGh3x2xRegShadowValid, 0, sizeof(g_puchGh3x2xRegShadowValid));
+    g_stGh3x2xRegShadowStat.unInvalidateCnt++;
+}
+
+/**
+ * @fn     void Gh3x2xRegShadowGetStat(STGh3x2xRegShadowStat *pstStat)
+ * 
+ * @brief  get statistics of reg shadow
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  pstStat     pointer to statistics
+ *
+ * @return  None
+ */
+void Gh3x2xRegShadowGetStat(STGh3x2xRegShadowStat *pstStat)
+{
+    *pstStat = g_stGh3x2xRegShadowStat;
+}
+
+/**
+ * @fn     void Gh3x2xRegShadowStatLog(const GCHAR *pchTag, const STGh3x2xRegShadowStat *pstStartStat)
+ * 
+ * @brief  log statistics of reg shadow since pstStartStat
+ *
+ * @attention   every hit saves a addr write and a F1 read on spi bus
+ *
+ * @param[in]   pchTag          log tag
+ * @param[in]   pstStartStat    statistics got before operation
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xRegShadowStatLog(const GCHAR *pchTag, const STGh3x2xRegShadowStat *pstStartStat)
+{
+    GU32 unHitCnt = g_stGh3x2xRegShadowStat.unHitCnt - pstStartStat->unHitCnt;
+
+    EXAMPLE_LOG("[RegShadow]%s: hit = %u(saved %u spi xfer), miss = %u, bypass = %u\r\n", pchTag,
+                (unsigned int)unHitCnt, (unsigned int)(unHitCnt * 2),
+                (unsigned int)(g_stGh3x2xRegShadowStat.unMissCnt - pstStartStat->unMissCnt),
+                (unsigned int)(g_stGh3x2xRegShadowStat.unBypassCnt - pstStartStat->unBypassCnt));
+}
+
+/**
+ * @fn     static void Gh3x2xRegShadowUpdate(GU16 usRegAddr, const GU8 puchBigEndianVal[], GU16 usRegNum)
+ * 
+ * @brief  update shadow with value written to or read from chip
+ *
+ * @attention   None
+ *
+ * @param[in]   usRegAddr           first reg addr
+ * @param[in]   puchBigEndianVal    reg value on spi bus
+ * @param[in]   usRegNum            reg num
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xRegShadowUpdate(GU16 usRegAddr, const GU8 puchBigEndianVal[], GU16 usRegNum)
+{
+    for (GU16 usRegCnt = 0; usRegCnt < usRegNum; usRegCnt++)
+    {
+        GS16 sIndex = Gh3x2xRegShadowGetIndex(usRegAddr + usRegCnt * 2);
+        if (sIndex >= 0)
+        {
+            g_pusGh3x2xRegShadowVal[sIndex] = ((GU16)puchBigEndianVal[usRegCnt * 2] << 8) | puchBigEndianVal[usRegCnt * 2 + 1];
+            g_puchGh3x2xRegShadowValid[sIndex >> 3] |= (GU8)(1 << (sIndex & 0x07));
+        }
+    }
+}
+
+/**
+ * @fn     static GU8 Gh3x2xRegShadowRead(GU16 usRegAddr, GU8 puchBigEndianVal[], GU16 usRegNum)
+ * 
+ * @brief  read regs from shadow
+ *
+ * @attention   None
+ *
+ * @param[in]   usRegAddr           first reg addr
+ * @param[in]   usRegNum            reg num
+ * @param[out]  puchBigEndianVal    reg value as spi bus order
+ *
+ * @return  1: all regs hit  0: miss
+ */
+static GU8 Gh3x2xRegShadowRead(GU16 usRegAddr, GU8 puchBigEndianVal[], GU16 usRegNum)
+{
+    for (GU16 usRegCnt = 0; usRegCnt < usRegNum; usRegCnt++)
+    {
+        GS16 sIndex = Gh3x2xRegShadowGetIndex(usRegAddr + usRegCnt * 2);
+        if ((sIndex < 0) || (0 == (g_puchGh3x2xRegShadowValid[sIndex >> 3] & (1 << (sIndex & 0x07)))))
+        {
+            return 0;
+        }
+    }
+    for (GU16 usRegCnt = 0; usRegCnt < usRegNum; usRegCnt++)
+    {
+        GU16 usVal = g_pusGh3x2xRegShadowVal[Gh3x2xRegShadowGetIndex(usRegAddr + usRegCnt * 2)];
+        puchBigEndianVal[usRegCnt * 2] = (GU8)(usVal >> 8);
+        puchBigEndianVal[usRegCnt * 2 + 1] = (GU8)usVal;
+    }
+    return 1;
+}
+
+/**
+ * @fn     static GU8 Gh3x2xRegShadowFlushAddrFrame(void)
+ * 
+ * @brief  send held addr frame to chip
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+static GU8 Gh3x2xRegShadowFlushAddrFrame(void)
+{
+    if (0 == g_uchGh3x2xRegShadowAddrFrameHeld)
+    {
+        return 1;
+    }
+    const struct spi_buf stTxBuf = {.buf = g_puchGh3x2xRegShadowAddrFrame, .len = GH3X2X_SPI_REG_ADDR_FRAME_LEN};
+    const struct spi_buf_set stTxSet = {.buffers = &stTxBuf, .count = 1};
+
+    g_uchGh3x2xRegShadowAddrFrameHeld = 0;
+    return Gh3x2xSpiTransceive(&stTxSet, NULL);
+}
+
+#endif
+
+#if ( __GH3X2X_INTERFACE__ == __GH3X2X_INTERFACE_I2C__ )
+
+#define GH3X2X_I2C_ADDR(device_id)          ((device_id) >> 1)  /**< drv lib gives 8bits addr, zephyr uses 7bits */
+#define GH3X2X_I2C_REG_ADDR_LEN             (2)                 /**< reg addr is 2 bytes, big endian */
+
+/// i2c bus of gh3x2x node in devicetree, slave addr is given by drv lib(master/slaver of cascade differ)
+static const struct device *const g_pstGh3x2xI2cBus = DEVICE_DT_GET(DT_BUS(GH3X2X_DT_NODE));
+
+#if (__GH3X2X_CASCADE_CONCURRENT_READ_EN__)
+
+#define GH3X2X_SLAVER_DT_NODE               DT_NODELABEL(gh3x2x_slaver)     /**< cascade slaver chip node in devicetree */
+#define GH3X2X_CASCADE_CHIP_MASTER          (0)
+#define GH3X2X_CASCADE_CHIP_SLAVER          (1)
+#define GH3X2X_CASCADE_CHIP_NUM             (2)
+#define GH3X2X_CASCADE_FIFO_ADDR            (0xAAAA)    /**< fifo data addr */
+#define GH3X2X_CASCADE_FIFO_CNT_ADDR        (0x050A)    /**< fifo count reg, counts 4 bytes words */
+#define GH3X2X_CASCADE_FIFO_WORD_BYTES      (4)
+#define GH3X2X_CASCADE_READ_TIMEOUT_MS      (100)       /**< max time of slaver read */
+#define GH3X2X_CASCADE_SLAVER_THREAD_STACK_SIZE (1024)
+#define GH3X2X_CASCADE_SLAVER_THREAD_PRIORITY   (K_PRIO_COOP(2))
+
+BUILD_ASSERT(DT_SAME_NODE(DT_BUS(GH3X2X_DT_NODE), DT_BUS(GH3X2X_SLAVER_DT_NODE)) == 0,
+             "gh3x2x_slaver must be on another i2c bus for concurrent cascade read");
+
+/// i2c bus of cascade slaver chip
+static const struct device *const g_pstGh3x2xI2cSlaverBus = DEVICE_DT_GET(DT_BUS(GH3X2X_SLAVER_DT_NODE));
+
+/// 8bits device addr of master and slaver, taken from drv lib transfers
+static GU8 g_puchGh3x2xCascadeDeviceId[GH3X2X_CASCADE_CHIP_NUM] = {0};
+
+/// slaver read done by slaver thread while master read runs in caller
+typedef struct
+{
+    GU16 usRegAddr;
+    GU16 usLen;
+    GU32 unReqSeq;          /**< seq of last read posted by caller */
+    GU32 unDoneSeq;         /**< seq of last read done by slaver thread, differs from unReqSeq while it runs */
+    int nResult;
+} STGh3x2xCascadeSlaverRead;
+
+static STGh3x2xCascadeSlaverRead g_stGh3x2xCascadeSlaverRead;
+
+/// slaver read data, module owned so a read that outlives a timed out caller never writes caller memory
+static GU8 g_puchGh3x2xCascadeSlaverReadBuffer[__GH3X2X_RAWDATA_SLAVE_BUFFER_SIZE__];
+static K_SEM_DEFINE(g_stGh3x2xCascadeSlaverReadStartSem, 0, 1);
+static K_SEM_DEFINE(g_stGh3x2xCascadeSlaverReadDoneSem, 0, 1);
+
+/// fifo data of both chips read at the same time, served to drv lib fifo read from ram
+static GU8 g_puchGh3x2xCascadeFifoBuffer[GH3X2X_CASCADE_CHIP_NUM][__GH3X2X_RAWDATA_SLAVE_BUFFER_SIZE__];
+static GU16 g_pusGh3x2xCascadeFifoOffset[GH3X2X_CASCADE_CHIP_NUM] = {0};
+static GU16 g_pusGh3x2xCascadeFifoLen[GH3X2X_CASCADE_CHIP_NUM] = {0};
+
+/**
+ * @fn     static GU8 Gh3x2xCascadeChipGet(GU8 device_id)
+ * 
+ * @brief  get cascade chip of device addr, and remember the addr for concurrent read
+ *
+ * @attention   drv lib puts ID pin select in bit 1~2 of 8bits device addr
+ *
+ * @param[in]   device_id       8bits device addr
+ * @param[out]  None
+ *
+ * @return  GH3X2X_CASCADE_CHIP_MASTER or GH3X2X_CASCADE_CHIP_SLAVER
+ */
+static GU8 Gh3x2xCascadeChipGet(GU8 device_id)
+{
+    GU8 uchChip = (((device_id >> 1) & 0x03) == __GH3X2X_I2C_DEVICE_SLAVER_ID__) ?
+                  GH3X2X_CASCADE_CHIP_SLAVER : GH3X2X_CASCADE_CHIP_MASTER;
+
+    g_puchGh3x2xCascadeDeviceId[uchChip] = device_id;
+    return uchChip;
+}
+
+#define GH3X2X_I2C_BUS(device_id)           ((GH3X2X_CASCADE_CHIP_SLAVER == Gh3x2xCascadeChipGet(device_id)) ? \
+                                             g_pstGh3x2xI2cSlaverBus : g_pstGh3x2xI2cBus)
+
+#else
+
+#define GH3X2X_I2C_BUS(device_id)           (g_pstGh3x2xI2cBus)
+
+#endif
+
+#if (__GH3X2X_BUS_STAT_EN__)
+/**
+ * @fn     static void Gh3x2xI2cBusStatRecord(const GU8 puchAddr[], GU16 usAddrLen, GU16 usByteNum, GU32 unCycle)
+ * 
+ * @brief  count one i2c transfer to reg addr in its first 2 bytes
+ *
+ * @attention   transfer shorter than reg addr is counted as cmd of its first byte, buffer is not read past usAddrLen
+ *
+ * @param[in]   puchAddr    reg addr, big endian
+ * @param[in]   usAddrLen   valid bytes in puchAddr
+ * @param[in]   usByteNum   bytes on bus, device addr byte not counted
+ * @param[in]   unCycle     cpu cycles of transfer
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xI2cBusStatRecord(const GU8 puchAddr[], GU16 usAddrLen, GU16 usByteNum, GU32 unCycle)
+{
+    if (usAddrLen >= GH3X2X_I2C_REG_ADDR_LEN)
+    {
+        Gh3x2xBusStatRecord(Gh3x2xBusStatPhaseGet(), ((GU16)puchAddr[0] << 8) | puchAddr[1], 0, usByteNum, unCycle);
+    }
+    else
+    {
+        Gh3x2xBusStatRecord(Gh3x2xBusStatPhaseGet(), (usAddrLen > 0) ? puchAddr[0] : 0, 1, usByteNum, unCycle);
+    }
+}
+#endif
+
+#if (__GH3X2X_CASCADE_CONCURRENT_READ_EN__)
+/**
+ * @fn     static int Gh3x2xCascadeRawRead(GU8 uchChip, GU16 usRegAddr, GU8 *puchBuffer, GU16 usLen)
+ * 
+ * @brief  addr write + repeated start read on bus of cascade chip, not through fifo buffer
+ *
+ * @attention   None
+ *
+ * @param[in]   uchChip     GH3X2X_CASCADE_CHIP_MASTER or GH3X2X_CASCADE_CHIP_SLAVER
+ * @param[in]   usRegAddr   reg addr or fifo addr
+ * @param[in]   usLen       read len
+ * @param[out]  puchBuffer  read data
+ *
+ * @return  result of i2c_transfer, 0 is ok
+ */
+static int Gh3x2xCascadeRawRead(GU8 uchChip, GU16 usRegAddr, GU8 *puchBuffer, GU16 usLen)
+{
+    GU8 puchAddr[GH3X2X_I2C_REG_ADDR_LEN] = {(GU8)(usRegAddr >> 8), (GU8)usRegAddr};
+    struct i2c_msg pstMsg[2] =
+    {
+        {.buf = puchAddr, .len = GH3X2X_I2C_REG_ADDR_LEN, .flags = I2C_MSG_WRITE},
+        {.buf = puchBuffer, .len = usLen, .flags = I2C_MSG_RESTART | I2C_MSG_READ | I2C_MSG_STOP},
+    };
+    const struct device *pstBus = (GH3X2X_CASCADE_CHIP_SLAVER == uchChip) ? g_pstGh3x2xI2cSlaverBus : g_pstGh3x2xI2cBus;
+    int nResult = 0;
+#if (__GH3X2X_BUS_STAT_EN__)
+    GU32 unCycleStart = Gh3x2xCycleCntGet();
+#endif
+
+    nResult = i2c_transfer(pstBus, pstMsg, 2, GH3X2X_I2C_ADDR(g_puchGh3x2xCascadeDeviceId[uchChip]));
+#if (__GH3X2X_BUS_STAT_EN__)
+    Gh3x2xI2cBusStatRecord(puchAddr, GH3X2X_I2C_REG_ADDR_LEN, GH3X2X_I2C_REG_ADDR_LEN + usLen,
+                           Gh3x2xCycleCntGet() - unCycleStart);
+#endif
+    return nResult;
+}
+
+/**
+ * @fn     static void Gh3x2xCascadeSlaverThread(void *p1, void *p2, void *p3)
+ * 
+ * @brief  thread doing slaver read of concurrent read, slaver bus transfer runs while caller waits for master one
+ *
+ * @attention   None
+ *
+ * @param[in]   p1  not used
+ * @param[in]   p2  not used
+ * @param[in]   p3  not used
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xCascadeSlaverThread(void *p1, void *p2, void *p3)
+{
+    while (1)
+    {
+        k_sem_take(&g_stGh3x2xCascadeSlaverReadStartSem, K_FOREVER);
+        g_stGh3x2xCascadeSlaverRead.nResult = Gh3x2xCascadeRawRead(GH3X2X_CASCADE_CHIP_SLAVER,
+                                                                   g_stGh3x2xCascadeSlaverRead.usRegAddr,
+                                                                   g_puchGh3x2xCascadeSlaverReadBuffer,
+                                                                   g_stGh3x2xCascadeSlaverRead.usLen);
+        __atomic_store_n(&g_stGh3x2xCascadeSlaverRead.unDoneSeq, g_stGh3x2xCascadeSlaverRead.unReqSeq, __ATOMIC_RELEASE);
+        k_sem_give(&g_stGh3x2xCascadeSlaverReadDoneSem);
+    }
+}
+
+K_THREAD_DEFINE(g_stGh3x2xCascadeSlaverThread, GH3X2X_CASCADE_SLAVER_THREAD_STACK_SIZE, Gh3x2xCascadeSlaverThread,
+                NULL, NULL, NULL, GH3X2X_CASCADE_SLAVER_THREAD_PRIORITY, 0, 0);
+
+/**
+ * @fn     static GU8 Gh3x2xCascadeConcurrentRead(GU16 usRegAddr, GU8 *puchMasterBuffer, GU8 *puchSlaverBuffer,
+ *                                                GU16 usMasterLen, GU16 usSlaverLen)
+ * 
+ * @brief  read same addr of master and slaver chip at the same time on their own bus
+ *
+ * @attention   both chips must be accessed by drv lib before, their device addr are taken from it. Slaver read of
+ *              a call that timed out may still run, next call fails at once until it is done
+ *
+ * @param[in]   usRegAddr           reg addr or fifo addr
+ * @param[in]   usMasterLen         read len of master, 0: no read
+ * @param[in]   usSlaverLen         read len of slaver, 0: no read
+ * @param[out]  puchMasterBuffer    read data of master
+ * @param[out]  puchSlaverBuffer    read data of slaver
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+static GU8 Gh3x2xCascadeConcurrentRead(GU16 usRegAddr, GU8 *puchMasterBuffer, GU8 *puchSlaverBuffer,
+                                      GU16 usMasterLen, GU16 usSlaverLen)
+{
+    int nMasterResult = 0;
+
+    if (usSlaverLen)
+    {
+        if ((usSlaverLen > sizeof(g_puchGh3x2xCascadeSlaverReadBuffer))
+            || (__atomic_load_n(&g_stGh3x2xCascadeSlaverRead.unDoneSeq, __ATOMIC_ACQUIRE) != g_stGh3x2xCascadeSlaverRead.unReqSeq))
+        {
+            return 0;   //slaver thread is still busy with read of a timed out call
+        }
+        g_stGh3x2xCascadeSlaverRead.usRegAddr = usRegAddr;
+        g_stGh3x2xCascadeSlaverRead.usLen = usSlaverLen;
+        g_stGh3x2xCascadeSlaverRead.unReqSeq++;
+        k_sem_reset(&g_stGh3x2xCascadeSlaverReadDoneSem);
+        k_sem_give(&g_stGh3x2xCascadeSlaverReadStartSem);
+    }
+    if (usMasterLen)
+    {
+        nMasterResult = Gh3x2xCascadeRawRead(GH3X2X_CASCADE_CHIP_MASTER, usRegAddr, puchMasterBuffer, usMasterLen);
+    }
+    if (usSlaverLen)
+    {
+        if (k_sem_take(&g_stGh3x2xCascadeSlaverReadDoneSem, K_MSEC(GH3X2X_CASCADE_READ_TIMEOUT_MS)) != 0)
+        {
+            return 0;
+        }
+        if (g_stGh3x2xCascadeSlaverRead.nResult != 0)
+        {
+            return 0;
+        }
+        memcpy(puchSlaverBuffer, g_puchGh3x2xCascadeSlaverReadBuffer, usSlaverLen);
+    }
+    return (0 == nMasterResult) ? 1 : 0;
+}
+
+/**
+ * @fn     static GU16 Gh3x2xCascadeFifoServe(GU8 uchChip, GU8 *puchBuffer, GU16 usLen)
+ * 
+ * @brief  give fifo data read before to drv lib fifo read
+ *
+ * @attention   None
+ *
+ * @param[in]   uchChip     GH3X2X_CASCADE_CHIP_MASTER or GH3X2X_CASCADE_CHIP_SLAVER
+ * @param[in]   usLen       len drv lib wants
+ * @param[out]  puchBuffer  fifo data
+ *
+ * @return  len served from ram, the rest should be read from chip
+ */
+static GU16 Gh3x2xCascadeFifoServe(GU8 uchChip, GU8 *puchBuffer, GU16 usLen)
+{
+    GU16 usServedLen = g_pusGh3x2xCascadeFifoLen[uchChip] - g_pusGh3x2xCascadeFifoOffset[uchChip];
+
+    if (usServedLen > usLen)
+    {
+        usServedLen = usLen;
+    }
+    memcpy(puchBuffer, &g_puchGh3x2xCascadeFifoBuffer[uchChip][g_pusGh3x2xCascadeFifoOffset[uchChip]], usServedLen);
+    g_pusGh3x2xCascadeFifoOffset[uchChip] += usServedLen;
+    if (g_pusGh3x2xCascadeFifoOffset[uchChip] == g_pusGh3x2xCascadeFifoLen[uchChip])
+    {
+        g_pusGh3x2xCascadeFifoOffset[uchChip] = 0;
+        g_pusGh3x2xCascadeFifoLen[uchChip] = 0;
+    }
+    return usServedLen;
+}
+
+/**
+ * @fn     static void Gh3x2xCascadeFifoCntAdjust(GU8 uchChip, GU8 puchFifoCnt[])
+ * 
+ * @brief  fifo data in ram is not in chip fifo any more, add it to fifo count read from chip
+ *
+ * @attention   None
+ *
+ * @param[in]   uchChip     GH3X2X_CASCADE_CHIP_MASTER or GH3X2X_CASCADE_CHIP_SLAVER
+ * @param[in]   puchFifoCnt fifo count read from chip, big endian
+ * @param[out]  puchFifoCnt fifo count with data in ram
+ *
+ * @return  None
+ */
+static void Gh3x2xCascadeFifoCntAdjust(GU8 uchChip, GU8 puchFifoCnt[])
+{
+    GU16 usFifoCnt = (((GU16)puchFifoCnt[0] << 8) | puchFifoCnt[1])
+                     + (g_pusGh3x2xCascadeFifoLen[uchChip] - g_pusGh3x2xCascadeFifoOffset[uchChip]) / GH3X2X_CASCADE_FIFO_WORD_BYTES;
+
+    puchFifoCnt[0] = (GU8)(usFifoCnt >> 8);
+    puchFifoCnt[1] = (GU8)usFifoCnt;
+}
+
+/**
+ * @fn     static void Gh3x2xCascadeFifoDrop(void)
+ * 
+ * @brief  drop fifo data in ram, chip fifo is cleared by reset
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xCascadeFifoDrop(void)
+{
+    memset(g_pusGh3x2xCascadeFifoOffset, 0, sizeof(g_pusGh3x2xCascadeFifoOffset));
+    memset(g_pusGh3x2xCascadeFifoLen, 0, sizeof(g_pusGh3x2xCascadeFifoLen));
+}
+
+/**
+ * @fn     GU8 Gh3x2xCascadeFifoByteNumRead(GU16 *pusMasterByteNum, GU16 *pusSlaverByteNum)
+ * 
+ * @brief  read fifo count of master and slaver chip at the same time
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  pusMasterByteNum    fifo byte num of master
+ * @param[out]  pusSlaverByteNum    fifo byte num of slaver
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error, byte num is 0
+ */
+GU8 Gh3x2xCascadeFifoByteNumRead(GU16 *pusMasterByteNum, GU16 *pusSlaverByteNum)
+{
+    GU8 puchFifoCnt[GH3X2X_CASCADE_CHIP_NUM][2] = {0};
+
+    *pusMasterByteNum = 0;
+    *pusSlaverByteNum = 0;
+    if (0 == Gh3x2xCascadeConcurrentRead(GH3X2X_CASCADE_FIFO_CNT_ADDR, puchFifoCnt[GH3X2X_CASCADE_CHIP_MASTER],
+                                         puchFifoCnt[GH3X2X_CASCADE_CHIP_SLAVER], 2, 2))
+    {
+        return 0;
+    }
+    Gh3x2xCascadeFifoCntAdjust(GH3X2X_CASCADE_CHIP_MASTER, puchFifoCnt[GH3X2X_CASCADE_CHIP_MASTER]);
+    Gh3x2xCascadeFifoCntAdjust(GH3X2X_CASCADE_CHIP_SLAVER, puchFifoCnt[GH3X2X_CASCADE_CHIP_SLAVER]);
+    *pusMasterByteNum = GH3X2X_CASCADE_FIFO_WORD_BYTES
+                        * (((GU16)puchFifoCnt[GH3X2X_CASCADE_CHIP_MASTER][0] << 8) | puchFifoCnt[GH3X2X_CASCADE_CHIP_MASTER][1]);
+    *pusSlaverByteNum = GH3X2X_CASCADE_FIFO_WORD_BYTES
+                        * (((GU16)puchFifoCnt[GH3X2X_CASCADE_CHIP_SLAVER][0] << 8) | puchFifoCnt[GH3X2X_CASCADE_CHIP_SLAVER][1]);
+    return 1;
+}
+
+/**
+ * @fn     GU8 Gh3x2xCascadeFifoPrefetch(GU16 usByteNum)
+ * 
+ * @brief  drain usByteNum of both chip fifos at the same time, GH3X2X_CascadeReadFifodata gets them from ram
+ *
+ * @attention   usByteNum must not be more than fifo byte num of both chips
+ *
+ * @param[in]   usByteNum   fifo byte num to read from each chip
+ * @param[out]  None
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error, drv lib will read fifo from chip
+ */
+GU8 Gh3x2xCascadeFifoPrefetch(GU16 usByteNum)
+{
+    GU16 pusReadLen[GH3X2X_CASCADE_CHIP_NUM] = {0};
+
+    for (GU8 uchChip = 0; uchChip < GH3X2X_CASCADE_CHIP_NUM; uchChip++)
+    {
+        GU16 usRemainLen = g_pusGh3x2xCascadeFifoLen[uchChip] - g_pusGh3x2xCascadeFifoOffset[uchChip];
+
+        /* data left in ram comes first, new data follows it */
+        memmove(g_puchGh3x2xCascadeFifoBuffer[uchChip],
+                &g_puchGh3x2xCascadeFifoBuffer[uchChip][g_pusGh3x2xCascadeFifoOffset[uchChip]], usRemainLen);
+        g_pusGh3x2xCascadeFifoOffset[uchChip] = 0;
+        g_pusGh3x2xCascadeFifoLen[uchChip] = usRemainLen;
+        if (usByteNum > usRemainLen)
+        {
+            pusReadLen[uchChip] = usByteNum - usRemainLen;
+        }
+        if (pusReadLen[uchChip] > (__GH3X2X_RAWDATA_SLAVE_BUFFER_SIZE__ - usRemainLen))
+        {
+            pusReadLen[uchChip] = __GH3X2X_RAWDATA_SLAVE_BUFFER_SIZE__ - usRemainLen;
+        }
+        pusReadLen[uchChip] -= pusReadLen[uchChip] % GH3X2X_CASCADE_FIFO_WORD_BYTES;
+    }
+    if (0 == Gh3x2xCascadeConcurrentRead(GH3X2X_CASCADE_FIFO_ADDR,
+            &g_puchGh3x2xCascadeFifoBuffer[GH3X2X_CASCADE_CHIP_MASTER][g_pusGh3x2xCascadeFifoLen[GH3X2X_CASCADE_CHIP_MASTER]],
+            &g_puchGh3x2xCascadeFifoBuffer[GH3X2X_CASCADE_CHIP_SLAVER][g_pusGh3x2xCascadeFifoLen[GH3X2X_CASCADE_CHIP_SLAVER]],
+            pusReadLen[GH3X2X_CASCADE_CHIP_MASTER], pusReadLen[GH3X2X_CASCADE_CHIP_SLAVER]))
+    {
+        /* chip fifo state is unknown now, drv lib reads from chip and checks data itself */
+        Gh3x2xCascadeFifoDrop();
+        return 0;
+    }
+    g_pusGh3x2xCascadeFifoLen[GH3X2X_CASCADE_CHIP_MASTER] += pusReadLen[GH3X2X_CASCADE_CHIP_MASTER];
+    g_pusGh3x2xCascadeFifoLen[GH3X2X_CASCADE_CHIP_SLAVER] += pusReadLen[GH3X2X_CASCADE_CHIP_SLAVER];
+    return 1;
+}
+#endif
+
+/* i2c interface */
+/**
+ * @fn     void hal_gh3x2x_i2c_init(void)
+ * 
+ * @brief  hal i2c init for gh3x2x
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void hal_gh3x2x_i2c_init(void)
+{
+    /* i2c bus is inited by zephyr device model, only check it is ready */
+    if (!device_is_ready(g_pstGh3x2xI2cBus))
+    {
+        EXAMPLE_LOG("[%s]i2c bus of gh3x2x is not ready!\r\n", __FUNCTION__);
+    }
+#if (__GH3X2X_CASCADE_CONCURRENT_READ_EN__)
+    if (!device_is_ready(g_pstGh3x2xI2cSlaverBus))
+    {
+        EXAMPLE_LOG("[%s]i2c bus of gh3x2x slaver is not ready!\r\n", __FUNCTION__);
+    }
+#endif
+    GOODIX_PLANFROM_I2C_INIT_ENTITY();
+}
+
+/**
+ * @fn     uint8_t hal_gh3x2x_i2c_write(uint8_t device_id, const uint8_t write_buffer[], uint16_t length)
+ * 
+ * @brief  hal i2c write for gh3x2x
+ *
+ * @attention   device_id is 8bits, if platform i2c use 7bits addr, should use (device_id >> 1)
+ *
+ * @param[in]   device_id       device addr
+ * @param[in]   write_buffer    write data buffer
+ * @param[in]   length          write data len
+ * @param[out]  None
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+GU8 hal_gh3x2x_i2c_write(GU8 device_id, const GU8 write_buffer[], GU16 length)
+{
+    uint8_t ret = 1;
+    struct i2c_msg stMsg =
+    {
+        .buf = (GU8 *)write_buffer,
+        .len = length,
+        .flags = I2C_MSG_WRITE | I2C_MSG_STOP,
+    };
+
+#if (__GH3X2X_BUS_STAT_EN__)
+    GU32 unCycleStart = Gh3x2xCycleCntGet();
+#endif
+
+    if (i2c_transfer(GH3X2X_I2C_BUS(device_id), &stMsg, 1, GH3X2X_I2C_ADDR(device_id)) != 0)
+    {
+        ret = 0;
+    }
+#if (__GH3X2X_BUS_STAT_EN__)
+    Gh3x2xI2cBusStatRecord(write_buffer, length, length, Gh3x2xCycleCntGet() - unCycleStart);
+#endif
+
+    GOODIX_PLANFROM_I2C_WRITE_ENTITY(device_id, write_buffer,length);
+    return ret;
+}
+
+/**
+ * @fn     uint8_t hal_gh3x2x_i2c_read(uint8_t device_id, const uint8_t write_buffer[], uint16_t write_length,
+ *                            uint8_t read_buffer[], uint16_t read_length)
+ * 
+ * @brief  hal i2c read for gh3x2x
+ *
+ * @attention   addr write and data read are one transfer with repeated start, fifo read lands in read_buffer by EasyDMA
+ *
+ * @param[in]   device_id       device addr
+ * @param[in]   write_buffer    write data buffer
+ * @param[in]   write_length    write data len
+ * @param[in]   read_length     read data len
+ * @param[out]  read_buffer     pointer to read buffer
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+GU8 hal_gh3x2x_i2c_read(GU8 device_id, const GU8 write_buffer[], GU16 write_length, GU8 read_buffer[], GU16 read_length)
+{
+    uint8_t ret = 1;
+    struct i2c_msg pstMsg[2] =
+    {
+        {.buf = (GU8 *)write_buffer, .len = write_length, .flags = I2C_MSG_WRITE},
+        {.buf = read_buffer, .len = read_length, .flags = I2C_MSG_RESTART | I2C_MSG_READ | I2C_MSG_STOP},
+    };
+#if (__GH3X2X_CASCADE_CONCURRENT_READ_EN__)
+    GU16 usServedLen = 0;
+
+    if (GH3X2X_I2C_REG_ADDR_LEN == write_length)
+    {
+        GU16 usRegAddr = ((GU16)write_buffer[0] << 8) | write_buffer[1];
+
+        if (GH3X2X_CASCADE_FIFO_ADDR == usRegAddr)
+        {
+            usServedLen = Gh3x2xCascadeFifoServe(Gh3x2xCascadeChipGet(device_id), read_buffer, read_length);
+            if (usServedLen == read_length)
+            {
+                GOODIX_PLANFROM_I2C_READ_ENTITY(device_id, write_buffer, write_length, read_buffer, read_length);
+                return ret;
+            }
+            pstMsg[1].buf = &read_buffer[usServedLen];
+            pstMsg[1].len = read_length - usServedLen;
+        }
+    }
+#endif
+
+#if (__GH3X2X_BUS_STAT_EN__)
+    GU32 unCycleStart = Gh3x2xCycleCntGet();
+#endif
+
+    if (i2c_transfer(GH3X2X_I2C_BUS(device_id), pstMsg, 2, GH3X2X_I2C_ADDR(device_id)) != 0)
+    {
+        ret = 0;
+    }
+#if (__GH3X2X_CASCADE_CONCURRENT_READ_EN__)
+    else if ((GH3X2X_I2C_REG_ADDR_LEN == write_length) && (2 == read_length)
+             && (GH3X2X_CASCADE_FIFO_CNT_ADDR == (((GU16)write_buffer[0] << 8) | write_buffer[1])))
+    {
+        Gh3x2xCascadeFifoCntAdjust(Gh3x2xCascadeChipGet(device_id), read_buffer);
+    }
+#endif
+#if (__GH3X2X_BUS_STAT_EN__)
+    Gh3x2xI2cBusStatRecord(write_buffer, write_length, write_length + read_length, Gh3x2xCycleCntGet() - unCycleStart);
+#endif
+
+    GOODIX_PLANFROM_I2C_READ_ENTITY(device_id, write_buffer, write_length, read_buffer, read_length);
+    return ret;
+}
+
+#else // __GH3X2X_INTERFACE__ == __GH3X2X_INTERFACE_SPI__
+
+/* spi interface */
+/**
+ * @fn     void hal_gh3x2x_spi_init(void)
+ * 
+ * @brief  hal spi init for gh3x2x
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+
+void hal_gh3x2x_spi_init(void)
+{
+    /* spi bus and cs pin are inited by zephyr device model, only check it is ready */
+    if (!spi_is_ready_dt(&g_stGh3x2xSpiSpec))
+    {
+        EXAMPLE_LOG("[%s]spi bus of gh3x2x is not ready!\r\n", __FUNCTION__);
+    }
+}
+
+/**
+ * @fn     static GU8 Gh3x2xSpiWriteFrame(GU8 write_buffer[], GU16 length)
+ * 
+ * @brief  send one write frame to gh3x2x, through reg shadow if enabled
+ *
+ * @attention   None
+ *
+ * @param[in]   write_buffer    write data buffer
+ * @param[in]   length          write data len
+ * @param[out]  None
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+static GU8 Gh3x2xSpiWriteFrame(GU8 write_buffer[], GU16 length)
+{
+    GU8 ret = 1;
+    const struct spi_buf stTxBuf = {.buf = write_buffer, .len = length};
+    const struct spi_buf_set stTxSet = {.buffers = &stTxBuf, .count = 1};
+
+#if (__GH3X2X_REG_SHADOW_EN__)
+    if (0 == Gh3x2xRegShadowFlushAddrFrame())
+    {
+        return 0;
+    }
+    g_uchGh3x2xRegShadowAddrFrameValid = 0;
+    if ((GH3X2X_SPI_REG_ADDR_FRAME_LEN == length) && (GH3X2X_SPI_CMD_WRITE == write_buffer[0]))
+    {
+        /* addr of reg read, hold it until F1 read tells how many regs are read */
+        memcpy(g_puchGh3x2xRegShadowAddrFrame, write_buffer, GH3X2X_SPI_REG_ADDR_FRAME_LEN);
+        g_uchGh3x2xRegShadowAddrFrameHeld = 1;
+        g_uchGh3x2xRegShadowAddrFrameValid = 1;
+        return 1;
+    }
+#endif
+
+    ret = Gh3x2xSpiTransceive(&stTxSet, NULL);
+
+#if (__GH3X2X_REG_SHADOW_EN__)
+    if ((0 == ret) || ((1 == length) && (GH3X2X_SPI_CMD_SOFT_RESET == write_buffer[0])))
+    {
+        Gh3x2xRegShadowInvalidate();
+    }
+    else if ((length > GH3X2X_SPI_REG_WRITE_HEADER_LEN) && (GH3X2X_SPI_CMD_WRITE == write_buffer[0]))
+    {
+        Gh3x2xRegShadowUpdate(((GU16)write_buffer[1] << 8) | write_buffer[2], &write_buffer[GH3X2X_SPI_REG_WRITE_HEADER_LEN],
+                              (length - GH3X2X_SPI_REG_WRITE_HEADER_LEN) / 2);
+    }
+#endif
+
+    return ret;
+}
+
+#if (__GH3X2X_REG_BURST_WRITE_EN__)
+
+#define GH3X2X_REG_BURST_MAX_REG_NUM        (64)        /**< max reg num of one burst write */
+
+/// coalesced write frame: F0 + first addr + byte len + data of contiguous regs
+static GU8 g_puchGh3x2xRegBurstFrame[GH3X2X_SPI_REG_WRITE_HEADER_LEN + GH3X2X_REG_BURST_MAX_REG_NUM * 2];
+
+/// reg num in g_puchGh3x2xRegBurstFrame
+static GU16 g_usGh3x2xRegBurstRegNum = 0;
+
+/// coalescing is only done between Gh3x2xRegBurstWriteStart and Gh3x2xRegBurstWriteStop
+static GU8 g_uchGh3x2xRegBurstEnable = 0;
+
+/// statistics of current burst session
+static GU32 g_unGh3x2xRegBurstRegCnt = 0;
+static GU32 g_unGh3x2xRegBurstFrameCnt = 0;
+static GU32 g_unGh3x2xRegBurstStartCycle = 0;
+
+/**
+ * @fn     static GU8 Gh3x2xRegBurstFlush(void)
+ * 
+ * @brief  send coalesced regs as one burst write frame
+ *
+ * @attention   held regs are kept if it fails, so next transfer retries them first and write order is kept
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+static GU8 Gh3x2xRegBurstFlush(void)
+{
+    GU8 ret = 1;
+    GU16 usByteLen = g_usGh3x2xRegBurstRegNum * 2;
+
+    if (0 == g_usGh3x2xRegBurstRegNum)
+    {
+        return 1;
+    }
+    g_puchGh3x2xRegBurstFrame[3] = (GU8)(usByteLen >> 8);
+    g_puchGh3x2xRegBurstFrame[4] = (GU8)usByteLen;
+    ret = Gh3x2xSpiWriteFrame(g_puchGh3x2xRegBurstFrame, GH3X2X_SPI_REG_WRITE_HEADER_LEN + usByteLen);
+    if (ret)
+    {
+        g_usGh3x2xRegBurstRegNum = 0;
+        g_unGh3x2xRegBurstFrameCnt++;
+    }
+    return ret;
+}
+
+/**
+ * @fn     static GU8 Gh3x2xRegBurstCoalesce(const GU8 write_buffer[], GU16 length)
+ * 
+ * @brief  try to hold single reg write frame and merge it with contiguous regs
+ *
+ * @attention   frame is not held if it does not follow held regs or burst is full, caller flushes and tries again
+ *
+ * @param[in]   write_buffer    write data buffer
+ * @param[in]   length          write data len
+ * @param[out]  None
+ *
+ * @return  1: frame is held  0: frame should be sent now
+ */
+static GU8 Gh3x2xRegBurstCoalesce(const GU8 write_buffer[], GU16 length)
+{
+    GU16 usRegAddr;
+    GU16 usNextAddr;
+
+    if ((0 == g_uchGh3x2xRegBurstEnable) || (GH3X2X_SPI_CMD_WRITE != write_buffer[0]) ||
+        ((GH3X2X_SPI_REG_WRITE_HEADER_LEN + 2) != length))
+    {
+        return 0;
+    }
+    usRegAddr = ((GU16)write_buffer[1] << 8) | write_buffer[2];
+    usNextAddr = (((GU16)g_puchGh3x2xRegBurstFrame[1] << 8) | g_puchGh3x2xRegBurstFrame[2]) + g_usGh3x2xRegBurstRegNum * 2;
+    if ((g_usGh3x2xRegBurstRegNum != 0) &&
+        ((usRegAddr != usNextAddr) || (GH3X2X_REG_BURST_MAX_REG_NUM == g_usGh3x2xRegBurstRegNum)))
+    {
+        return 0;
+    }
+    if (0 == g_usGh3x2xRegBurstRegNum)
+    {
+        memcpy(g_puchGh3x2xRegBurstFrame, write_buffer, GH3X2X_SPI_REG_WRITE_HEADER_LEN);
+    }
+    g_puchGh3x2xRegBurstFrame[GH3X2X_SPI_REG_WRITE_HEADER_LEN + g_usGh3x2xRegBurstRegNum * 2] = write_buffer[5];
+    g_puchGh3x2xRegBurstFrame[GH3X2X_SPI_REG_WRITE_HEADER_LEN + g_usGh3x2xRegBurstRegNum * 2 + 1] = write_buffer[6];
+    g_usGh3x2xRegBurstRegNum++;
+    g_unGh3x2xRegBurstRegCnt++;
+    return 1;
+}
+
+/**
+ * @fn     void Gh3x2xRegBurstWriteStart(void)
+ * 
+ * @brief  start coalescing contiguous reg writes into burst writes
+ *
+ * @attention   every other spi transfer or bsp delay sends held regs first, so write order is kept
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xRegBurstWriteStart(void)
+{
+    g_usGh3x2xRegBurstRegNum = 0;
+    g_unGh3x2xRegBurstRegCnt = 0;
+    g_unGh3x2xRegBurstFrameCnt = 0;
+    g_unGh3x2xRegBurstStartCycle = k_cycle_get_32();
+    g_uchGh3x2xRegBurstEnable = 1;
+}
+
+/**
+ * @fn     void Gh3x2xRegBurstWriteStop(const GCHAR *pchTag)
+ * 
+ * @brief  send held regs, stop coalescing and log reg num, frame num and time used
+ *
+ * @attention   None
+ *
+ * @param[in]   pchTag      log tag
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xRegBurstWriteStop(const GCHAR *pchTag)
+{
+    if (0 == Gh3x2xRegBurstFlush())
+    {
+        EXAMPLE_LOG("[RegBurst]%s: flush error, %u regs held for next transfer\r\n", pchTag,
+                    (unsigned int)g_usGh3x2xRegBurstRegNum);
+    }
+    g_uchGh3x2xRegBurstEnable = 0;
+    EXAMPLE_LOG("[RegBurst]%s: %u reg writes in %u bursts, %u us\r\n", pchTag,
+                (unsigned int)g_unGh3x2xRegBurstRegCnt, (unsigned int)g_unGh3x2xRegBurstFrameCnt,
+                (unsigned int)k_cyc_to_us_floor32(k_cycle_get_32() - g_unGh3x2xRegBurstStartCycle));
+}
+
+#endif
+
+/**
+ * @fn     GU8 hal_gh3x2x_spi_write(GU8 write_buffer[], GU16 length)
+ * 
+ * @brief  hal spi write for gh3x2x
+ *
+ * @attention   if __GH3X2X_SPI_TYPE__ == __GH3X2X_SPI_TYPE_SOFTWARE_CS__  , user need generate timming: write_buf[0](W) + write_buf[1](W) + ...
+ * @attention   if __GH3X2X_SPI_TYPE__ == __GH3X2X_SPI_TYPE_HARDWARE_CS__  , user need generate timming: CS LOW  + write_buf[0](W) + write_buf[1](W) + ... + CS HIGH
+ *
+ * @param[in]   write_buffer    write data buffer
+ * @param[in]   length          write data len
+ * @param[out]  None
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+GU8 hal_gh3x2x_spi_write(GU8 write_buffer[], GU16 length)
+{
+    GU8 ret = 1;
+
+    GH3X2X_SPI_BUS_LOCK();
+#if (__GH3X2X_INT_FIFO_PREFETCH_EN__)
+    Gh3x2xSpiBusTrackWrite(write_buffer, length);
+    if ((1 == length) && (GH3X2X_SPI_CMD_SOFT_RESET == write_buffer[0]))
+    {
+        Gh3x2xFifoPrefetchDrop();
+    }
+#endif
+#if (__GH3X2X_REG_BURST_WRITE_EN__)
+    if (0 == Gh3x2xRegBurstCoalesce(write_buffer, length))
+    {
+        /* held regs go first, flush error is error of this write and frame is neither held nor sent */
+        ret = Gh3x2xRegBurstFlush();
+        if (ret && (0 == Gh3x2xRegBurstCoalesce(write_buffer, length)))
+        {
+            ret = Gh3x2xSpiWriteFrame(write_buffer, length);
+        }
+    }
+#else
+    ret = Gh3x2xSpiWriteFrame(write_buffer, length);
+#endif
+    GH3X2X_SPI_BUS_UNLOCK();
+
+    return ret;
+}
+
+
+#if (__GH3X2X_SPI_TYPE__ == __GH3X2X_SPI_TYPE_SOFTWARE_CS__) 
+/**
+ * @fn     GU8 hal_gh3x2x_spi_read(GU8 read_buffer[], GU16 length)
+ * 
+ * @brief  hal spi read for gh3x2x
+ *
+ * @attention   user need generate timming: read_buf[0](R) + write_buf[1](R) + ... 
+ *
+ * @param[in]   read_length     read data len
+ * @param[out]  read_buffer     pointer to read buffer
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+GU8 hal_gh3x2x_spi_read(GU8 read_buffer[], GU16 length)
+{
+    GU8 ret = 1;
+
+    GOODIX_PLANFROM_SPI_READ_ENTITY();
+
+    return ret;
+}
+#elif (__GH3X2X_SPI_TYPE__ == __GH3X2X_SPI_TYPE_HARDWARE_CS__)
+/**
+ * @fn     static GU8 Gh3x2xSpiWriteF1AndRead(GU8 read_buffer[], GU16 length)
+ * 
+ * @brief  F1 read on bus, through reg shadow if enabled
+ *
+ * @attention   None
+ *
+ * @param[in]   length          read data len
+ * @param[out]  read_buffer     pointer to read buffer
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+static GU8 Gh3x2xSpiWriteF1AndRead(GU8 read_buffer[], GU16 length)
+{
+    GU8 ret = 1;
+    GU8 reg = 0xF1;
+    const struct spi_buf stTxBuf = {.buf = &reg, .len = 1};
+    const struct spi_buf_set stTxSet = {.buffers = &stTxBuf, .count = 1};
+    /* first rx byte is clocked out while F1 is sent, drop it and let EasyDMA land payload in read_buffer */
+    const struct spi_buf pstRxBuf[2] =
+    {
+        {.buf = NULL, .len = 1},
+        {.buf = read_buffer, .len = length},
+    };
+    const struct spi_buf_set stRxSet = {.buffers = pstRxBuf, .count = 2};
+#if (__GH3X2X_REG_BURST_WRITE_EN__)
+    if (0 == Gh3x2xRegBurstFlush())
+    {
+        return 0;
+    }
+#endif
+#if (__GH3X2X_REG_SHADOW_EN__)
+    GU16 usRegAddr = ((GU16)g_puchGh3x2xRegShadowAddrFrame[1] << 8) | g_puchGh3x2xRegShadowAddrFrame[2];
+    GU8 uchRegRead = (g_uchGh3x2xRegShadowAddrFrameValid && (GH3X2X_SPI_FIFO_ADDR != usRegAddr) && (0 == (length & 0x0001)));
+
+    g_uchGh3x2xRegShadowAddrFrameValid = 0;
+    if (uchRegRead)
+    {
+        if (Gh3x2xRegShadowGetIndex(usRegAddr) < 0)
+        {
+            g_stGh3x2xRegShadowStat.unBypassCnt++;
+        }
+        else if (Gh3x2xRegShadowRead(usRegAddr, read_buffer, length / 2))
+        {
+            g_uchGh3x2xRegShadowAddrFrameHeld = 0;
+            g_stGh3x2xRegShadowStat.unHitCnt++;
+            return 1;
+        }
+        else
+        {
+            g_stGh3x2xRegShadowStat.unMissCnt++;
+        }
+    }
+    if (0 == Gh3x2xRegShadowFlushAddrFrame())
+    {
+        return 0;
+    }
+#endif
+
+    ret = Gh3x2xSpiTransceive(&stTxSet, &stRxSet);
+#if (__GH3X2X_REG_SHADOW_EN__)
+    if (ret && uchRegRead)
+    {
+        Gh3x2xRegShadowUpdate(usRegAddr, read_buffer, length / 2);
+    }
+#endif
+    
+    return ret;
+}
+
+/**
+ * @fn     GU8 hal_gh3x2x_spi_write_F1_and_read(GU8 read_buffer[], GU16 length)
+ * 
+ * @brief  hal spi write F1 and read for gh3x2x
+ *
+ * @attention    user need generate timming: CS LOW + F1(W) + read_buf[0](R) + read_buf[1](R) + ... + CS HIGH
+ *
+ * @param[in]   write_buf     write data
+ * @param[in]   length     write data len
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+GU8 hal_gh3x2x_spi_write_F1_and_read(GU8 read_buffer[], GU16 length)
+{
+    GU8 ret = 1;
+
+    GH3X2X_SPI_BUS_LOCK();
+#if (__GH3X2X_INT_FIFO_PREFETCH_EN__)
+    GU16 usServeLen = 0;
+
+    if (g_uchGh3x2xSpiReadAddrValid && (GH3X2X_SPI_FIFO_ADDR == g_usGh3x2xSpiReadAddr) && g_usGh3x2xFifoPrefetchLen)
+    {
+        usServeLen = Gh3x2xFifoPrefetchServe(read_buffer, length);
+#if (__GH3X2X_REG_SHADOW_EN__)
+        if (usServeLen == length)
+        {
+            /* all served from ram, held fifo addr frame is never sent */
+            g_uchGh3x2xRegShadowAddrFrameHeld = 0;
+            g_uchGh3x2xRegShadowAddrFrameValid = 0;
+        }
+#endif
+    }
+    if (usServeLen < length)
+    {
+        ret = Gh3x2xSpiWriteF1AndRead(&read_buffer[usServeLen], length - usServeLen);
+    }
+    if (ret && g_uchGh3x2xSpiReadAddrValid && (GH3X2X_INT_FIFO_UR_REG_ADDR == g_usGh3x2xSpiReadAddr) && (length >= 2))
+    {
+        Gh3x2xFifoPrefetchAdjustCnt(read_buffer);
+    }
+    Gh3x2xSpiBusReleasePair();
+#else
+    ret = Gh3x2xSpiWriteF1AndRead(read_buffer, length);
+#endif
+    GH3X2X_SPI_BUS_UNLOCK();
+
+    return ret;
+}
+#endif
+
+/**
+ * @fn     void hal_gh3x2x_spi_cs_ctrl(GU8 cs_pin_level)
+ * 
+ * @brief  hal spi cs pin ctrl for gh3x2x
+ *
+ * @attention   pin level set 1 [high level] or 0 [low level]
+ *
+ * @param[in]   cs_pin_level     spi cs pin level
+ * @param[out]  None
+ *
+ * @return  None
+ */
+#if (__GH3X2X_SPI_TYPE__ == __GH3X2X_SPI_TYPE_SOFTWARE_CS__) 
+void hal_gh3x2x_spi_cs_ctrl(GU8 cs_pin_level)
+{
+
+    GOODIX_PLANFROM_SPI_CS_CTRL_ENTITY();
+
+}
+#endif
+
+#endif
+
+#if (__GH3X2X_SPI_BENCHMARK_EN__)
+
+#define GH3X2X_SPI_BENCHMARK_LOOP_NUM   (100)       /**< fifo read times of every benchmark case */
+
+/**
+ * @fn     static GU8 Gh3x2xSpiBenchmarkCopyRead(GU8 read_buffer[], GU16 length)
+ * 
+ * @brief  F1 read as the old way: read to stack buffer then copy, only used as benchmark baseline
+ *
+ * @attention   None
+ *
+ * @param[in]   length          read data len
+ * @param[out]  read_buffer     pointer to read buffer
+ *
+ * @return  status
+ * @retval  #1      return successfully
+ * @retval  #0      return error
+ */
+static GU8 Gh3x2xSpiBenchmarkCopyRead(GU8 read_buffer[], GU16 length)
+{
+    GU8 ret = 1;
+    GU8 reg = 0xF1;
+    GU8 uchRxBuf[length + 1];
+    const struct spi_buf stTxBuf = {.buf = &reg, .len = 1};
+    const struct spi_buf_set stTxSet = {.buffers = &stTxBuf, .count = 1};
+    const struct spi_buf stRxBuf = {.buf = uchRxBuf, .len = length + 1};
+    const struct spi_buf_set stRxSet = {.buffers = &stRxBuf, .count = 1};
+
+    ret = Gh3x2xSpiTransceive(&stTxSet, &stRxSet);
+    if (ret)
+    {
+        memcpy(read_buffer, &uchRxBuf[1], length);
+    }
+    return ret;
+}
+
+/// args of one fifo read benchmark case
+typedef struct
+{
+    GU8 (*pReadFunc)(GU8 read_buffer[], GU16 length);
+    GU8 *puchBuffer;
+    GU16 usLength;
+} STGh3x2xSpiBenchmarkArg;
+
+/**
+ * @fn     static void Gh3x2xSpiBenchmarkCase(void *pvArg)
+ * 
+ * @brief  one fifo read of benchmark case
+ *
+ * @attention   None
+ *
+ * @param[in]   pvArg           pointer to STGh3x2xSpiBenchmarkArg
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xSpiBenchmarkCase(void *pvArg)
+{
+    const STGh3x2xSpiBenchmarkArg *pstArg = (const STGh3x2xSpiBenchmarkArg *)pvArg;
+
+    pstArg->pReadFunc(pstArg->puchBuffer, pstArg->usLength);
+}
+
+/**
+ * @fn     void Gh3x2xSpiFifoReadBenchmark(void)
+ * 
+ * @brief  benchmark of F1 fifo read, zero-copy scatter read vs stack buffer + memcpy read
+ *
+ * @attention   chip should be inited, result is printed by EXAMPLE_LOG, run by shell cmd gh3x2x_bench spi;
+ *              zero-copy runs first as it uses less stack
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xSpiFifoReadBenchmark(void)
+{
+    static GU8 puchBenchBuffer[__GH3X2X_RAWDATA_BUFFER_SIZE__];
+    STGh3x2xSpiBenchmarkArg stArg = {hal_gh3x2x_spi_write_F1_and_read, puchBenchBuffer, __GH3X2X_RAWDATA_BUFFER_SIZE__};
+
+    GU32 unZeroCopyUs;
+    GU32 unStackCopyUs;
+
+    unZeroCopyUs = Gh3x2xCycleToUs(Gh3x2xBenchmarkRun("spi fifo read zero-copy", Gh3x2xSpiBenchmarkCase, &stArg,
+                                                      GH3X2X_SPI_BENCHMARK_LOOP_NUM, __GH3X2X_RAWDATA_BUFFER_SIZE__, "byte"));
+    stArg.pReadFunc = Gh3x2xSpiBenchmarkCopyRead;
+    unStackCopyUs = Gh3x2xCycleToUs(Gh3x2xBenchmarkRun("spi fifo read stack+copy", Gh3x2xSpiBenchmarkCase, &stArg,
+                                                       GH3X2X_SPI_BENCHMARK_LOOP_NUM, __GH3X2X_RAWDATA_BUFFER_SIZE__, "byte"));
+    EXAMPLE_LOG("[Bench]spi fifo read %u bytes: zero-copy %u.%02u bytes/us, stack+copy %u.%02u bytes/us\r\n",
+                (unsigned int)__GH3X2X_RAWDATA_BUFFER_SIZE__,
+                (unsigned int)(__GH3X2X_RAWDATA_BUFFER_SIZE__ / MAX(unZeroCopyUs, 1)),
+                (unsigned int)((__GH3X2X_RAWDATA_BUFFER_SIZE__ * 100 / MAX(unZeroCopyUs, 1)) % 100),
+                (unsigned int)(__GH3X2X_RAWDATA_BUFFER_SIZE__ / MAX(unStackCopyUs, 1)),
+                (unsigned int)((__GH3X2X_RAWDATA_BUFFER_SIZE__ * 100 / MAX(unStackCopyUs, 1)) % 100));
+}
+
+#endif
+
+#if __SUPPORT_HARD_RESET_CONFIG__
+
+/// reset pin of gh3x2x, from devicetree
+static const struct gpio_dt_spec g_stGh3x2xResetGpio = GPIO_DT_SPEC_GET(GH3X2X_DT_NODE, reset_gpios);
+
+/**
+ * @fn     void hal_gh3x2x_reset_pin_init(void)
+ * 
+ * @brief  gh3x2x reset pin init
+ *
+ * @attention   reset pin is from reset-gpios of gh3x2x node in devicetree, level is not changed here
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void hal_gh3x2x_reset_pin_init(void)
+{
+    if (!gpio_is_ready_dt(&g_stGh3x2xResetGpio))
+    {
+        EXAMPLE_LOG("[%s]reset gpio of gh3x2x is not ready!\r\n", __FUNCTION__);
+        return;
+    }
+    gpio_pin_configure_dt(&g_stGh3x2xResetGpio, GPIO_OUTPUT);
+}
+
+/**
+ * @fn     void hal_gh3x2x_reset_pin_ctrl(GU8 pin_level)
+ * 
+ * @brief  hal reset pin ctrl for gh3x2x
+ *
+ * @attention   pin level set 1 [high level] or 0 [low level]
+ *
+ * @param[in]   pin_level     reset pin level
+ * @param[out]  None
+ *
+ * @return  None
+ */
+
+void hal_gh3x2x_reset_pin_ctrl(GU8 pin_level)
+{
+#if (__GH3X2X_REG_BURST_WRITE_EN__)
+  /* held regs are written before reset edge, they are dropped if it fails as reset clears them anyway */
+  GH3X2X_SPI_BUS_LOCK();
+  if (0 == Gh3x2xRegBurstFlush())
+  {
+      EXAMPLE_LOG("[RegBurst]flush error before reset, %u held regs dropped\r\n", (unsigned int)g_usGh3x2xRegBurstRegNum);
+      g_usGh3x2xRegBurstRegNum = 0;
+  }
+  GH3X2X_SPI_BUS_UNLOCK();
+#endif
+
+  /* pin_level is physical level, not active level of devicetree flags */
+  gpio_pin_set_raw(g_stGh3x2xResetGpio.port, g_stGh3x2xResetGpio.pin, pin_level ? 1 : 0);
+#if (__GH3X2X_REG_SHADOW_EN__)
+  if (0 == pin_level)
+  {
+      Gh3x2xRegShadowInvalidate();
+  }
+#endif
+#if (__GH3X2X_INT_FIFO_PREFETCH_EN__)
+  if (0 == pin_level)
+  {
+      Gh3x2xFifoPrefetchDrop();
+  }
+#endif
+#if (__GH3X2X_CASCADE_CONCURRENT_READ_EN__)
+  if (0 == pin_level)
+  {
+      Gh3x2xCascadeFifoDrop();
+  }
+#endif
+}
+
+#endif
+
+#define GH3X2X_INT_WORKQ_STACK_SIZE         (4096)
+#define GH3X2X_INT_WORKQ_PRIORITY           (5)
+
+/// drv lib and demo state are shared by int work queue and app threads, k_mutex is recursive
+static K_MUTEX_DEFINE(g_stGh3x2xDrvMutex);
+
+/**
+ * @fn     void hal_gh3x2x_drv_lock(void)
+ * 
+ * @brief  lock drv lib and demo state, recursive
+ *
+ * @attention   not in isr
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void hal_gh3x2x_drv_lock(void)
+{
+    k_mutex_lock(&g_stGh3x2xDrvMutex, K_FOREVER);
+}
+
+/**
+ * @fn     void hal_gh3x2x_drv_unlock(void)
+ * 
+ * @brief  unlock drv lib and demo state
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void hal_gh3x2x_drv_unlock(void)
+{
+    k_mutex_unlock(&g_stGh3x2xDrvMutex);
+}
+
+/// int process runs in its own work queue, not in isr and not in system work queue, also in polling mode
+static K_THREAD_STACK_DEFINE(g_stGh3x2xIntWorkQStack, GH3X2X_INT_WORKQ_STACK_SIZE);
+static struct k_work_q g_stGh3x2xIntWorkQ;
+static GU8 g_uchGh3x2xIntWorkQStarted = 0;
+
+#if (__NORMAL_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+
+/// int pin of gh3x2x, from devicetree
+static const struct gpio_dt_spec g_stGh3x2xIntGpio = GPIO_DT_SPEC_GET(GH3X2X_DT_NODE, int_gpios);
+static struct gpio_callback g_stGh3x2xIntGpioCb;
+static GU8 g_uchGh3x2xIntGpioInited = 0;
+
+static struct k_work g_stGh3x2xIntWork;
+#if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+/// chip reset recovery steps, in int work queue so never at the same time as int process
+static struct k_work_delayable g_stGh3x2xChipResetRecoveryWork;
+#endif
+#if (__GH3X2X_SOFT_EVENT_DISPATCH_EN__)
+/// soft events of drv lib are only read and cleared in this work, posting only submits it
+static struct k_work g_stGh3x2xSoftEventWork;
+#endif
+
+#if (__GH3X2X_INT_EDGE_CAPTURE_EN__)
+
+#define GH3X2X_INT_EDGE_TIMER_INDEX         (1)         /**< TIMER1, TIMER0 is used by radio */
+
+/// free running 1MHz timer, int edge is captured to CC0 by GPIOTE->PPI without cpu
+static const nrfx_timer_t g_stGh3x2xIntEdgeTimer = NRFX_TIMER_INSTANCE(GH3X2X_INT_EDGE_TIMER_INDEX);
+
+/**
+ * @fn     static void Gh3x2xIntEdgeTimerHandler(nrf_timer_event_t eEventType, void *pContext)
+ * 
+ * @brief  event handler of int edge timer, no timer irq is enabled
+ *
+ * @attention   None
+ *
+ * @param[in]   eEventType  timer event
+ * @param[in]   pContext    not used
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xIntEdgeTimerHandler(nrf_timer_event_t eEventType, void *pContext)
+{
+}
+
+/**
+ * @fn     static void Gh3x2xIntEdgeCaptureInit(void)
+ * 
+ * @brief  start 1MHz timer and connect int pin GPIOTE event to timer capture by PPI
+ *
+ * @attention   int pin must be configured as edge int before, so it owns a GPIOTE in channel
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xIntEdgeCaptureInit(void)
+{
+    nrfx_timer_config_t stTimerCfg = NRFX_TIMER_DEFAULT_CONFIG;
+    GU8 uchPpiChnl = 0;
+
+    stTimerCfg.frequency = NRF_TIMER_FREQ_1MHz;
+    stTimerCfg.bit_width = NRF_TIMER_BIT_WIDTH_32;
+    if ((nrfx_timer_init(&g_stGh3x2xIntEdgeTimer, &stTimerCfg, Gh3x2xIntEdgeTimerHandler) != NRFX_SUCCESS) ||
+        (nrfx_gppi_channel_alloc(&uchPpiChnl) != NRFX_SUCCESS))
+    {
+        EXAMPLE_LOG("[%s]int edge timer or ppi channel init fail!\r\n", __FUNCTION__);
+        return;
+    }
+    nrfx_gppi_channel_endpoints_setup(uchPpiChnl,
+        nrfx_gpiote_in_event_addr_get(NRF_DT_GPIOS_TO_PSEL(GH3X2X_DT_NODE, int_gpios)),
+        nrfx_timer_task_address_get(&g_stGh3x2xIntEdgeTimer, NRF_TIMER_TASK_CAPTURE0));
+    nrfx_gppi_channels_enable(BIT(uchPpiChnl));
+    nrfx_timer_enable(&g_stGh3x2xIntEdgeTimer);
+}
+
+#endif
+
+#if (__GH3X2X_INT_LATENCY_MEASURE_EN__)
+
+#define GH3X2X_INT_LATENCY_LOG_PERIOD       (128)       /**< log once every n int */
+
+/// latency statistics in us from int edge
+typedef struct
+{
+    GU32 unMin;
+    GU32 unMax;
+    GU32 unSum;
+    GU32 unCnt;
+} STGh3x2xIntLatencyStat;
+
+static STGh3x2xIntLatencyStat g_stGh3x2xIntIsrLatency = {0xFFFFFFFF, 0, 0, 0};
+static STGh3x2xIntLatencyStat g_stGh3x2xIntFifoLatency = {0xFFFFFFFF, 0, 0, 0};
+
+/// edge captured and fifo data of it not yet in ram
+static volatile GU8 g_uchGh3x2xIntLatencyArmed = 0;
+
+/// CC0 of armed edge, kept so that next edge captured to CC0 before fifo data is in ram does not replace it
+static volatile GU32 g_unGh3x2xIntLatencyEdgeUs = 0;
+
+/**
+ * @fn     static void Gh3x2xIntLatencyAdd(STGh3x2xIntLatencyStat *pstStat, GU32 unEdgeUs)
+ * 
+ * @brief  add time from captured int edge to now into statistics
+ *
+ * @attention   CC1 capture and read are done with irq locked, int isr also captures to CC1
+ *
+ * @param[in]   pstStat     statistics to update
+ * @param[in]   unEdgeUs    CC0 of int edge
+ * @param[out]  pstStat     statistics updated
+ *
+ * @return  None
+ */
+static void Gh3x2xIntLatencyAdd(STGh3x2xIntLatencyStat *pstStat, GU32 unEdgeUs)
+{
+    unsigned int unKey = irq_lock();
+    GU32 unNowUs = nrfx_timer_capture(&g_stGh3x2xIntEdgeTimer, NRF_TIMER_CC_CHANNEL1);
+    GU32 unLatencyUs;
+
+    irq_unlock(unKey);
+    unLatencyUs = unNowUs - unEdgeUs;
+    if (unLatencyUs < pstStat->unMin)
+    {
+        pstStat->unMin = unLatencyUs;
+    }
+    if (unLatencyUs > pstStat->unMax)
+    {
+        pstStat->unMax = unLatencyUs;
+    }
+    pstStat->unSum += unLatencyUs;
+    pstStat->unCnt++;
+}
+
+/**
+ * @fn     static void Gh3x2xIntLatencyLog(const GCHAR *pchTag, STGh3x2xIntLatencyStat *pstStat)
+ * 
+ * @brief  log min/avg/max and jitter(max - min) of latency, then restart statistics
+ *
+ * @attention   None
+ *
+ * @param[in]   pchTag      tag of latency
+ * @param[in]   pstStat     statistics to log
+ * @param[out]  pstStat     statistics cleared
+ *
+ * @return  None
+ */
+static void Gh3x2xIntLatencyLog(const GCHAR *pchTag, STGh3x2xIntLatencyStat *pstStat)
+{
+    EXAMPLE_LOG("[IntLatency]%s(%s): min %u us, avg %u us, max %u us, jitter %u us\r\n", pchTag,
+                (__GH3X2X_INT_FIFO_PREFETCH_EN__) ? "prefetch" : "isr+work",
+                (unsigned int)pstStat->unMin, (unsigned int)(pstStat->unSum / pstStat->unCnt),
+                (unsigned int)pstStat->unMax, (unsigned int)(pstStat->unMax - pstStat->unMin));
+    pstStat->unMin = 0xFFFFFFFF;
+    pstStat->unMax = 0;
+    pstStat->unSum = 0;
+    pstStat->unCnt = 0;
+}
+
+/**
+ * @fn     void Gh3x2xIntLatencyFifoDataReady(void)
+ * 
+ * @brief  mark that fifo data of last int edge is in ram, latency from int edge is counted once per int
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void Gh3x2xIntLatencyFifoDataReady(void)
+{
+    unsigned int unKey = irq_lock();
+    GU32 unEdgeUs = g_unGh3x2xIntLatencyEdgeUs;
+    GU8 uchArmed = g_uchGh3x2xIntLatencyArmed;
+
+    g_uchGh3x2xIntLatencyArmed = 0;
+    irq_unlock(unKey);
+    if (0 == uchArmed)
+    {
+        return;
+    }
+    Gh3x2xIntLatencyAdd(&g_stGh3x2xIntFifoLatency, unEdgeUs);
+    if (g_stGh3x2xIntFifoLatency.unCnt >= GH3X2X_INT_LATENCY_LOG_PERIOD)
+    {
+        Gh3x2xIntLatencyLog("int edge to isr", &g_stGh3x2xIntIsrLatency);
+        Gh3x2xIntLatencyLog("int edge to fifo data", &g_stGh3x2xIntFifoLatency);
+    }
+}
+
+#endif
+
+/**
+ * @fn     static void Gh3x2xIntWorkHandler(struct k_work *pstWork)
+ * 
+ * @brief  int process work, submitted by int handler call back
+ *
+ * @attention   None
+ *
+ * @param[in]   pstWork     int work
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xIntWorkHandler(struct k_work *pstWork)
+{
+    GH3X2X_DRV_LOCK();
+#if (__NORMAL_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    if (Gh3x2xGetInterruptMode() == __NORMAL_INT_PROCESS_MODE__)
+    {
+        GH3X2X_ClearChipSleepFlag(0);   //chip raised int so it is awake, drv lib state is set only under its lock
+    }
+#endif
+    Gh3x2xDemoInterruptProcess();
+    GH3X2X_DRV_UNLOCK();
+}
+
+#if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+/**
+ * @fn     static void Gh3x2xChipResetRecoveryWorkHandler(struct k_work *pstWork)
+ * 
+ * @brief  run recovery steps until one needs a delay, then reschedule instead of sleeping
+ *
+ * @attention   None
+ *
+ * @param[in]   pstWork     recovery work
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xChipResetRecoveryWorkHandler(struct k_work *pstWork)
+{
+    GS32 nDelayMs;
+
+    GH3X2X_DRV_LOCK();
+    do
+    {
+        nDelayMs = Gh3x2xDemoChipResetRecoveryStep();
+    } while (0 == nDelayMs);
+    GH3X2X_DRV_UNLOCK();
+    if (nDelayMs > 0)
+    {
+        k_work_schedule_for_queue(&g_stGh3x2xIntWorkQ, &g_stGh3x2xChipResetRecoveryWork, K_MSEC(nDelayMs));
+    }
+}
+
+/**
+ * @fn     void hal_gh3x2x_chip_reset_recovery_start(void)
+ * 
+ * @brief  submit chip reset recovery work, it calls Gh3x2xDemoChipResetRecoveryStep until recovery is done
+ *
+ * @attention   work runs in int work queue, so it never runs at the same time as int process
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void hal_gh3x2x_chip_reset_recovery_start(void)
+{
+    k_work_schedule_for_queue(&g_stGh3x2xIntWorkQ, &g_stGh3x2xChipResetRecoveryWork, K_NO_WAIT);
+}
+#endif
+
+#if (__GH3X2X_SOFT_EVENT_DISPATCH_EN__)
+/**
+ * @fn     static void Gh3x2xSoftEventWorkHandler(struct k_work *pstWork)
+ * 
+ * @brief  dispatch soft events of drv lib, it calls Gh3x2xDemoSoftEventDispatch
+ *
+ * @attention   None
+ *
+ * @param[in]   pstWork     dispatch work
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xSoftEventWorkHandler(struct k_work *pstWork)
+{
+    GH3X2X_DRV_LOCK();
+    Gh3x2xDemoSoftEventDispatch();
+    GH3X2X_DRV_UNLOCK();
+}
+
+/**
+ * @fn     void hal_gh3x2x_soft_event_post(void)
+ * 
+ * @brief  submit soft event dispatch work, posts before it runs are handled by one dispatch
+ *
+ * @attention   work runs in int work queue, so soft events are never taken in caller thread
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void hal_gh3x2x_soft_event_post(void)
+{
+    k_work_submit_to_queue(&g_stGh3x2xIntWorkQ, &g_stGh3x2xSoftEventWork);
+}
+#endif
+
+/**
+ * @fn     static void Gh3x2xIntGpioIsr(const struct device *pstPort, struct gpio_callback *pstCb, uint32_t unPins)
+ * 
+ * @brief  isr of gh3x2x int pin edge
+ *
+ * @attention   None
+ *
+ * @param[in]   pstPort     gpio port
+ * @param[in]   pstCb       gpio callback
+ * @param[in]   unPins      pins triggered
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xIntGpioIsr(const struct device *pstPort, struct gpio_callback *pstCb, uint32_t unPins)
+{
+#if (__GH3X2X_INT_LATENCY_MEASURE_EN__)
+    GU32 unEdgeUs = nrfx_timer_capture_get(&g_stGh3x2xIntEdgeTimer, NRF_TIMER_CC_CHANNEL0);
+
+    Gh3x2xIntLatencyAdd(&g_stGh3x2xIntIsrLatency, unEdgeUs);
+    if (0 == g_uchGh3x2xIntLatencyArmed)
+    {
+        g_unGh3x2xIntLatencyEdgeUs = unEdgeUs;  //fifo data latency counts from oldest edge not yet served
+        g_uchGh3x2xIntLatencyArmed = 1;
+    }
+#endif
+#if (__GH3X2X_INT_FIFO_PREFETCH_EN__)
+    k_sem_give(&g_stGh3x2xFifoPrefetchSem);
+#else
+    hal_gh3x2x_int_handler_call_back();
+#endif
+}
+
+#endif
+
+/**
+ * @fn     static void Gh3x2xIntWorkQStart(void)
+ * 
+ * @brief  start int work queue and init works running in it, only once
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xIntWorkQStart(void)
+{
+    if (g_uchGh3x2xIntWorkQStarted)
+    {
+        return;
+    }
+    k_work_queue_start(&g_stGh3x2xIntWorkQ, g_stGh3x2xIntWorkQStack, K_THREAD_STACK_SIZEOF(g_stGh3x2xIntWorkQStack),
+                       GH3X2X_INT_WORKQ_PRIORITY, NULL);
+#if (__GH3X2X_CHIP_RESET_ASYNC_RECOVERY_EN__)
+    k_work_init_delayable(&g_stGh3x2xChipResetRecoveryWork, Gh3x2xChipResetRecoveryWorkHandler);
+#endif
+#if (__GH3X2X_SOFT_EVENT_DISPATCH_EN__)
+    k_work_init(&g_stGh3x2xSoftEventWork, Gh3x2xSoftEventWorkHandler);
+#endif
+    g_uchGh3x2xIntWorkQStarted = 1;
+}
+
+#if (__POLLING_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+
+/// one-shot timer with absolute expiry, restarted by polling work, no periodic tick is kept alive in tickless idle
+static struct k_timer g_stGh3x2xPollingTimer;
+static struct k_work g_stGh3x2xPollingWork;
+static GU8 g_uchGh3x2xPollingInited = 0;
+
+/// guards run flag and timer restart against stop from other threads
+static struct k_spinlock g_stGh3x2xPollingLock;
+static GU8 g_uchGh3x2xPollingRun = 0;
+
+/// expiry of running poll and uptime of last poll, in ticks
+static int64_t g_llGh3x2xPollingDeadline = 0;
+static int64_t g_llGh3x2xPollingLast = 0;
+
+/**
+ * @fn     static void Gh3x2xPollingTimerExpiry(struct k_timer *pstTimer)
+ * 
+ * @brief  polling timer expiry, in isr, polling pass runs in int work queue
+ *
+ * @attention   None
+ *
+ * @param[in]   pstTimer    polling timer
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xPollingTimerExpiry(struct k_timer *pstTimer)
+{
+    k_work_submit_to_queue(&g_stGh3x2xIntWorkQ, &g_stGh3x2xPollingWork);
+}
+
+/**
+ * @fn     static void Gh3x2xPollingWorkHandler(struct k_work *pstWork)
+ * 
+ * @brief  run polling process and restart timer at last expiry + returned delay, so time spent in
+ *         int process does not add to polling period
+ *
+ * @attention   None
+ *
+ * @param[in]   pstWork     polling work
+ * @param[out]  None
+ *
+ * @return  None
+ */
+static void Gh3x2xPollingWorkHandler(struct k_work *pstWork)
+{
+    int64_t llNow = k_uptime_ticks();
+    GU32 unElapsedUs = (GU32)k_ticks_to_us_near64(llNow - g_llGh3x2xPollingLast);
+    GU32 unNextUs;
+    k_spinlock_key_t stKey;
+
+    g_llGh3x2xPollingLast = llNow;
+    unNextUs = Gh3x2xDemoPollingProcess(unElapsedUs);
+    stKey = k_spin_lock(&g_stGh3x2xPollingLock);
+    if (g_uchGh3x2xPollingRun && unNextUs)
+    {
+        g_llGh3x2xPollingDeadline += k_us_to_ticks_near64(unNextUs);
+        if (g_llGh3x2xPollingDeadline <= llNow)
+        {
+            g_llGh3x2xPollingDeadline = llNow + k_us_to_ticks_near64(unNextUs);    //late, skip missed polls
+        }
+        k_timer_start(&g_stGh3x2xPollingTimer, K_TIMEOUT_ABS_TICKS(g_llGh3x2xPollingDeadline), K_NO_WAIT);
+    }
+    k_spin_unlock(&g_stGh3x2xPollingLock, stKey);
+}
+
+/**
+ * @fn     void hal_gh3x2x_polling_timer_start(GU32 unPeriodUs)
+ * 
+ * @brief  (re)start polling timer, polling work calls Gh3x2xDemoPollingProcess at every expiry
+ *
+ * @attention   timer is one-shot with absolute expiry, restarted by polling work, so it needs no periodic tick
+ *
+ * @param[in]   unPeriodUs      delay of first expiry in us
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void hal_gh3x2x_polling_timer_start(GU32 unPeriodUs)
+{
+    k_spinlock_key_t stKey;
+
+    Gh3x2xIntWorkQStart();
+    if (0 == g_uchGh3x2xPollingInited)
+    {
+        k_timer_init(&g_stGh3x2xPollingTimer, Gh3x2xPollingTimerExpiry, NULL);
+        k_work_init(&g_stGh3x2xPollingWork, Gh3x2xPollingWorkHandler);
+        g_uchGh3x2xPollingInited = 1;
+    }
+    stKey = k_spin_lock(&g_stGh3x2xPollingLock);
+    g_uchGh3x2xPollingRun = 1;
+    g_llGh3x2xPollingLast = k_uptime_ticks();
+    g_llGh3x2xPollingDeadline = g_llGh3x2xPollingLast + k_us_to_ticks_near64(unPeriodUs);
+    k_timer_start(&g_stGh3x2xPollingTimer, K_TIMEOUT_ABS_TICKS(g_llGh3x2xPollingDeadline), K_NO_WAIT);
+    k_spin_unlock(&g_stGh3x2xPollingLock, stKey);
+}
+
+/**
+ * @fn     void hal_gh3x2x_polling_timer_stop(void)
+ * 
+ * @brief  stop polling timer
+ *
+ * @attention   None
+ *
+ * @param[in]   None
+ * @param[out]  None
+ *
+ * @return  None
+ */
+void hal_gh3x2x_polling_timer_stop(void)
+{
+    k_spinlock_key_t stKey;
+
+    if (0 == g_uchGh3x2xPollingInited)
     {
-        nrf_delay_ms(10);
-        time++;
-        if(time > 100)
-        {
-            return 0;
-        }
+        return;
     }
-    memcpy(pBuffer2, &buff[1], nBytesToRead);
-    return 1;
+    stKey = k_spin_lock(&g_stGh3x2xPollingLock);
+    g_uchGh3x2xPollingRun = 0;
+    k_timer_stop(&g_stGh3x2xPollingTimer);
+    k_spin_unlock(&g_stGh3x2xPollingLock, stKey);
 }
 
-#if ( __GH3X2X_INTERFACE__ == __GH3X2X_INTERFACE_I2C__ )
+#endif
 
-/* i2c interface */
 /**
- * @fn     void hal_gh3x2x_i2c_init(void)
+ * @fn     void hal_gh3x2x_int_init(void)
  * 
- * @brief  hal i2c init for gh3x2x
+ * @brief  gh3x2x int init
  *
- * @attention   None
+ * @attention   int pin and its active level are from int-gpios of gh3x2x node in devicetree
  *
  * @param[in]   None
  * @param[out]  None
  *
  * @return  None
  */
-void hal_gh3x2x_i2c_init(void)
+void hal_gh3x2x_int_init(void)
 {
-
-    /* code implement by user */
-    GOODIX_PLANFROM_I2C_INIT_ENTITY();
-
+#if (__NORMAL_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
+    if (g_uchGh3x2xIntGpioInited)
+    {
+        return;
+    }
+    if (!gpio_is_ready_dt(&g_stGh3x2xIntGpio))
+    {
+        EXAMPLE_LOG("[%s]int gpio of gh3x2x is not ready!\r\n", __FUNCTION__);
+        return;
+    }
+    Gh3x2xIntWorkQStart();
+    k_work_init(&g_stGh3x2xIntWork, Gh3x2xIntWorkHandler);
+    g_uchGh3x2xIntGpioInited = 1;
+
+    gpio_pin_configure_dt(&g_stGh3x2xIntGpio, GPIO_INPUT);
+    gpio_init_callback(&g_stGh3x2xIntGpioCb, Gh3x2xIntGpioIsr, BIT(g_stGh3x2xIntGpio.pin));
+    gpio_add_callback(g_stGh3x2xIntGpio.port, &g_stGh3x2xIntGpioCb);
+    gpio_pin_interrupt_configure_dt(&g_stGh3x2xIntGpio, GPIO_INT_EDGE_TO_ACTIVE);
+#if (__GH3X2X_INT_EDGE_CAPTURE_EN__)
+    Gh3x2xIntEdgeCaptureInit();
+#endif
+#endif
 }
 
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+#if (__GH3X2X_INT_EDGE_CAPTURE_EN__)
+/// int edge capture taken by last hal_gh3x2x_timestamp_int_edge_get
+static GU32 g_unGh3x2xTimeStampLastEdgeCnt = 0;
+#endif
+
 /**
- * @fn     uint8_t hal_gh3x2x_i2c_write(uint8_t device_id, const uint8_t write_buffer[], uint16_t length)
+ * @fn     GS64 hal_gh3x2x_timestamp_now_us(void)
  * 
- * @brief  hal i2c write for gh3x2x
+ * @brief  get time base of gh3x2x timestamps
  *
- * @attention   device_id is 8bits, if platform i2c use 7bits addr, should use (device_id >> 1)
+ * @attention   None
  *
- * @param[in]   device_id       device addr
- * @param[in]   write_buffer    write data buffer
- * @param[in]   length          write data len
+ * @param[in]   None
  * @param[out]  None
  *
- * @return  status
- * @retval  #1      return successfully
- * @retval  #0      return error
+ * @return  system uptime in us
  */
-GU8 hal_gh3x2x_i2c_write(GU8 device_id, const GU8 write_buffer[], GU16 length)
+GS64 hal_gh3x2x_timestamp_now_us(void)
 {
-    uint8_t ret = 1;
-
-    /* code implement by user */
-
-    GOODIX_PLANFROM_I2C_WRITE_ENTITY(device_id, write_buffer,length);
-    return ret;
+    return k_ticks_to_us_near64(k_uptime_ticks());
 }
 
 /**
- * @fn     uint8_t hal_gh3x2x_i2c_read(uint8_t device_id, const uint8_t write_buffer[], uint16_t write_length,
- *                            uint8_t read_buffer[], uint16_t read_length)
+ * @fn     GU8 hal_gh3x2x_timestamp_int_edge_get(GS64 *pllEdgeUs)
  * 
- * @brief  hal i2c read for gh3x2x
+ * @brief  get time of last int edge captured by GPIOTE->PPI->TIMER1, isr does nothing for it
  *
- * @attention   device_id is 8bits, if platform i2c use 7bits addr, should use (device_id >> 1)
+ * @attention   TIMER1 and uptime are read together, so capture is moved to uptime base with 1us step
  *
- * @param[in]   device_id       device addr
- * @param[in]   write_buffer    write data buffer
- * @param[in]   write_length    write data len
- * @param[in]   read_length     read data len
- * @param[out]  read_buffer     pointer to read buffer
+ * @param[in]   None
+ * @param[out]  pllEdgeUs      int edge time in uptime us
  *
- * @return  status
- * @retval  #1      return successfully
- * @retval  #0      return error
+ * @return  1: new edge since last call  0: no new edge or no edge capture(polling mode)
  */
-GU8 hal_gh3x2x_i2c_read(GU8 device_id, const GU8 write_buffer[], GU16 write_length, GU8 read_buffer[], GU16 read_length)
+GU8 hal_gh3x2x_timestamp_int_edge_get(GS64 *pllEdgeUs)
 {
-    uint8_t ret = 1;
-
-    /* code implement by user */
+#if (__GH3X2X_INT_EDGE_CAPTURE_EN__)
+    GU32 unEdgeCnt = nrfx_timer_capture_get(&g_stGh3x2xIntEdgeTimer, NRF_TIMER_CC_CHANNEL0);
+    GU32 unNowCnt;
+    GS64 llNowUs;
+    unsigned int unKey;
 
-    GOODIX_PLANFROM_I2C_READ_ENTITY(device_id, write_buffer, write_length, read_buffer, read_length);
-    return ret;
+    if (unEdgeCnt == g_unGh3x2xTimeStampLastEdgeCnt)
+    {
+        return 0;
+    }
+    g_unGh3x2xTimeStampLastEdgeCnt = unEdgeCnt;
+    unKey = irq_lock();     //int isr of latency measure also captures to CC1
+    unNowCnt = nrfx_timer_capture(&g_stGh3x2xIntEdgeTimer, NRF_TIMER_CC_CHANNEL1);
+    llNowUs = hal_gh3x2x_timestamp_now_us();
+    irq_unlock(unKey);
+    *pllEdgeUs = llNowUs - (GU32)(unNowCnt - unEdgeCnt);
+    return 1;
+#else
+    (void)pllEdgeUs;
+    return 0;
+#endif
 }
+#endif
 
-#else // __GH3X2X_INTERFACE__ == __GH3X2X_INTERFACE_SPI__
-
-/* spi interface */
+#if (__NORMAL_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
 /**
- * @fn     void hal_gh3x2x_spi_init(void)
+ * @fn     void hal_gh3x2x_int_handler_call_back(void)
  * 
- * @brief  hal spi init for gh3x2x
+ * @brief  call back of gh3x2x int handler
  *
  * @attention   None
  *
@@ -195,116 +2619,201 @@ GU8 hal_gh3x2x_i2c_read(GU8 device_id, const GU8 write_buffer[], GU16 write_leng
  *
  * @return  None
  */
-
-void hal_gh3x2x_spi_init(void)
+void hal_gh3x2x_int_handler_call_back(void)
 {
-    /* init spi and cs pin */
-    spi2_init();
+    if (Gh3x2xGetInterruptMode() == __NORMAL_INT_PROCESS_MODE__)
+    {
+        g_uchGh3x2xIntCallBackIsCalled = 1;     //chip sleep flag of drv lib is cleared by int work with drv lib lock
+#if (__GH3X2X_MP_MODE__)
+        GH3X2X_MP_SET_INT_FLAG();  //gh3x2x mp test must call it
+#endif
+        GOODIX_PLANFROM_INT_HANDLER_CALL_BACK_ENTITY();
+        k_work_submit_to_queue(&g_stGh3x2xIntWorkQ, &g_stGh3x2xIntWork);
+    }
 }
+#endif
+
+#if (__GH3X2X_INT_PIPELINE_EN__)
+
+#define GH3X2X_PIPELINE_THREAD_STACK_SIZE   (4096)      /**< algorithm runs in this thread */
+#define GH3X2X_PIPELINE_THREAD_PRIORITY     (7)         /**< lower than int process, chip is serviced before algorithm */
+
+/// given when a fifo block is queued
+static K_SEM_DEFINE(g_stGh3x2xPipelineSem, 0, 1);
 
 /**
- * @fn     GU8 hal_gh3x2x_spi_write(GU8 write_buffer[], GU16 length)
+ * @fn     void hal_gh3x2x_pipeline_notify(void)
  * 
- * @brief  hal spi write for gh3x2x
+ * @brief  wake processing thread, it calls Gh3x2xDemoPipelineProcess
  *
- * @attention   if __GH3X2X_SPI_TYPE__ == __GH3X2X_SPI_TYPE_SOFTWARE_CS__  , user need generate timming: write_buf[0](W) + write_buf[1](W) + ...
- * @attention   if __GH3X2X_SPI_TYPE__ == __GH3X2X_SPI_TYPE_HARDWARE_CS__  , user need generate timming: CS LOW  + write_buf[0](W) + write_buf[1](W) + ... + CS HIGH
+ * @attention   called by int process after a fifo block is queued
  *
- * @param[in]   write_buffer    write data buffer
- * @param[in]   length          write data len
+ * @param[in]   None
  * @param[out]  None
  *
- * @return  status
- * @retval  #1      return successfully
- * @retval  #0      return error
+ * @return  None
  */
-GU8 hal_gh3x2x_spi_write(GU8 write_buffer[], GU16 length)
+void hal_gh3x2x_pipeline_notify(void)
 {
-    GU8 ret = 1;
-
-    ret = Sensor2_IO_Write(&spi2, write_buffer, length);
-
-    return ret;
+    k_sem_give(&g_stGh3x2xPipelineSem);
 }
 
-
-#if (__GH3X2X_SPI_TYPE__ == __GH3X2X_SPI_TYPE_SOFTWARE_CS__) 
 /**
- * @fn     GU8 hal_gh3x2x_spi_read(GU8 read_buffer[], GU16 length)
+ * @fn     static void Gh3x2xPipelineThread(void *p1, void *p2, void *p3)
  * 
- * @brief  hal spi read for gh3x2x
+ * @brief  processing thread, drains fifo block ring every time it is waked
  *
- * @attention   user need generate timming: read_buf[0](R) + write_buf[1](R) + ... 
+ * @attention   None
  *
- * @param[in]   read_length     read data len
- * @param[out]  read_buffer     pointer to read buffer
+ * @param[in]   p1  not used
+ * @param[in]   p2  not used
+ * @param[in]   p3  not used
+ * @param[out]  None
  *
- * @return  status
- * @retval  #1      return successfully
- * @retval  #0      return error
+ * @return  None
  */
-GU8 hal_gh3x2x_spi_read(GU8 read_buffer[], GU16 length)
+static void Gh3x2xPipelineThread(void *p1, void *p2, void *p3)
 {
-    GU8 ret = 1;
+    while (1)
+    {
+        k_sem_take(&g_stGh3x2xPipelineSem, K_FOREVER);
+        Gh3x2xDemoPipelineProcess();
+    }
+}
 
-    GOODIX_PLANFROM_SPI_READ_ENTITY();
+K_THREAD_DEFINE(g_stGh3x2xPipelineThread, GH3X2X_PIPELINE_THREAD_STACK_SIZE, Gh3x2xPipelineThread,
+                NULL, NULL, NULL, GH3X2X_PIPELINE_THREAD_PRIORITY, 0, 0);
+
+#endif
+
+#if (__GS_ZEPHYR_SENSOR_EN__)
+/* sensor api of this zephyr version has no fifo/rtio read, so samples are fetched one by one into a ring, and the
+   ring is handed to gh3x2x in one burst per fifo read; a driver fifo burst read needs newer zephyr */
+#if !DT_NODE_HAS_STATUS(DT_ALIAS(gh3x2x_accel), okay)
+#error __GS_ZEPHYR_SENSOR_EN__ needs devicetree alias gh3x2x-accel of an okay accelerometer, see nrf52840dk_nrf52840.overlay
+#endif
+
+#define GH3X2X_GS_RING_SIZE                 (__GSENSOR_DATA_BUFFER_SIZE__)
+#define GH3X2X_GS_COUNTS_PER_G              (512 << (__GS_SENSITIVITY_CONFIG__))   /**< raw counts before Gh3x2xGsensorIngest */
+
+static const struct device *const g_pstGh3x2xGsDev = DEVICE_DT_GET(DT_ALIAS(gh3x2x_accel));
+
+/// data ready trigger, driver may keep the pointer
+static const struct sensor_trigger g_stGh3x2xGsTrigger =
+{
+    .type = SENSOR_TRIG_DATA_READY,
+    .chan = SENSOR_CHAN_ACCEL_XYZ,
+};
+
+/// samples cached between two fifo reads of gh3x2x, oldest one is dropped when full
+static STGsensorRawdata g_stGh3x2xGsRing[GH3X2X_GS_RING_SIZE];
+static GU16 g_usGh3x2xGsRingHead = 0;
+static GU16 g_usGh3x2xGsRingNum = 0;
+
+/// samples being normalized by Gh3x2xGsRingDrain out of irq lock, their slots are not written
+static GU16 g_usGh3x2xGsRingDrainNum = 0;
+
+/// 1: sampled by k_timer, driver has no data ready trigger
+static GU8 g_uchGh3x2xGsPolled = 0;
+
+/// 1: between Gh3x2xGsStart and Gh3x2xGsStop
+static GU8 g_uchGh3x2xGsRunning = 0;
+
+/// sample rate, frame rate of opened functions, set by hal_gsensor_rate_update
+static GU16 g_usGh3x2xGsRateHz = __GS_SAMPLE_RATE_HZ__;
 
-    return ret;
-}
-#elif (__GH3X2X_SPI_TYPE__ == __GH3X2X_SPI_TYPE_HARDWARE_CS__)
 /**
- * @fn     GU8 hal_gh3x2x_spi_write_F1_and_read(GU8 read_buffer[], GU16 length)
+ * @fn     static GS16 Gh3x2xGsValueToCounts(const struct sensor_value *pstValue)
  * 
- * @brief  hal spi write F1 and read for gh3x2x
+ * @brief  convert m/s^2 of sensor api to raw counts of __GS_SENSITIVITY_CONFIG__
  *
- * @attention    user need generate timming: CS LOW + F1(W) + read_buf[0](R) + read_buf[1](R) + ... + CS HIGH
+ * @attention   None
  *
- * @param[in]   write_buf     write data
- * @param[in]   length     write data len
+ * @param[in]   pstValue    acceleration
+ * @param[out]  None
  *
- * @return  status
- * @retval  #1      return successfully
- * @retval  #0      return error
+ * @return  raw counts, saturated
  */
-GU8 hal_gh3x2x_spi_write_F1_and_read(GU8 read_buffer[], GU16 length)
+static GS16 Gh3x2xGsValueToCounts(const struct sensor_value *pstValue)
 {
-    GU8 ret = 1;
-    GU8 reg = 0xF1;
-    ret = Sensor2_IO_Read(&spi2, reg, read_buffer, length);
-    
-    return ret;
+    GS64 llCounts = ((GS64)pstValue->val1 * 1000000 + pstValue->val2) * GH3X2X_GS_COUNTS_PER_G / SENSOR_G;
+
+    if (llCounts > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (llCounts < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (GS16)llCounts;
 }
-#endif
 
 /**
- * @fn     void hal_gh3x2x_spi_cs_ctrl(GU8 cs_pin_level)
+ * @fn     static void Gh3x2xGsSampleRead(void)
  * 
- * @brief  hal spi cs pin ctrl for gh3x2x
+ * @brief  fetch one sample of accelerometer into ring
  *
- * @attention   pin level set 1 [high level] or 0 [low level]
+ * @attention   thread context, bus of accelerometer is accessed
  *
- * @param[in]   cs_pin_level     spi cs pin level
+ * @param[in]   None
  * @param[out]  None
  *
  * @return  None
  */
-#if (__GH3X2X_SPI_TYPE__ == __GH3X2X_SPI_TYPE_SOFTWARE_CS__) 
-void hal_gh3x2x_spi_cs_ctrl(GU8 cs_pin_level)
+static void Gh3x2xGsSampleRead(void)
 {
+    struct sensor_value stAccel[3];
+    STGsensorRawdata stSample = {0};    //gyro is not read from sensor api
+    unsigned int unIrqKey;
 
-    GOODIX_PLANFROM_SPI_CS_CTRL_ENTITY();
+    if ((sensor_sample_fetch_chan(g_pstGh3x2xGsDev, SENSOR_CHAN_ACCEL_XYZ) < 0)
+        || (sensor_channel_get(g_pstGh3x2xGsDev, SENSOR_CHAN_ACCEL_XYZ, stAccel) < 0))
+    {
+        return;
+    }
+    stSample.sXAxisVal = Gh3x2xGsValueToCounts(&stAccel[0]);
+    stSample.sYAxisVal = Gh3x2xGsValueToCounts(&stAccel[1]);
+    stSample.sZAxisVal = Gh3x2xGsValueToCounts(&stAccel[2]);
+
+    unIrqKey = irq_lock();      //ring is drained by int process
+    if ((g_usGh3x2xGsRingNum + g_usGh3x2xGsRingDrainNum) < GH3X2X_GS_RING_SIZE)
+    {
+        g_stGh3x2xGsRing[g_usGh3x2xGsRingHead] = stSample;
+        g_usGh3x2xGsRingHead = (g_usGh3x2xGsRingHead + 1) % GH3X2X_GS_RING_SIZE;
+        g_usGh3x2xGsRingNum++;
+    }
+    else if (0 == g_usGh3x2xGsRingDrainNum)
+    {
+        g_stGh3x2xGsRing[g_usGh3x2xGsRingHead] = stSample;     //overwrite oldest one
+        g_usGh3x2xGsRingHead = (g_usGh3x2xGsRingHead + 1) % GH3X2X_GS_RING_SIZE;
+    }
+    irq_unlock(unIrqKey);       //else oldest ones are being drained, new one is dropped
+}
 
+static void Gh3x2xGsDataReadyHandler(const struct device *pstDev, const struct sensor_trigger *pstTrigger)
+{
+    Gh3x2xGsSampleRead();
 }
-#endif
 
-#endif
+static void Gh3x2xGsWorkHandler(struct k_work *pstWork)
+{
+    Gh3x2xGsSampleRead();
+}
 
-#if __SUPPORT_HARD_RESET_CONFIG__
+static K_WORK_DEFINE(g_stGh3x2xGsWork, Gh3x2xGsWorkHandler);
+
+static void Gh3x2xGsTimerHandler(struct k_timer *pstTimer)
+{
+    k_work_submit(&g_stGh3x2xGsWork);
+}
+
+static K_TIMER_DEFINE(g_stGh3x2xGsTimer, Gh3x2xGsTimerHandler, NULL);
 
 /**
- * @fn     void hal_gh3x2x_int_init(void)
+ * @fn     static void Gh3x2xGsRateApply(void)
  * 
- * @brief  gh3x2x int init
+ * @brief  set odr of accelerometer to g_usGh3x2xGsRateHz, restart k_timer when polled
  *
  * @attention   None
  *
@@ -313,39 +2822,50 @@ void hal_gh3x2x_spi_cs_ctrl(GU8 cs_pin_level)
  *
  * @return  None
  */
-
-
-
-void hal_gh3x2x_reset_pin_init(void)
+static void Gh3x2xGsRateApply(void)
 {
-    nrf_gpio_cfg_output(3);
+    struct sensor_value stOdr = {.val1 = g_usGh3x2xGsRateHz, .val2 = 0};
+
+    if (sensor_attr_set(g_pstGh3x2xGsDev, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_SAMPLING_FREQUENCY, &stOdr) < 0)
+    {
+        EXAMPLE_LOG("gsensor %s odr %d Hz is not set, driver default is used\r\n", g_pstGh3x2xGsDev->name, g_usGh3x2xGsRateHz);
+    }
+    if (g_uchGh3x2xGsPolled)
+    {
+        k_timer_start(&g_stGh3x2xGsTimer, K_USEC(1000000 / g_usGh3x2xGsRateHz), K_USEC(1000000 / g_usGh3x2xGsRateHz));
+    }
 }
 
 /**
- * @fn     void hal_gh3x2x_reset_pin_ctrl(GU8 pin_level)
+ * @fn     void hal_gsensor_rate_update(GU16 usRateHz)
  * 
- * @brief  hal reset pin ctrl for gh3x2x
+ * @brief  set sample rate of gsensor, applied at once when it is sampling
  *
- * @attention   pin level set 1 [high level] or 0 [low level]
+ * @attention   This function will be called before start and after opened functions change.
  *
- * @param[in]   pin_level     reset pin level
+ * @param[in]   usRateHz        sample rate(Hz)
  * @param[out]  None
  *
  * @return  None
  */
-
-void hal_gh3x2x_reset_pin_ctrl(GU8 pin_level)
+void hal_gsensor_rate_update(GU16 usRateHz)
 {
-
-  nrf_gpio_pin_write(3, pin_level ? 1 : 0);
+    if ((0 == usRateHz) || (usRateHz == g_usGh3x2xGsRateHz))
+    {
+        return;
+    }
+    g_usGh3x2xGsRateHz = usRateHz;
+    if (g_uchGh3x2xGsRunning)
+    {
+        Gh3x2xGsRateApply();
+        EXAMPLE_LOG("gsensor %s rate %d Hz\r\n", g_pstGh3x2xGsDev->name, g_usGh3x2xGsRateHz);
+    }
 }
 
-#endif
-
 /**
- * @fn     void hal_gh3x2x_int_init(void)
+ * @fn     static void Gh3x2xGsStart(void)
  * 
- * @brief  gh3x2x int init
+ * @brief  start accelerometer at g_usGh3x2xGsRateHz, by data ready trigger or k_timer
  *
  * @attention   None
  *
@@ -354,16 +2874,30 @@ void hal_gh3x2x_reset_pin_ctrl(GU8 pin_level)
  *
  * @return  None
  */
-void hal_gh3x2x_int_init(void)
+static void Gh3x2xGsStart(void)
 {
-    
+    unsigned int unIrqKey;
+
+    if (!device_is_ready(g_pstGh3x2xGsDev))
+    {
+        EXAMPLE_LOG("gsensor %s is not ready\r\n", g_pstGh3x2xGsDev->name);
+        return;
+    }
+    unIrqKey = irq_lock();
+    g_usGh3x2xGsRingHead = 0;
+    g_usGh3x2xGsRingNum = 0;
+    irq_unlock(unIrqKey);
+    g_uchGh3x2xGsPolled = (sensor_trigger_set(g_pstGh3x2xGsDev, &g_stGh3x2xGsTrigger, Gh3x2xGsDataReadyHandler) < 0) ? 1 : 0;
+    Gh3x2xGsRateApply();
+    g_uchGh3x2xGsRunning = 1;
+    EXAMPLE_LOG("gsensor %s start, %d Hz, %s\r\n", g_pstGh3x2xGsDev->name, g_usGh3x2xGsRateHz,
+                g_uchGh3x2xGsPolled ? "polled" : "data ready trigger");
 }
 
-#if (__NORMAL_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__ || __MIX_INT_PROCESS_MODE__ == __INTERRUPT_PROCESS_MODE__)
 /**
- * @fn     void hal_gh3x2x_int_handler_call_back(void)
+ * @fn     static void Gh3x2xGsStop(void)
  * 
- * @brief  call back of gh3x2x int handler
+ * @brief  stop sampling of accelerometer
  *
  * @attention   None
  *
@@ -372,18 +2906,60 @@ void hal_gh3x2x_int_init(void)
  *
  * @return  None
  */
-void hal_gh3x2x_int_handler_call_back(void)
+static void Gh3x2xGsStop(void)
 {
-    if (Gh3x2xGetInterruptMode() == __NORMAL_INT_PROCESS_MODE__)
+    if (!g_uchGh3x2xGsRunning)
     {
-        GH3X2X_ClearChipSleepFlag(0);
-        g_uchGh3x2xIntCallBackIsCalled = 1;
-#if (__GH3X2X_MP_MODE__)
-        GH3X2X_MP_SET_INT_FLAG();  //gh3x2x mp test must call it
-#endif
-        GOODIX_PLANFROM_INT_HANDLER_CALL_BACK_ENTITY();
+        return;
+    }
+    g_uchGh3x2xGsRunning = 0;
+    if (g_uchGh3x2xGsPolled)
+    {
+        k_timer_stop(&g_stGh3x2xGsTimer);
+        k_work_cancel(&g_stGh3x2xGsWork);
+    }
+    else
+    {
+        sensor_trigger_set(g_pstGh3x2xGsDev, &g_stGh3x2xGsTrigger, NULL);
     }
 }
+
+/**
+ * @fn     static void Gh3x2xGsRingDrain(STGsensorRawdata gsensor_buffer[], GU16 *gsensor_buffer_index)
+ * 
+ * @brief  move cached samples to gsensor buffer of gh3x2x in one burst, oldest first
+ *
+ * @attention   samples are normalized by Gh3x2xGsensorIngest in the copy(__GS_INGEST_BY_HAL__), only
+ *              ring indexes are taken under irq lock, drained slots are reserved until the copy is done
+ *
+ * @param[out]  gsensor_buffer          gsensor buffer, __GSENSOR_DATA_BUFFER_SIZE__ samples
+ * @param[out]  gsensor_buffer_index    sample num
+ *
+ * @return  None
+ */
+static void Gh3x2xGsRingDrain(STGsensorRawdata gsensor_buffer[], GU16 *gsensor_buffer_index)
+{
+    unsigned int unIrqKey;
+    GU16 usNum;
+    GU16 usTail;
+    GU16 usFirstNum;
+
+    unIrqKey = irq_lock();
+    usNum = g_usGh3x2xGsRingNum;
+    usTail = (g_usGh3x2xGsRingHead + GH3X2X_GS_RING_SIZE - usNum) % GH3X2X_GS_RING_SIZE;
+    g_usGh3x2xGsRingNum = 0;
+    g_usGh3x2xGsRingDrainNum = usNum;
+    irq_unlock(unIrqKey);
+
+    usFirstNum = MIN(usNum, GH3X2X_GS_RING_SIZE - usTail);
+    Gh3x2xGsensorIngest(gsensor_buffer, &g_stGh3x2xGsRing[usTail], usFirstNum);
+    Gh3x2xGsensorIngest(gsensor_buffer + usFirstNum, &g_stGh3x2xGsRing[0], usNum - usFirstNum);
+
+    unIrqKey = irq_lock();
+    g_usGh3x2xGsRingDrainNum = 0;
+    irq_unlock(unIrqKey);
+    *gsensor_buffer_index = usNum;
+}
 #endif
 
 /**
@@ -403,7 +2979,11 @@ void hal_gsensor_start_cache_data(void)
 #if (__DRIVER_LIB_MODE__ == __DRV_LIB_WITH_ALGO__)
     GH3X2X_TimestampSyncAccInit();
 #endif
+#if (__GS_ZEPHYR_SENSOR_EN__)
+    Gh3x2xGsStart();
+#else
     GOODIX_PLANFROM_INT_GS_START_CACHE_ENTITY();
+#endif
 }
 
 /**
@@ -420,8 +3000,11 @@ void hal_gsensor_start_cache_data(void)
  */
 void hal_gsensor_stop_cache_data(void)
 {
-        
+#if (__GS_ZEPHYR_SENSOR_EN__)
+    Gh3x2xGsStop();
+#else
     GOODIX_PLANFROM_INT_GS_STOP_CACHE_ENTITY();
+#endif
 }
 
 void hal_cap_start_cache_data(void)
@@ -473,16 +3056,33 @@ void hal_gsensor_drv_get_fifo_data(STGsensorRawdata gsensor_buffer[], GU16 *gsen
 /* Be care for copying data to gsensor_buffer, length of gsensor_buffer is __GSENSOR_DATA_BUFFER_SIZE__ *****/
 /**************************** WARNNING END*****************************************************/
 
+#if (__GS_ZEPHYR_SENSOR_EN__)
+    Gh3x2xGsRingDrain(gsensor_buffer, gsensor_buffer_index);
+#endif
 #if (__DRIVER_LIB_MODE__ == __DRV_LIB_WITH_ALGO__)
+#if (__GH3X2X_HW_TIMESTAMP_EN__)
+    GS64 llNowUs = hal_gh3x2x_timestamp_now_us();
+#if (__GS_ZEPHYR_SENSOR_EN__)
+    GU16 usGsRateHz = g_usGh3x2xGsRateHz;
+#else
+    GU16 usGsRateHz = __GS_SAMPLE_RATE_HZ__;
+#endif
+#endif
     for (int i = 0; i < *gsensor_buffer_index; i++)
     {
         GU32 unTimeStamp = 0;
         /* user set time stamp code here */
+    #if (__GH3X2X_HW_TIMESTAMP_EN__)
+        /* newest sample is fetched now, older ones are one gsensor period apart; sync buffer is in ms */
+        unTimeStamp = (GU32)((llNowUs - (GS64)(*gsensor_buffer_index - 1 - i) * 1000000 / usGsRateHz) / 1000);
+    #endif
         GH3X2X_TimestampSyncFillAccSyncBuffer(unTimeStamp, gsensor_buffer[i].sXAxisVal, gsensor_buffer[i].sYAxisVal, gsensor_buffer[i].sZAxisVal);
     }
 #endif
 
+#if !(__GS_ZEPHYR_SENSOR_EN__)
     GOODIX_PLANFROM_INT_GET_GS_DATA_ENTITY();
+#endif
 
 
 /**************************** WARNNING: DO NOT REMOVE OR MODIFY THIS CODE   ---START***************************************************/
@@ -560,7 +3160,10 @@ void GH3X2X_RegisterPrintf(int (**pPrintfUser)(const char *format, ...))
 
 void Gh3x2x_BspDelayUs(GU16 usUsec)
 {
-    nrf_delay_us(usUsec);
+#if (__GH3X2X_REG_BURST_WRITE_EN__)
+    Gh3x2xRegBurstFlush();
+#endif
+    k_busy_wait(usUsec);
 }
 
 void GH3X2X_AdtFuncStartWithGsDetectHook(void)
@@ -582,7 +3185,10 @@ void GH3X2X_AdtFuncStartWithGsDetectHook(void)
  */
 void Gh3x2x_BspDelayMs(GU16 usMsec)
 {
-    nrf_delay_ms(usMsec);
+#if (__GH3X2X_REG_BURST_WRITE_EN__)
+    Gh3x2xRegBurstFlush();
+#endif
+    k_msleep(usMsec);
 }
 
 #if (__FUNC_TYPE_SOFT_ADT_ENABLE__)
@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+"""
+@file    gh3x2x_route_table_gen.py
+
+@brief   generate channel routing tables of gh3x2x reg config arrays
+
+Parses gh3x2x_reg_listN arrays of gh3x2x_demo_reg_array.c and decodes the
+function channel virtual regs(0x2000 + function offset * 0x22: channel num,
+then channel map bytes, low byte first) into const STGh3x2xRouteTable entries:
+fifo word tag(slot/adc) to function routing and channel num of every function,
+the only fields the demo layer reads.
+
+Preprocessor conditions inside an array(#if/#ifdef/#ifndef/#else/#endif) are
+kept: every combination is decoded and emitted under the same condition when
+tables differ.
+
+usage: gh3x2x_route_table_gen.py <gh3x2x_demo_reg_array.c> <gh3x2x_demo_route_table.h>
+"""
+
+import itertools
+import os
+import re
+import sys
+
+FUNC_NAME = [
+    "ADT", "HR", "HRV", "HSM", "FPBP", "PWA", "SPO2", "ECG", "PWTT", "SOFT_ADT_GREEN",
+    "BT", "RESP", "AF", "TEST1", "TEST2", "SOFT_ADT_IR", "RS0", "RS1", "RS2", "LEAD_DET",
+]
+FUNC_CHNL_VREG_BASE = 0x2000
+FUNC_CHNL_VREG_STEP = 0x22
+CHNL_NUM_MAX = 32
+TAG_NUM = 32
+MAX_COND_NUM = 4
+
+RE_LIST = re.compile(r"const\s+STGh3x2xReg\s+gh3x2x_reg_list(\d+)\s*\[\s*\]\s*=\s*\{")
+RE_ENTRY = re.compile(r"\{\s*(0[xX][0-9a-fA-F]+|\d+)\s*,\s*(0[xX][0-9a-fA-F]+|\d+)\s*\}")
+
+
+class GenError(Exception):
+    pass
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", " ", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def list_bodies(text):
+    """yield (list index, body text) of every gh3x2x_reg_listN"""
+    for match in RE_LIST.finditer(text):
+        depth = 1
+        pos = match.end()
+        while depth:
+            if pos >= len(text):
+                raise GenError("gh3x2x_reg_list%s is not closed" % match.group(1))
+            if text[pos] == "{":
+                depth += 1
+            elif text[pos] == "}":
+                depth -= 1
+            pos += 1
+        yield int(match.group(1)), text[match.end():pos - 1]
+
+
+def parse_entries(body):
+    """return conditions and [(guard, addr, value)], guard is ((cond index, polarity), ...)"""
+    conds = []
+    stack = []
+    entries = []
+    for line in body.splitlines():
+        line = line.strip()
+        if line.startswith("#"):
+            directive = line[1:].strip()
+            word = directive.split(None, 1)[0] if directive else ""
+            arg = directive[len(word):].strip()
+            if word in ("if", "ifdef", "ifndef"):
+                cond = {"if": arg, "ifdef": "defined(%s)" % arg, "ifndef": "!defined(%s)" % arg}[word]
+                if cond not in conds:
+                    conds.append(cond)
+                stack.append((conds.index(cond), True))
+            elif word == "else":
+                if not stack:
+                    raise GenError("#else without #if")
+                stack[-1] = (stack[-1][0], not stack[-1][1])
+            elif word == "endif":
+                if not stack:
+                    raise GenError("#endif without #if")
+                stack.pop()
+            else:
+                raise GenError("unsupported directive in reg list: #%s" % directive)
+            continue
+        for match in RE_ENTRY.finditer(line):
+            entries.append((tuple(stack), int(match.group(1), 0), int(match.group(2), 0)))
+    if stack:
+        raise GenError("#if without #endif")
+    if len(conds) > MAX_COND_NUM:
+        raise GenError("too many conditions in reg list")
+    return conds, entries
+
+
+def decode(entries, assign):
+    """decode function channels of entries enabled by condition assignment"""
+    regs = {}
+    for guard, addr, value in entries:
+        if all(assign[index] == polarity for index, polarity in guard) and addr < 0xFFFF:
+            regs[addr] = value
+    chnl_map = []
+    for func in range(len(FUNC_NAME)):
+        base = FUNC_CHNL_VREG_BASE + func * FUNC_CHNL_VREG_STEP
+        chnl_num = min(regs.get(base, 0) & 0xFF, CHNL_NUM_MAX)
+        chnl_map.append(tuple((regs.get(base + 2 + (chnl // 2) * 2, 0) >> (8 * (chnl % 2))) & 0xFF
+                              for chnl in range(chnl_num)))
+    return tuple(chnl_map)
+
+
+def emit_table(out, list_index, chnl_map, indent):
+    tag_route = [0] * TAG_NUM
+    for func, chnls in enumerate(chnl_map):
+        for chnl in chnls:
+            tag_route[chnl >> 3] |= 1 << func
+    pad = " " * indent
+    out.append(pad + "/* gh3x2x_reg_list%d */" % list_index)
+    out.append(pad + "{")
+    out.append(pad + "    .unTagRoute =")
+    out.append(pad + "    {")
+    for row in range(0, TAG_NUM, 8):
+        out.append(pad + "        " + " ".join("0x%05X," % route for route in tag_route[row:row + 8]))
+    out.append(pad + "    },")
+    out.append(pad + "    .uchChnlNum =")
+    out.append(pad + "    {")
+    for func, chnls in enumerate(chnl_map):
+        if chnls:
+            out.append(pad + "        [GH3X2X_FUNC_OFFSET_%s] = %d," % (FUNC_NAME[func], len(chnls)))
+    out.append(pad + "    },")
+    out.append(pad + "},")
+
+
+def generate(src_path):
+    with open(src_path, "r", encoding="utf-8", errors="replace") as src:
+        text = strip_comments(src.read())
+    lists = sorted(list_bodies(text))
+    if [index for index, _ in lists] != list(range(len(lists))):
+        raise GenError("gh3x2x_reg_list indexes are not contiguous from 0")
+
+    tables = []
+    for list_index, body in lists:
+        conds, entries = parse_entries(body)
+        assigns = list(itertools.product((True, False), repeat=len(conds)))
+        variants = [decode(entries, assign) for assign in assigns]
+        if len(set(variants)) == 1:
+            assigns = [()]
+            variants = variants[:1]
+        table = []
+        for assign, chnl_map in zip(assigns, variants):
+            cond = " && ".join(("(%s)" if polarity else "!(%s)") % conds[index] for index, polarity in enumerate(assign))
+            table.append((cond, chnl_map))
+        tables.append((list_index, table))
+
+    out = [
+        "/**",
+        " * @file    gh3x2x_demo_route_table.h",
+        " *",
+        " * @brief   channel routing tables of gh3x2x_reg_listN, generated from gh3x2x_demo_reg_array.c",
+        " *          by gh3x2x_route_table_gen.py at build time, do not edit",
+        " */",
+        "#ifndef _GH3X2X_DEMO_ROUTE_TABLE_H_",
+        "#define _GH3X2X_DEMO_ROUTE_TABLE_H_",
+        "",
+        "#define GH3X2X_ROUTE_TABLE_NUM      (%d)" % len(tables),
+        "",
+    ]
+    out += ["static const STGh3x2xRouteTable g_stGh3x2xRouteTable[GH3X2X_ROUTE_TABLE_NUM] =", "{"]
+    for list_index, table in tables:
+        for variant_index, (cond, chnl_map) in enumerate(table):
+            if cond:
+                out.append("#if %s" % cond if variant_index == 0 else "#elif %s" % cond)
+            emit_table(out, list_index, chnl_map, 4)
+        if len(table) > 1:
+            out.append("#endif")
+    out += ["};", "", "#endif", ""]
+    return "\n".join(out)
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write(__doc__)
+        return 2
+    try:
+        header = generate(argv[1])
+    except (GenError, OSError) as err:
+        sys.stderr.write("gh3x2x_route_table_gen: %s: %s\n" % (argv[1], err))
+        return 1
+    out_dir = os.path.dirname(argv[2])
+    if out_dir:
+        os.makedirs(out_dir, exist_ok=True)
+    with open(argv[2], "w", encoding="utf-8") as out:
+        out.write(header)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,122 @@
+/*
+ * @FilePath: \central_and_peripheral_hr\app\user_driver\inc\gh3x2x_sensor.h
+ * @Description: zephyr sensor driver of goodix,gh3x2x, wraps gh3x2x demo layer and drv lib
+ */
+#ifndef GH3X2X_SENSOR_H__
+#define GH3X2X_SENSOR_H__
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+
+#include "gh3x2x_drv.h"
+#include "gh3x2x_demo.h"
+
+/**
+ * @brief Private channel of gh3x2x
+ */
+enum gh3x2xSensorChannel_t {
+    /** frames delivered by stream or batch stream callback in last fifo watermark block */
+    SENSOR_CHAN_GH3X2X_BLOCK_FRAME_NUM = SENSOR_CHAN_PRIV_START,
+};
+
+/**
+ * @brief Private attribute of gh3x2x
+ */
+enum gh3x2xSensorAttribute_t {
+    /** fifo watermark in words, overrides reg config from next config load, 0: use reg config */
+    SENSOR_ATTR_GH3X2X_FIFO_WATERMARK = SENSOR_ATTR_PRIV_START,
+    /** ble connection interval in ms for adaptive fifo watermark, 0: not connected */
+    SENSOR_ATTR_GH3X2X_CONN_INTERVAL,
+};
+
+/**
+ * @brief Stream callback, called once per decoded function frame
+ *
+ * The frame points into drv lib buffers, it is only valid inside the callback.
+ * Called in gh3x2x int process thread, SENSOR_TRIG_DATA_READY handler runs after
+ * the last frame of every fifo watermark block.
+ * With __GH3X2X_HW_TIMESTAMP_EN__, Gh3x2xDemoFrameTimeStampGet(frame->unFunctionID)
+ * gives the frame time in us.
+ */
+typedef void (*gh3x2xStreamCallback_t)(const struct device *dev, const STGh3x2xFrameInfo *const frame, void *userData);
+
+/**
+ * @brief   Set stream callback of decoded frames
+ *
+ * @param   dev         gh3x2x device
+ * @param   callback    callback of every frame, NULL to stop stream
+ * @param   userData    passed to callback
+ *
+ * With adaptive fifo watermark, a set callback means raw data is consumed live.
+ *
+ * @retval  0 on success
+ * @retval  -ENOTSUP with __GH3X2X_FRAME_BATCH_EN__, frames are only delivered by batch stream
+ */
+int gh3x2xStreamSet(const struct device *dev, gh3x2xStreamCallback_t callback, void *userData);
+
+/**
+ * @brief Batch stream callback, called with frames of one function in channel-major arrays
+ *
+ * The batch points into demo layer buffers, it is only valid inside the callback.
+ * Called in gh3x2x int process thread when function of frames changes, when
+ * __GH3X2X_FRAME_BATCH_MAX_NUM__ frames are collected and before SENSOR_TRIG_DATA_READY
+ * handler of every fifo watermark block.
+ */
+typedef void (*gh3x2xBatchStreamCallback_t)(const struct device *dev, const STGh3x2xFrameBatch *const batch,
+                                            void *userData);
+
+/**
+ * @brief   Set batch stream callback of decoded frames
+ *
+ * @param   dev         gh3x2x device
+ * @param   callback    callback of every batch, NULL to stop batch stream
+ * @param   userData    passed to callback
+ *
+ * Replaces the per frame stream callback, the drv lib algorithm still runs per frame.
+ *
+ * @retval  0 on success
+ * @retval  -ENOTSUP without __GH3X2X_FRAME_BATCH_EN__
+ */
+int gh3x2xBatchStreamSet(const struct device *dev, gh3x2xBatchStreamCallback_t callback, void *userData);
+
+/**
+ * @brief   Start sampling of functions
+ *
+ * @param   dev         gh3x2x device
+ * @param   funcMode    GH3X2X_FUNCTION_XXX bits
+ *
+ * @retval  0 on success
+ */
+int gh3x2xFunctionStart(const struct device *dev, uint32_t funcMode);
+
+/**
+ * @brief   Stop sampling of functions
+ *
+ * @param   dev         gh3x2x device
+ * @param   funcMode    GH3X2X_FUNCTION_XXX bits
+ *
+ * @retval  0 on success
+ */
+int gh3x2xFunctionStop(const struct device *dev, uint32_t funcMode);
+
+/**
+ * @brief   Deliver one decoded frame to stream callback, called by gh3x2x frame hook
+ *
+ * @param   frame       decoded frame
+ */
+void gh3x2xSensorFramePush(const STGh3x2xFrameInfo *const frame);
+
+/**
+ * @brief   Deliver one batch of frames to batch stream callback, called by gh3x2x batch hook
+ *
+ * @param   batch       frames of one function
+ */
+void gh3x2xSensorBatchPush(const STGh3x2xFrameBatch *const batch);
+
+/**
+ * @brief   Fifo watermark block is decoded, fire SENSOR_TRIG_DATA_READY, called by gh3x2x hook
+ */
+void gh3x2xSensorBlockDone(void);
+
+#endif
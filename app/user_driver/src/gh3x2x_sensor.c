@@ -0,0 +1,223 @@
+/*
+ * @FilePath: \central_and_peripheral_hr\app\user_driver\src\gh3x2x_sensor.c
+ * @Description: zephyr sensor driver of goodix,gh3x2x, wraps gh3x2x demo layer and drv lib
+ */
+#define DT_DRV_COMPAT goodix_gh3x2x
+
+#include "gh3x2x_sensor.h"
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/logging/log.h>
+
+#include "gh3x2x_demo.h"
+#include "gh3x2x_demo_config.h"
+
+LOG_MODULE_REGISTER(gh3x2x_sensor, LOG_LEVEL_INF);
+
+/* drv lib and demo layer keep one chip in global state, cascade master/slaver is still one node */
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT) <= 1, "only one goodix,gh3x2x node is supported");
+
+#define GH3X2X_FIFO_WORD_BYTES  4
+
+typedef struct gh3x2xSensorConfig_t {
+    uint16_t fifoWatermark;
+} gh3x2xSensorConfig_t;
+
+typedef struct gh3x2xSensorData_t {
+    sensor_trigger_handler_t drdyHandler;
+    const struct sensor_trigger *drdyTrigger;
+    gh3x2xStreamCallback_t streamCallback;
+    void *streamUserData;
+    gh3x2xBatchStreamCallback_t batchCallback;
+    void *batchUserData;
+    uint32_t blockFrameCnt;
+    uint32_t lastBlockFrameNum;
+} gh3x2xSensorData_t;
+
+/* frames come from drv lib hooks without device pointer */
+static const struct device *gh3x2xDev;
+
+static int gh3x2xSampleFetch(const struct device *dev, enum sensor_channel chan)
+{
+    /* fifo is read and decoded at watermark int, frames are pushed by stream callback */
+    return 0;
+}
+
+static int gh3x2xChannelGet(const struct device *dev, enum sensor_channel chan, struct sensor_value *val)
+{
+    gh3x2xSensorData_t *data = dev->data;
+
+    if ((enum gh3x2xSensorChannel_t)chan != SENSOR_CHAN_GH3X2X_BLOCK_FRAME_NUM) {
+        return -ENOTSUP;
+    }
+    val->val1 = data->lastBlockFrameNum;
+    val->val2 = 0;
+    return 0;
+}
+
+static int gh3x2xAttrSet(const struct device *dev, enum sensor_channel chan, enum sensor_attribute attr,
+                         const struct sensor_value *val)
+{
+#if (__GH3X2X_FIFO_WM_ADAPTIVE_EN__)
+    if ((enum gh3x2xSensorAttribute_t)attr == SENSOR_ATTR_GH3X2X_CONN_INTERVAL) {
+        if ((val->val1 < 0) || (val->val1 > UINT16_MAX)) {
+            return -EINVAL;
+        }
+        Gh3x2xDemoFifoWmConnIntervalSet((GU16)val->val1);
+        return 0;
+    }
+#endif
+    if ((enum gh3x2xSensorAttribute_t)attr != SENSOR_ATTR_GH3X2X_FIFO_WATERMARK) {
+        return -ENOTSUP;
+    }
+    if ((val->val1 < 0) || ((val->val1 * GH3X2X_FIFO_WORD_BYTES) > __GH3X2X_RAWDATA_BUFFER_SIZE__)) {
+        return -EINVAL;
+    }
+    Gh3x2xDemoFifoWatermarkOverride((GU16)val->val1);
+    return 0;
+}
+
+static int gh3x2xTriggerSet(const struct device *dev, const struct sensor_trigger *trig,
+                            sensor_trigger_handler_t handler)
+{
+    gh3x2xSensorData_t *data = dev->data;
+
+    if (trig->type != SENSOR_TRIG_DATA_READY) {
+        return -ENOTSUP;
+    }
+    data->drdyTrigger = trig;
+    data->drdyHandler = handler;
+    return 0;
+}
+
+int gh3x2xStreamSet(const struct device *dev, gh3x2xStreamCallback_t callback, void *userData)
+{
+#if (__GH3X2X_FRAME_BATCH_EN__)
+    /* frames are only delivered in batches */
+    return -ENOTSUP;
+#else
+    gh3x2xSensorData_t *data = dev->data;
+
+    data->streamUserData = userData;
+    data->streamCallback = callback;
+#if (__GH3X2X_FIFO_WM_ADAPTIVE_EN__)
+    Gh3x2xDemoFifoWmRawStreamSet(((callback != NULL) || __SUPPORT_PROTOCOL_ANALYZE__) ? 1 : 0);
+#endif
+    return 0;
+#endif
+}
+
+int gh3x2xBatchStreamSet(const struct device *dev, gh3x2xBatchStreamCallback_t callback, void *userData)
+{
+#if (__GH3X2X_FRAME_BATCH_EN__)
+    gh3x2xSensorData_t *data = dev->data;
+
+    data->batchUserData = userData;
+    data->batchCallback = callback;
+#if (__GH3X2X_FIFO_WM_ADAPTIVE_EN__)
+    Gh3x2xDemoFifoWmRawStreamSet(((callback != NULL) || __SUPPORT_PROTOCOL_ANALYZE__) ? 1 : 0);
+#endif
+    return 0;
+#else
+    return -ENOTSUP;
+#endif
+}
+
+int gh3x2xFunctionStart(const struct device *dev, uint32_t funcMode)
+{
+    if (!device_is_ready(dev)) {
+        return -ENODEV;
+    }
+    Gh3x2xDemoStartSampling(funcMode);
+    return 0;
+}
+
+int gh3x2xFunctionStop(const struct device *dev, uint32_t funcMode)
+{
+    if (!device_is_ready(dev)) {
+        return -ENODEV;
+    }
+    Gh3x2xDemoStopSampling(funcMode);
+    return 0;
+}
+
+#if (0 == __GH3X2X_FRAME_BATCH_EN__)
+void gh3x2xSensorFramePush(const STGh3x2xFrameInfo *const frame)
+{
+    gh3x2xSensorData_t *data;
+
+    if (gh3x2xDev == NULL) {
+        return;
+    }
+    data = gh3x2xDev->data;
+    data->blockFrameCnt++;
+    if (data->streamCallback != NULL) {
+        data->streamCallback(gh3x2xDev, frame, data->streamUserData);
+    }
+}
+#endif
+
+void gh3x2xSensorBatchPush(const STGh3x2xFrameBatch *const batch)
+{
+    gh3x2xSensorData_t *data;
+
+    if (gh3x2xDev == NULL) {
+        return;
+    }
+    data = gh3x2xDev->data;
+    data->blockFrameCnt += batch->usFrameNum;
+    if (data->batchCallback != NULL) {
+        data->batchCallback(gh3x2xDev, batch, data->batchUserData);
+    }
+}
+
+void gh3x2xSensorBlockDone(void)
+{
+    gh3x2xSensorData_t *data;
+
+    if (gh3x2xDev == NULL) {
+        return;
+    }
+    data = gh3x2xDev->data;
+    data->lastBlockFrameNum = data->blockFrameCnt;
+    data->blockFrameCnt = 0;
+    if ((data->drdyHandler != NULL) && (data->lastBlockFrameNum != 0)) {
+        data->drdyHandler(gh3x2xDev, data->drdyTrigger);
+    }
+}
+
+static int gh3x2xInit(const struct device *dev)
+{
+    const gh3x2xSensorConfig_t *config = dev->config;
+
+    /* bus, int and reset pins are taken from this node by gh3x2x hal */
+    Gh3x2xDemoFifoWatermarkOverride(config->fifoWatermark);
+    if (Gh3x2xDemoInit() != GH3X2X_RET_OK) {
+        LOG_ERR("gh3x2x init fail");
+        return -EIO;
+    }
+    gh3x2xDev = dev;
+    return 0;
+}
+
+static const struct sensor_driver_api gh3x2xApi = {
+    .attr_set = gh3x2xAttrSet,
+    .trigger_set = gh3x2xTriggerSet,
+    .sample_fetch = gh3x2xSampleFetch,
+    .channel_get = gh3x2xChannelGet,
+};
+
+#define GH3X2X_DEFINE(inst)                                                                         \
+    BUILD_ASSERT((DT_INST_PROP(inst, fifo_watermark) * GH3X2X_FIFO_WORD_BYTES) <=                   \
+                 __GH3X2X_RAWDATA_BUFFER_SIZE__, "fifo-watermark exceeds rawdata buffer");          \
+    static gh3x2xSensorData_t gh3x2xData##inst;                                                     \
+    static const gh3x2xSensorConfig_t gh3x2xConfig##inst = {                                        \
+        .fifoWatermark = DT_INST_PROP(inst, fifo_watermark),                                        \
+    };                                                                                              \
+    DEVICE_DT_INST_DEFINE(inst, gh3x2xInit, NULL, &gh3x2xData##inst, &gh3x2xConfig##inst,           \
+                          POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY, &gh3x2xApi);
+
+DT_INST_FOREACH_STATUS_OKAY(GH3X2X_DEFINE)